@@ -0,0 +1,1072 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#define ZMATH_IMPLEMENTATION
+#define ZMATH_TRIG_LUT
+#include "zmath.h"
+
+// Micro-benchmarks and accuracy sweeps against the host libm.
+//
+//   ./runner [-o out.csv] [--stride N] [--full] [--filter name]
+//
+// For every function it reports:
+//   lat ns   Latency: each call's input depends on the previous result.
+//   tput ns  Throughput: independent calls over a 4096-element buffer.
+//            Scalar calls are direct and may inline, as they do inside the
+//            ZMATH_IMPLEMENTATION file or with ZMATH_STATIC.
+//   ULP      Max and mean error against double-precision libm, sweeping
+//            every N-th float bit pattern inside the function's domain
+//            (--stride, default 4096; --full tests every float).
+// The libm rows time the float functions (sinf, ...) and sweep them the same
+// way, as a baseline. With -o, the same records are written as CSV.
+
+#define BENCH_N      4096
+#define BENCH_CALLS  (1 << 22)
+#define BENCH_TRIALS 5
+#define BENCH_PAIRS  (1 << 20)
+
+// Results.
+
+typedef struct
+{
+    double lat_ns;
+    double tput_ns;
+    double max_ulp;
+    double mean_ulp;
+    double max_abs;
+    double samples;
+    double bad;
+    bool   has_ulp;
+} bench_result;
+
+static FILE* bench_csv = NULL;
+static const char* bench_filter = NULL;
+static uint32_t bench_stride = 4096;
+static volatile float bench_sink;
+
+static void bench_report(const char* name, const char* impl, bench_result r)
+{
+    if (r.has_ulp)
+    {
+        printf("%-16s %-6s %8.2f %8.2f %12.1f %10.3f %10.3g\n",
+               name, impl, r.lat_ns, r.tput_ns, r.max_ulp, r.mean_ulp, r.max_abs);
+    }
+    else
+    {
+        printf("%-16s %-6s %8.2f %8.2f %12s %10s %10s\n",
+               name, impl, r.lat_ns, r.tput_ns, "-", "-", "-");
+    }
+    if (bench_csv)
+    {
+        fprintf(bench_csv, "%s,%s,%.3f,%.3f,", name, impl, r.lat_ns, r.tput_ns);
+        if (r.has_ulp)
+        {
+            fprintf(bench_csv, "%.2f,%.4f,%.6g,%.0f,%.0f\n",
+                    r.max_ulp, r.mean_ulp, r.max_abs, r.samples, r.bad);
+        }
+        else
+        {
+            fprintf(bench_csv, ",,,,\n");
+        }
+    }
+}
+
+static bool bench_selected(const char* name)
+{
+    return bench_filter == NULL || strstr(name, bench_filter) != NULL;
+}
+
+// Timing.
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint32_t bench_rng_state = 0x9E3779B9u;
+
+static float bench_rand01(void)
+{
+    // xorshift32; only needs to be cheap and repeatable.
+    uint32_t x = bench_rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bench_rng_state = x;
+    return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Uniform in [lo, hi], or log-uniform for wide positive ranges so that
+// log/sqrt see every exponent.
+static float bench_sample(float lo, float hi)
+{
+    float t = bench_rand01();
+    if (lo > 0.0f && hi / lo > 1e3f)
+    {
+        return (float)exp(log(lo) + (log(hi) - log(lo)) * t);
+    }
+    return lo + (hi - lo) * t;
+}
+
+static void bench_fill(float* buf, float lo, float hi)
+{
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        buf[i] = bench_sample(lo, hi);
+    }
+}
+
+// The `y * 0.0f` term keeps each input dependent on the previous result
+// without changing its value; it cannot be folded without -ffast-math.
+#define BENCH_TIME_UNARY(result, fn, in)                                    \
+    do                                                                      \
+    {                                                                       \
+        double best_lat = 1e30, best_tput = 1e30;                           \
+        static float out_[BENCH_N];                                         \
+        for (int t_ = 0; t_ < BENCH_TRIALS; t_++)                           \
+        {                                                                   \
+            float y_ = 0.0f;                                                \
+            double t0_ = bench_now();                                       \
+            for (int i_ = 0; i_ < BENCH_CALLS; i_++)                        \
+            {                                                               \
+                y_ = fn((in)[i_ & (BENCH_N - 1)] + y_ * 0.0f);              \
+            }                                                               \
+            double t1_ = bench_now();                                       \
+            bench_sink = y_;                                                \
+            for (int r_ = 0; r_ < BENCH_CALLS / BENCH_N; r_++)              \
+            {                                                               \
+                for (int i_ = 0; i_ < BENCH_N; i_++)                        \
+                {                                                           \
+                    out_[i_] = fn((in)[i_]);                                \
+                }                                                           \
+                bench_sink = out_[r_ & (BENCH_N - 1)];                      \
+            }                                                               \
+            double t2_ = bench_now();                                       \
+            if (t1_ - t0_ < best_lat) best_lat = t1_ - t0_;                 \
+            if (t2_ - t1_ < best_tput) best_tput = t2_ - t1_;               \
+        }                                                                   \
+        (result).lat_ns = best_lat / BENCH_CALLS;                           \
+        (result).tput_ns = best_tput / BENCH_CALLS;                         \
+    } while (0)
+
+#define BENCH_TIME_BINARY(result, fn, a, b)                                 \
+    do                                                                      \
+    {                                                                       \
+        double best_lat = 1e30, best_tput = 1e30;                           \
+        static float out_[BENCH_N];                                         \
+        for (int t_ = 0; t_ < BENCH_TRIALS; t_++)                           \
+        {                                                                   \
+            float y_ = 0.0f;                                                \
+            double t0_ = bench_now();                                       \
+            for (int i_ = 0; i_ < BENCH_CALLS; i_++)                        \
+            {                                                               \
+                int k_ = i_ & (BENCH_N - 1);                                \
+                y_ = fn((a)[k_] + y_ * 0.0f, (b)[k_]);                      \
+            }                                                               \
+            double t1_ = bench_now();                                       \
+            bench_sink = y_;                                                \
+            for (int r_ = 0; r_ < BENCH_CALLS / BENCH_N; r_++)              \
+            {                                                               \
+                for (int i_ = 0; i_ < BENCH_N; i_++)                        \
+                {                                                           \
+                    out_[i_] = fn((a)[i_], (b)[i_]);                        \
+                }                                                           \
+                bench_sink = out_[r_ & (BENCH_N - 1)];                      \
+            }                                                               \
+            double t2_ = bench_now();                                       \
+            if (t1_ - t0_ < best_lat) best_lat = t1_ - t0_;                 \
+            if (t2_ - t1_ < best_tput) best_tput = t2_ - t1_;               \
+        }                                                                   \
+        (result).lat_ns = best_lat / BENCH_CALLS;                           \
+        (result).tput_ns = best_tput / BENCH_CALLS;                         \
+    } while (0)
+
+// Accuracy.
+
+typedef float  (*bench_f1)(float);
+typedef double (*bench_d1)(double);
+typedef float  (*bench_f2)(float, float);
+typedef double (*bench_d2)(double, double);
+
+// Spacing of floats at the magnitude of `ref`, so errors are in float ULPs.
+static double bench_ulp(double ref)
+{
+    int e;
+    double m = frexp(fabs((double)(float)ref), &e);
+    if (m == 0.0 || e < -125)
+    {
+        return ldexp(1.0, -149);
+    }
+    return ldexp(1.0, e - 24);
+}
+
+static void bench_accumulate(bench_result* r, double got, double ref)
+{
+    if (isnan(ref) || isinf(ref))
+    {
+        return;
+    }
+    if (isnan(got) || isinf(got))
+    {
+        r->bad += 1.0;
+        return;
+    }
+    double abs_err = fabs(got - ref);
+    double ulp = abs_err / bench_ulp(ref);
+    if (ulp > r->max_ulp)
+    {
+        r->max_ulp = ulp;
+    }
+    if (abs_err > r->max_abs)
+    {
+        r->max_abs = abs_err;
+    }
+    r->mean_ulp += ulp;
+    r->samples += 1.0;
+}
+
+static void bench_finish(bench_result* r)
+{
+    if (r->samples > 0.0)
+    {
+        r->mean_ulp /= r->samples;
+    }
+    r->has_ulp = true;
+}
+
+// Every `bench_stride`-th float bit pattern that lands in [lo, hi].
+static void bench_sweep_unary(bench_result* r, bench_f1 f, bench_d1 ref, float lo, float hi)
+{
+    for (uint64_t u = 0; u < 0x100000000ull; u += bench_stride)
+    {
+        uint32_t bits = (uint32_t)u;
+        float x;
+        memcpy(&x, &bits, sizeof(x));
+        if (!(x >= lo && x <= hi))
+        {
+            continue;
+        }
+        bench_accumulate(r, (double)f(x), ref((double)x));
+    }
+    bench_finish(r);
+}
+
+static void bench_sweep_binary(bench_result* r, bench_f2 f, bench_d2 ref,
+                               float lo_a, float hi_a, float lo_b, float hi_b)
+{
+    bench_rng_state = 0x12345678u;
+    for (int i = 0; i < BENCH_PAIRS; i++)
+    {
+        float a = bench_sample(lo_a, hi_a);
+        float b = bench_sample(lo_b, hi_b);
+        bench_accumulate(r, (double)f(a, b), ref((double)a, (double)b));
+    }
+    bench_finish(r);
+}
+
+// Function lists.
+// X(name, zmath function, double reference, libm float function, lo, hi)
+
+static double bench_rsqrt(double x) { return 1.0 / sqrt(x); }
+static float  bench_rsqrtf(float x) { return 1.0f / sqrtf(x); }
+static double bench_rcp(double x)   { return 1.0 / x; }
+static float  bench_rcpf(float x)   { return 1.0f / x; }
+static double bench_sin_turns(double t) { return sin(6.28318530717958647692 * t); }
+static float  bench_sin_turnsf(float t) { return sinf(6.28318530717958647692f * t); }
+
+#define BENCH_UNARY_LIST(X)                                                 \
+    X(sin,             zmath_sin,             sin,         sinf,   -1e4f, 1e4f)   \
+    X(sin_fast,        zmath_sin_fast,        sin,         sinf,   -1e4f, 1e4f)   \
+    X(sin_precise,     zmath_sin_precise,     sin,         sinf,   -1e4f, 1e4f)   \
+    X(sin_turns,       zmath_sin_turns,       bench_sin_turns, bench_sin_turnsf, -1e4f, 1e4f) \
+    X(cos,             zmath_cos,             cos,         cosf,   -1e4f, 1e4f)   \
+    X(cos_fast,        zmath_cos_fast,        cos,         cosf,   -1e4f, 1e4f)   \
+    X(cos_precise,     zmath_cos_precise,     cos,         cosf,   -1e4f, 1e4f)   \
+    X(sin_lut,         zmath_sin_lut,         sin,         sinf,   -1e4f, 1e4f)   \
+    X(cos_lut,         zmath_cos_lut,         cos,         cosf,   -1e4f, 1e4f)   \
+    X(tan,             zmath_tan,             tan,         tanf,   -1.5f, 1.5f)   \
+    X(asin,            zmath_asin,            asin,        asinf,  -1.0f, 1.0f)   \
+    X(acos,            zmath_acos,            acos,        acosf,  -1.0f, 1.0f)   \
+    X(atan,            zmath_atan,            atan,        atanf,  -1e30f, 1e30f) \
+    X(exp,             zmath_exp,             exp,         expf,   -87.0f, 88.0f) \
+    X(exp_fast,        zmath_exp_fast,        exp,         expf,   -87.0f, 88.0f) \
+    X(exp_precise,     zmath_exp_precise,     exp,         expf,   -87.0f, 88.0f) \
+    X(exp2,            zmath_exp2,            exp2,        exp2f,  -126.0f, 127.0f) \
+    X(log,             zmath_log,             log,         logf,   1.2e-38f, 3.4e38f) \
+    X(log_fast,        zmath_log_fast,        log,         logf,   1.2e-38f, 3.4e38f) \
+    X(log_precise,     zmath_log_precise,     log,         logf,   1.2e-38f, 3.4e38f) \
+    X(log2,            zmath_log2,            log2,        log2f,  1.2e-38f, 3.4e38f) \
+    X(sqrt,            zmath_sqrt,            sqrt,        sqrtf,  1.2e-38f, 3.4e38f) \
+    X(invsqrt,         zmath_invsqrt,         bench_rsqrt, bench_rsqrtf, 1.2e-38f, 3.4e38f) \
+    X(invsqrt_fast,    zmath_invsqrt_fast,    bench_rsqrt, bench_rsqrtf, 1.2e-38f, 3.4e38f) \
+    X(invsqrt_precise, zmath_invsqrt_precise, bench_rsqrt, bench_rsqrtf, 1.2e-38f, 3.4e38f) \
+    X(rcp,             zmath_rcp,             bench_rcp,   bench_rcpf,   1.2e-38f, 8.5e37f) \
+    X(floor,           zmath_floor,           floor,       floorf, -3.4e38f, 3.4e38f) \
+    X(ceil,            zmath_ceil,            ceil,        ceilf,  -3.4e38f, 3.4e38f) \
+    X(round,           zmath_round,           round,       roundf, -3.4e38f, 3.4e38f)
+
+// X(name, zmath function, double reference, libm float function, a range, b range)
+#define BENCH_BINARY_LIST(X)                                                    \
+    X(atan2, zmath_atan2, atan2, atan2f, -100.0f, 100.0f, -100.0f, 100.0f)      \
+    X(pow,   zmath_pow,   pow,   powf,   1e-3f, 1e3f, -8.0f, 8.0f)              \
+    X(hypot, zmath_hypot, hypot, hypotf, -1e18f, 1e18f, -1e18f, 1e18f)
+
+// X(name, array kernel, lo, hi)
+#define BENCH_ARRAY_LIST(X)                                 \
+    X(sin_array,     zmath_sin_array,     -1e4f, 1e4f)      \
+    X(cos_array,     zmath_cos_array,     -1e4f, 1e4f)      \
+    X(atan_array,    zmath_atan_array,    -1e3f, 1e3f)      \
+    X(exp_array,     zmath_exp_array,     -87.0f, 88.0f)    \
+    X(exp2_array,    zmath_exp2_array,    -126.0f, 127.0f)  \
+    X(log_array,     zmath_log_array,     1e-30f, 1e30f)    \
+    X(sqrt_array,    zmath_sqrt_array,    1e-30f, 1e30f)    \
+    X(invsqrt_array, zmath_invsqrt_array, 1e-30f, 1e30f)    \
+    X(poly12_array,  bench_poly_array12,  -2.0f, 2.0f)     \
+    X(sincos_array,  bench_sincos_array,  -4.0f, 4.0f)     \
+    X(sincos_table,  bench_sincos_table,  -4.0f, 4.0f)     \
+    X(remap_array,   bench_remap_array,   -1e3f, 1e3f)     \
+    X(remap_loop,    bench_remap_loop,    -1e3f, 1e3f)
+
+// sincos writes through pointers, so it is timed through these wrappers
+// against the libm sinf + cosf pair. Its values equal sin and cos.
+static inline float bench_zmath_sincos(float x)
+{
+    float s, c;
+    zmath_sincos(x, &s, &c);
+    return s + c;
+}
+
+static inline float bench_libm_sincos(float x)
+{
+    return sinf(x) + cosf(x);
+}
+
+// A 12-term polynomial (the exp Taylor series) through poly's Estrin blocks
+// and through the Horner chain. Estrin shows in the latency column.
+static const float bench_poly_c[12] = {
+    1.0f, 1.0f, 1.0f / 2.0f, 1.0f / 6.0f, 1.0f / 24.0f, 1.0f / 120.0f, 1.0f / 720.0f, 1.0f / 5040.0f,
+    1.0f / 40320.0f, 1.0f / 362880.0f, 1.0f / 3628800.0f, 1.0f / 39916800.0f
+};
+
+static inline float bench_poly_estrin(float x)
+{
+    return zmath_poly(bench_poly_c, 12, x);
+}
+
+static inline float bench_poly_horner(float x)
+{
+    return zmath_poly_horner(bench_poly_c, 12, x);
+}
+
+static void bench_poly_array12(const float* in, float* out, size_t n)
+{
+    zmath_poly_array(bench_poly_c, 12, in, out, n);
+}
+
+// A table of angles one step apart, from sincos on every angle and from the
+// rotation recurrence. The cosines go to a scratch buffer.
+static float bench_cos_out[BENCH_N];
+
+static void bench_sincos_array(const float* in, float* out, size_t n)
+{
+    zmath_sincos_array(in, out, bench_cos_out, n);
+}
+
+static void bench_sincos_table(const float* in, float* out, size_t n)
+{
+    zmath_sincos_table(in[0], 1e-3f, out, bench_cos_out, n);
+}
+
+// One remap over a whole buffer, batched and as a loop of scalar calls.
+static void bench_remap_array(const float* in, float* out, size_t n)
+{
+    zmath_remap_array(-1e3f, 1e3f, 0.0f, 255.0f, in, out, n);
+}
+
+static void bench_remap_loop(const float* in, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = zmath_remap(-1e3f, 1e3f, 0.0f, 255.0f, in[i]);
+    }
+}
+
+// Runners.
+
+static float bench_in[BENCH_N];
+static float bench_in2[BENCH_N];
+static float bench_out[BENCH_N];
+
+#define BENCH_RUN_UNARY(name, zfn, dref, lfn, lo, hi)                       \
+    if (bench_selected(#name))                                              \
+    {                                                                       \
+        bench_result z = {0}, l = {0};                                      \
+        bench_fill(bench_in, lo, hi);                                       \
+        BENCH_TIME_UNARY(z, zfn, bench_in);                                 \
+        BENCH_TIME_UNARY(l, lfn, bench_in);                                 \
+        bench_sweep_unary(&z, zfn, dref, lo, hi);                           \
+        bench_sweep_unary(&l, lfn, dref, lo, hi);                           \
+        bench_report(#name, "zmath", z);                                    \
+        bench_report(#name, "libm", l);                                     \
+    }
+
+#define BENCH_RUN_BINARY(name, zfn, dref, lfn, lo_a, hi_a, lo_b, hi_b)      \
+    if (bench_selected(#name))                                              \
+    {                                                                       \
+        bench_result z = {0}, l = {0};                                      \
+        bench_fill(bench_in, lo_a, hi_a);                                   \
+        bench_fill(bench_in2, lo_b, hi_b);                                  \
+        BENCH_TIME_BINARY(z, zfn, bench_in, bench_in2);                     \
+        BENCH_TIME_BINARY(l, lfn, bench_in, bench_in2);                     \
+        bench_sweep_binary(&z, zfn, dref, lo_a, hi_a, lo_b, hi_b);          \
+        bench_sweep_binary(&l, lfn, dref, lo_a, hi_a, lo_b, hi_b);          \
+        bench_report(#name, "zmath", z);                                    \
+        bench_report(#name, "libm", l);                                     \
+    }
+
+// Array kernels only have a throughput figure. They are called through a
+// volatile pointer, as from another translation unit, so the buffer size and
+// addresses of this file cannot be folded into the loop.
+typedef void (*bench_array_fn)(const float*, float*, size_t);
+
+#define BENCH_RUN_ARRAY(name, afn, lo, hi)                                  \
+    if (bench_selected(#name))                                              \
+    {                                                                       \
+        bench_result z = {0};                                               \
+        bench_array_fn volatile fn = afn;                                   \
+        double best = 1e30;                                                 \
+        bench_fill(bench_in, lo, hi);                                       \
+        for (int t = 0; t < BENCH_TRIALS; t++)                              \
+        {                                                                   \
+            double t0 = bench_now();                                        \
+            for (int r = 0; r < BENCH_CALLS / BENCH_N; r++)                 \
+            {                                                               \
+                fn(bench_in, bench_out, BENCH_N);                           \
+                bench_sink = bench_out[r & (BENCH_N - 1)];                  \
+            }                                                               \
+            double t1 = bench_now();                                        \
+            if (t1 - t0 < best) best = t1 - t0;                             \
+        }                                                                   \
+        z.tput_ns = best / BENCH_CALLS;                                     \
+        z.lat_ns = z.tput_ns;                                               \
+        bench_report(#name, "zmath", z);                                    \
+    }
+
+// Batch point transforms, per point, through the same volatile-pointer call.
+typedef void (*bench_points_fn)(const zmat4*, const zvec3*, zvec3*, size_t);
+
+static void bench_run_points(void)
+{
+    static zvec3 in[BENCH_N], out[BENCH_N];
+    bench_points_fn volatile fn = zmath_m4_transform_points;
+    zmat4 m = {{ 0.8f, 0.6f, 0.0f, 0.0f,  -0.6f, 0.8f, 0.0f, 0.0f,
+                 0.0f, 0.0f, 1.0f, 0.0f,   1.0f, 2.0f, 3.0f, 1.0f }};
+    bench_result z = {0};
+    double best = 1e30;
+    bench_fill(bench_in, -100.0f, 100.0f);
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        in[i].x = bench_in[i];
+        in[i].y = bench_in[(i + 1) & (BENCH_N - 1)];
+        in[i].z = bench_in[(i + 2) & (BENCH_N - 1)];
+    }
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int r = 0; r < BENCH_CALLS / BENCH_N; r++)
+        {
+            fn(&m, in, out, BENCH_N);
+            bench_sink = out[r & (BENCH_N - 1)].x;
+        }
+        double t1 = bench_now();
+        if (t1 - t0 < best)
+        {
+            best = t1 - t0;
+        }
+    }
+    z.tput_ns = best / BENCH_CALLS;
+    z.lat_ns = z.tput_ns;
+    bench_report("m4_transform_pts", "zmath", z);
+}
+
+// SoA normalization, per vector.
+static void bench_run_soa_norm(void)
+{
+    static float x[BENCH_N], y[BENCH_N], z[BENCH_N];
+    zvec3_soa v = { x, y, z, BENCH_N };
+    void (*volatile fn)(zvec3_soa, zvec3_soa) = zmath_v3_soa_norm;
+    bench_result r = {0};
+    double best = 1e30;
+    bench_fill(bench_in, -100.0f, 100.0f);
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        // Refill each trial so the timed loop never sees unit vectors only.
+        for (int i = 0; i < BENCH_N; i++)
+        {
+            x[i] = bench_in[i];
+            y[i] = bench_in[(i + 1) & (BENCH_N - 1)];
+            z[i] = bench_in[(i + 2) & (BENCH_N - 1)];
+        }
+        double t0 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N; k++)
+        {
+            fn(v, v);
+            bench_sink = x[k & (BENCH_N - 1)];
+        }
+        double t1 = bench_now();
+        if (t1 - t0 < best)
+        {
+            best = t1 - t0;
+        }
+    }
+    r.tput_ns = best / BENCH_CALLS;
+    r.lat_ns = r.tput_ns;
+    bench_report("v3_soa_norm", "zmath", r);
+}
+
+// Frustum culling of SoA spheres into a bitmask, per sphere.
+static void bench_run_cull(void)
+{
+    static float x[BENCH_N], y[BENCH_N], z[BENCH_N], rad[BENCH_N];
+    static uint32_t mask[BENCH_N / 32];
+    zvec3_soa c = { x, y, z, BENCH_N };
+    zplane planes[6];
+    // 90 degree GL perspective, near 1, far 100.
+    zmat4 proj = {{ 1.0f, 0.0f, 0.0f, 0.0f,   0.0f, 1.0f, 0.0f, 0.0f,
+                    0.0f, 0.0f, -101.0f / 99.0f, -1.0f,   0.0f, 0.0f, -200.0f / 99.0f, 0.0f }};
+    void (*volatile fn)(const zplane*, zvec3_soa, const float*, uint32_t*) = zmath_frustum_cull_spheres;
+    bench_result r = {0};
+    double best = 1e30;
+    zmath_frustum_from_m4(proj, false, planes);
+    bench_fill(bench_in, -100.0f, 100.0f);
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        x[i] = bench_in[i];
+        y[i] = bench_in[(i + 1) & (BENCH_N - 1)];
+        z[i] = bench_in[(i + 2) & (BENCH_N - 1)];
+        rad[i] = 0.05f * (bench_in[(i + 3) & (BENCH_N - 1)] + 100.0f);
+    }
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N; k++)
+        {
+            fn(planes, c, rad, mask);
+            bench_sink = (float)mask[k & (BENCH_N / 32 - 1)];
+        }
+        double t1 = bench_now();
+        if (t1 - t0 < best)
+        {
+            best = t1 - t0;
+        }
+    }
+    r.tput_ns = best / BENCH_CALLS;
+    r.lat_ns = r.tput_ns;
+    bench_report("frustum_cull_spheres", "zmath", r);
+}
+
+// Half-float packing and unpacking, per value.
+static void bench_run_f16(void)
+{
+    static uint16_t h[BENCH_N];
+    static float back[BENCH_N];
+    void (*volatile pack)(const float*, uint16_t*, size_t) = zmath_f32_to_f16_array;
+    void (*volatile unpack)(const uint16_t*, float*, size_t) = zmath_f16_to_f32_array;
+    bench_result rp = {0}, ru = {0};
+    double best_p = 1e30, best_u = 1e30;
+    bench_fill(bench_in, -1000.0f, 1000.0f);
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N; k++)
+        {
+            pack(bench_in, h, BENCH_N);
+            bench_sink = (float)h[k & (BENCH_N - 1)];
+        }
+        double t1 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N; k++)
+        {
+            unpack(h, back, BENCH_N);
+            bench_sink = back[k & (BENCH_N - 1)];
+        }
+        double t2 = bench_now();
+        if (t1 - t0 < best_p)
+        {
+            best_p = t1 - t0;
+        }
+        if (t2 - t1 < best_u)
+        {
+            best_u = t2 - t1;
+        }
+    }
+    rp.tput_ns = rp.lat_ns = best_p / BENCH_CALLS;
+    ru.tput_ns = ru.lat_ns = best_u / BENCH_CALLS;
+    bench_report("f32_to_f16_array", "zmath", rp);
+    bench_report("f16_to_f32_array", "zmath", ru);
+}
+
+// Double batches, per value, against libm loops over the same inputs.
+typedef void (*bench_d_array_fn)(const double*, double*, size_t);
+
+static void bench_libm_sin_d(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = sin(in[i]);
+    }
+}
+
+static void bench_libm_exp_d(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = exp(in[i]);
+    }
+}
+
+static void bench_libm_log_d(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = log(in[i]);
+    }
+}
+
+static void bench_run_double(const char* name, const char* impl, bench_d_array_fn afn,
+                             double lo, double hi)
+{
+    static double in[BENCH_N], out[BENCH_N];
+    void (*volatile fn)(const double*, double*, size_t) = afn;
+    bench_result r = {0};
+    double best = 1e30;
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        in[i] = lo + (hi - lo) * (double)bench_rand01();
+    }
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N; k++)
+        {
+            fn(in, out, BENCH_N);
+            bench_sink = (float)out[k & (BENCH_N - 1)];
+        }
+        double dt = bench_now() - t0;
+        if (dt < best)
+        {
+            best = dt;
+        }
+    }
+    r.tput_ns = r.lat_ns = best / BENCH_CALLS;
+    bench_report(name, impl, r);
+}
+
+// Reductions, per element, against the single-accumulator loops they
+// replace.
+typedef float (*bench_reduce_fn)(const float*, size_t);
+
+static float bench_loop_sum(const float* in, size_t n)
+{
+    float s = 0.0f;
+    for (size_t i = 0; i < n; i++)
+    {
+        s += in[i];
+    }
+    return s;
+}
+
+static float bench_loop_min(const float* in, size_t n)
+{
+    float m = ZMATH_INFINITY;
+    for (size_t i = 0; i < n; i++)
+    {
+        m = zmath_min(m, in[i]);
+    }
+    return m;
+}
+
+static void bench_run_reduce(const char* name, const char* impl, bench_reduce_fn rfn)
+{
+    float (*volatile fn)(const float*, size_t) = rfn;
+    bench_result r = {0};
+    double best = 1e30;
+    bench_fill(bench_in, -100.0f, 100.0f);
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N; k++)
+        {
+            bench_sink = fn(bench_in, BENCH_N);
+        }
+        double dt = bench_now() - t0;
+        if (dt < best)
+        {
+            best = dt;
+        }
+    }
+    r.tput_ns = r.lat_ns = best / BENCH_CALLS;
+    bench_report(name, impl, r);
+}
+
+// 4096-point transforms, per sample: the complex and real FFTs against the
+// O(n^2) DFT loop from examples/example_3.c, which is timed once.
+static void bench_run_fft(void)
+{
+    static float table[2 * BENCH_N], rtable[2 * BENCH_N];
+    static float re[BENCH_N + 1], im[BENCH_N + 1];
+    zfft_plan cplx, real;
+    void (*volatile cfn)(const zfft_plan*, float*, float*) = zmath_fft;
+    void (*volatile rfn)(const zfft_plan*, const float*, float*, float*) = zmath_fft_real;
+    bench_result c = {0}, r = {0}, d = {0};
+    double best_c = 1e30, best_r = 1e30;
+    zmath_fft_init(&cplx, BENCH_N, table);
+    zmath_fft_real_init(&real, BENCH_N, rtable);
+    bench_fill(bench_in, -1.0f, 1.0f);
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N / 8; k++)
+        {
+            memcpy(re, bench_in, sizeof(float) * BENCH_N);
+            memcpy(im, bench_in, sizeof(float) * BENCH_N);
+            cfn(&cplx, re, im);
+            bench_sink = re[k & (BENCH_N - 1)];
+        }
+        double t1 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N / 8; k++)
+        {
+            rfn(&real, bench_in, re, im);
+            bench_sink = re[k & (BENCH_N / 2 - 1)];
+        }
+        double t2 = bench_now();
+        if (t1 - t0 < best_c)
+        {
+            best_c = t1 - t0;
+        }
+        if (t2 - t1 < best_r)
+        {
+            best_r = t2 - t1;
+        }
+    }
+    c.tput_ns = c.lat_ns = best_c / (BENCH_CALLS / 8);
+    r.tput_ns = r.lat_ns = best_r / (BENCH_CALLS / 8);
+
+    double t0 = bench_now();
+    for (int k = 0; k <= BENCH_N / 2; k++)
+    {
+        float sr = 0.0f, si = 0.0f;
+        for (int j = 0; j < BENCH_N; j++)
+        {
+            float s, co;
+            zmath_sincos(-ZMATH_TAU * (float)k * (float)j / (float)BENCH_N, &s, &co);
+            sr += bench_in[j] * co;
+            si += bench_in[j] * s;
+        }
+        re[k] = sr;
+        im[k] = si;
+    }
+    bench_sink = re[1] + im[1];
+    d.tput_ns = d.lat_ns = (bench_now() - t0) / BENCH_N;
+    bench_report("fft_4096", "complex", c);
+    bench_report("fft_4096", "real", r);
+    bench_report("fft_4096", "naive_dft", d);
+}
+
+// Noise grid fills and 3D point batches, per sample. The scalar row calls
+// zmath_noise_perlin2 once per sample for comparison.
+static void bench_perlin2_scalar(int kind, uint32_t seed, float x0, float y0, float step,
+                                 float* out, size_t w, size_t h)
+{
+    (void)kind;
+    for (size_t j = 0; j < h; j++)
+    {
+        for (size_t i = 0; i < w; i++)
+        {
+            out[j * w + i] = zmath_noise_perlin2(x0 + (float)i * step, y0 + (float)j * step, seed);
+        }
+    }
+}
+
+typedef void (*bench_grid_fn)(int, uint32_t, float, float, float, float*, size_t, size_t);
+
+static void bench_run_noise(const char* name, bench_grid_fn afn, int kind, int three_d)
+{
+    static float y[BENCH_N], z[BENCH_N];
+    bench_grid_fn volatile fn = afn;
+    void (*volatile fn3)(int, uint32_t, zvec3_soa, float*) = zmath_noise3_array;
+    zvec3_soa p = { bench_in, y, z, BENCH_N };
+    bench_result r = {0};
+    double best = 1e30;
+    bench_fill(bench_in, -100.0f, 100.0f);
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        y[i] = bench_in[(i + 1) & (BENCH_N - 1)];
+        z[i] = bench_in[(i + 2) & (BENCH_N - 1)];
+    }
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int k = 0; k < BENCH_CALLS / BENCH_N; k++)
+        {
+            if (three_d)
+            {
+                fn3(kind, (uint32_t)k, p, bench_out);
+            }
+            else
+            {
+                fn(kind, (uint32_t)k, -3.0f, 5.0f, 0.037f, bench_out, 64, BENCH_N / 64);
+            }
+            bench_sink = bench_out[k & (BENCH_N - 1)];
+        }
+        double t1 = bench_now();
+        if (t1 - t0 < best)
+        {
+            best = t1 - t0;
+        }
+    }
+    r.tput_ns = best / BENCH_CALLS;
+    r.lat_ns = r.tput_ns;
+    bench_report(name, afn == bench_perlin2_scalar ? "scalar" : "zmath", r);
+}
+
+// Two-pose quaternion blends, per joint.
+typedef void (*bench_quats_fn)(const zquat*, const zquat*, float, zquat*, size_t);
+
+static void bench_run_quats(const char* name, bench_quats_fn afn)
+{
+    static zquat a[BENCH_N], b[BENCH_N], out[BENCH_N];
+    bench_quats_fn volatile fn = afn;
+    bench_result z = {0};
+    double best = 1e30;
+    bench_fill(bench_in, -3.0f, 3.0f);
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        zvec3 axis = { 0.0f, 0.6f, 0.8f };
+        a[i] = zmath_q_from_axis_angle(axis, bench_in[i]);
+        b[i] = zmath_q_from_axis_angle(axis, bench_in[(i + 1) & (BENCH_N - 1)]);
+    }
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int r = 0; r < BENCH_CALLS / BENCH_N; r++)
+        {
+            fn(a, b, 0.3f, out, BENCH_N);
+            bench_sink = out[r & (BENCH_N - 1)].w;
+        }
+        double t1 = bench_now();
+        if (t1 - t0 < best)
+        {
+            best = t1 - t0;
+        }
+    }
+    z.tput_ns = best / BENCH_CALLS;
+    z.lat_ns = z.tput_ns;
+    bench_report(name, "zmath", z);
+}
+
+// Random fills, per float, against a rand() loop.
+typedef void (*bench_rng_fn)(zrng*, float, float, float*, size_t);
+
+static void bench_libc_fill_uniform(zrng* r, float lo, float hi, float* out, size_t n)
+{
+    (void)r;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = lo + (hi - lo) * ((float)rand() / ((float)RAND_MAX + 1.0f));
+    }
+}
+
+static void bench_run_rng(const char* name, const char* impl, bench_rng_fn afn)
+{
+    bench_rng_fn volatile fn = afn;
+    zrng g = zmath_rng_seed(1);
+    bench_result z = {0};
+    double best = 1e30;
+    for (int t = 0; t < BENCH_TRIALS; t++)
+    {
+        double t0 = bench_now();
+        for (int r = 0; r < BENCH_CALLS / BENCH_N; r++)
+        {
+            fn(&g, 0.0f, 1.0f, bench_out, BENCH_N);
+            bench_sink = bench_out[r & (BENCH_N - 1)];
+        }
+        double t1 = bench_now();
+        if (t1 - t0 < best)
+        {
+            best = t1 - t0;
+        }
+    }
+    z.tput_ns = best / BENCH_CALLS;
+    z.lat_ns = z.tput_ns;
+    bench_report(name, impl, z);
+}
+
+int main(int argc, char** argv)
+{
+    const char* csv_path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            csv_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stride") == 0 && i + 1 < argc)
+        {
+            bench_stride = (uint32_t)strtoul(argv[++i], NULL, 10);
+            if (bench_stride == 0)
+            {
+                bench_stride = 1;
+            }
+        }
+        else if (strcmp(argv[i], "--full") == 0)
+        {
+            bench_stride = 1;
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            bench_filter = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-o out.csv] [--stride N] [--full] [--filter name]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (csv_path)
+    {
+        bench_csv = fopen(csv_path, "w");
+        if (!bench_csv)
+        {
+            fprintf(stderr, "cannot open %s\n", csv_path);
+            return 1;
+        }
+        fprintf(bench_csv, "function,impl,lat_ns,tput_ns,max_ulp,mean_ulp,max_abs,samples,bad\n");
+    }
+
+    printf("=> Benchmarks (zmath.h vs libm), ULP sweep stride %u.\n", (unsigned)bench_stride);
+    printf("%-16s %-6s %8s %8s %12s %10s %10s\n",
+           "function", "impl", "lat ns", "tput ns", "max ulp", "mean ulp", "max abs");
+
+    BENCH_UNARY_LIST(BENCH_RUN_UNARY)
+    BENCH_BINARY_LIST(BENCH_RUN_BINARY)
+
+    if (bench_selected("sincos"))
+    {
+        bench_result z = {0}, l = {0};
+        bench_fill(bench_in, -1e4f, 1e4f);
+        BENCH_TIME_UNARY(z, bench_zmath_sincos, bench_in);
+        BENCH_TIME_UNARY(l, bench_libm_sincos, bench_in);
+        bench_report("sincos", "zmath", z);
+        bench_report("sincos", "libm", l);
+    }
+
+    BENCH_ARRAY_LIST(BENCH_RUN_ARRAY)
+
+    if (bench_selected("poly12"))
+    {
+        bench_result e = {0}, h = {0};
+        bench_fill(bench_in, -2.0f, 2.0f);
+        BENCH_TIME_UNARY(e, bench_poly_estrin, bench_in);
+        BENCH_TIME_UNARY(h, bench_poly_horner, bench_in);
+        bench_report("poly12", "estrin", e);
+        bench_report("poly12", "horner", h);
+    }
+    if (bench_selected("m4_transform_pts"))
+    {
+        bench_run_points();
+    }
+    if (bench_selected("v3_soa_norm"))
+    {
+        bench_run_soa_norm();
+    }
+    if (bench_selected("frustum_cull_spheres"))
+    {
+        bench_run_cull();
+    }
+    if (bench_selected("fft_4096"))
+    {
+        bench_run_fft();
+    }
+    if (bench_selected("f32_to_f16_array") || bench_selected("f16_to_f32_array"))
+    {
+        bench_run_f16();
+    }
+    if (bench_selected("sin_d_array"))
+    {
+        bench_run_double("sin_d_array", "zmath", zmath_sin_d_array, -1.0e6, 1.0e6);
+        bench_run_double("sin_d_array", "libm", bench_libm_sin_d, -1.0e6, 1.0e6);
+    }
+    if (bench_selected("exp_d_array"))
+    {
+        bench_run_double("exp_d_array", "zmath", zmath_exp_d_array, -700.0, 700.0);
+        bench_run_double("exp_d_array", "libm", bench_libm_exp_d, -700.0, 700.0);
+    }
+    if (bench_selected("log_d_array"))
+    {
+        bench_run_double("log_d_array", "zmath", zmath_log_d_array, 1.0e-3, 1.0e6);
+        bench_run_double("log_d_array", "libm", bench_libm_log_d, 1.0e-3, 1.0e6);
+    }
+    if (bench_selected("sum_array"))
+    {
+        bench_run_reduce("sum_array", "zmath", zmath_sum_array);
+        bench_run_reduce("sum_array", "loop", bench_loop_sum);
+        bench_run_reduce("sum_kahan_array", "zmath", zmath_sum_kahan_array);
+    }
+    if (bench_selected("min_array"))
+    {
+        bench_run_reduce("min_array", "zmath", zmath_min_array);
+        bench_run_reduce("min_array", "loop", bench_loop_min);
+    }
+    if (bench_selected("noise2_grid_value"))
+    {
+        bench_run_noise("noise2_grid_value", zmath_noise2_grid, ZMATH_NOISE_VALUE, 0);
+    }
+    if (bench_selected("noise2_grid_perlin"))
+    {
+        bench_run_noise("noise2_grid_perlin", zmath_noise2_grid, ZMATH_NOISE_PERLIN, 0);
+        bench_run_noise("noise2_grid_perlin", bench_perlin2_scalar, ZMATH_NOISE_PERLIN, 0);
+    }
+    if (bench_selected("noise2_grid_simplex"))
+    {
+        bench_run_noise("noise2_grid_simplex", zmath_noise2_grid, ZMATH_NOISE_SIMPLEX, 0);
+    }
+    if (bench_selected("noise3_array_perlin"))
+    {
+        bench_run_noise("noise3_array_perlin", zmath_noise2_grid, ZMATH_NOISE_PERLIN, 1);
+    }
+    if (bench_selected("noise3_array_simplex"))
+    {
+        bench_run_noise("noise3_array_simplex", zmath_noise2_grid, ZMATH_NOISE_SIMPLEX, 1);
+    }
+    if (bench_selected("q_nlerp_array"))
+    {
+        bench_run_quats("q_nlerp_array", zmath_q_nlerp_array);
+    }
+    if (bench_selected("q_slerp_array"))
+    {
+        bench_run_quats("q_slerp_array", zmath_q_slerp_array);
+    }
+    if (bench_selected("rng_fill_uniform"))
+    {
+        bench_run_rng("rng_fill_uniform", "zmath", zmath_rng_fill_uniform);
+        bench_run_rng("rng_fill_uniform", "libc", bench_libc_fill_uniform);
+    }
+    if (bench_selected("rng_fill_normal"))
+    {
+        bench_run_rng("rng_fill_normal", "zmath", zmath_rng_fill_normal);
+    }
+
+    if (bench_csv)
+    {
+        fclose(bench_csv);
+        printf("=> Wrote %s.\n", csv_path);
+    }
+    return 0;
+}
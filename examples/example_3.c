@@ -4,14 +4,14 @@
 #define ZMATH_SHORT_NAMES
 #include "zmath.h"
 
-#define N 16 // Number of samples (Must be small for O(N^2) DFT demo).
+#define N 16 // Number of samples (a power of two for the FFT).
 
 int main(void) 
 {
     float signal[N];
     float sample_rate = 16.0f; // Hz
 
-    printf("=> Signal Analysis (DFT)\n");
+    printf("=> Signal Analysis (FFT)\n");
 
     // We generate the signal: 
     // A mix of 1 Hz wave + 4 Hz wave + constant DC offset.
@@ -23,27 +23,15 @@ int main(void)
         printf("  t=%.2fs: %.2f\n", t, signal[i]);
     }
 
-    // We perform the DFT (Discrete Fourier Transform).
-    // We calculate Real (re) and Imaginary (im) components for each frequency bin.
+    // We perform the FFT (Fast Fourier Transform) of the real signal.
+    // It gives Real (re) and Imaginary (im) components for bins 0..N/2.
+    float table[2 * N];
+    fft_plan plan;
+    fft_real_init(&plan, N, table);
+
     float re_out[N/2 + 1];
     float im_out[N/2 + 1];
-
-    for (int k = 0; k <= N/2; k++) 
-    {
-        float re = 0.0f;
-        float im = 0.0f;
-        
-        for (int n = 0; n < N; n++) 
-        {
-            // Euler's Formula: e^(-i*2*pi*k*n/N) = cos(...) - i*sin(...).
-            float angle = -TAU * (float)k * (float)n / (float)N;
-            re += signal[n] * cos(angle);
-            im += signal[n] * sin(angle);
-        }
-
-        re_out[k] = re;
-        im_out[k] = im;
-    }
+    fft_real(&plan, signal, re_out, im_out);
 
     // Time to analyze the results (Frequency Domain).
     printf("\nOutput (Frequency Domain):\n");
@@ -6,11 +6,26 @@
 
 #define ZMATH_IMPLEMENTATION
 #define ZMATH_SHORT_NAMES
+#define ZMATH_CPP
 #include "zmath.h"
 
 #define TEST(name) printf("[TEST] %-35s", name);
 #define PASS() printf(" \033[0;32mPASS\033[0m\n")
 
+// Targets that fuse multiply-adds round polynomials slightly differently
+// from the scalar code, and x87 (FLT_EVAL_METHOD 2) rounds intermediates
+// wherever the compiler spills them, so batch results are only required to
+// be close. Results in [0, 1] from kernels that hoist a reciprocal are held
+// to T_ULPS, a few ulps of 1, doubled there.
+#if defined(ZMATH_SIMD_AVX2) || defined(ZMATH_SIMD_NEON) || defined(__FMA__) || \
+    (defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0)
+#define SAME(a, b) ((a) == (b) || is_near((a), (b), 1e-5f * (1.0f + abs(b))))
+#define T_ULPS (8.0f * 1.1920929e-07f)
+#else
+#define SAME(a, b) ((a) == (b))
+#define T_ULPS (4.0f * 1.1920929e-07f)
+#endif
+
 void test_basic_arithmetic(void) 
 {
     TEST("Abs, Min, Max, Clamp, Rounding");
@@ -32,6 +47,18 @@ void test_basic_arithmetic(void)
     assert(ceil(2.2f) == 3.0f);
     assert(round(2.5f) == 3.0f);
     assert(round(2.4f) == 2.0f);
+    assert(floor(-0.5f) == -1.0f && ceil(-0.5f) == 0.0f);
+    assert(round(-2.5f) == -3.0f && round(-0.4f) == 0.0f);
+    assert(floor(-3.0f) == -3.0f && ceil(4194304.5f) == 4194305.0f);
+
+    // Past 2^23 every float is an integer and passes through unchanged.
+    assert(floor(8388609.0f) == 8388609.0f && round(8388609.0f) == 8388609.0f);
+    assert(ceil(-16777216.0f) == -16777216.0f);
+    assert(floor(ZMATH_INFINITY) == ZMATH_INFINITY);
+    assert(isnan(floor(ZMATH_NAN)) && isnan(round(ZMATH_NAN)));
+
+    // Fmod truncates, mod wraps.
+    assert(fmod(-7.5f, 2.0f) == -1.5f && mod(-7.5f, 2.0f) == 0.5f);
 
     // Fract.
     assert(is_near(fract(1.25f), 0.25f, 0.0001f));
@@ -60,6 +87,18 @@ void test_interpolation(void)
     PASS();
 }
 
+// Distance of a from b in units of the last place of (float)b.
+static double ulp_error(float a, double b)
+{
+    float w = (float)(b < 0.0 ? -b : b), up;
+    uint32_t u;
+    memcpy(&u, &w, sizeof u);
+    u++;
+    memcpy(&up, &u, sizeof up);
+    double d = (double)a - b;
+    return (d < 0.0 ? -d : d) / (double)(up - w);
+}
+
 void test_trigonometry(void) 
 {
     TEST("Sin, Cos, Atan2 (Approx)");
@@ -76,6 +115,82 @@ void test_trigonometry(void)
     assert(is_near(cos(0.0f), 1.0f, 0.001f));
     assert(is_near(cos(ZMATH_PI), -1.0f, 0.001f));
 
+    // Sincos shares one reduction and matches sin/cos exactly.
+    for (float x = -40.0f; x < 40.0f; x += 0.37f) 
+    {
+        float s, c;
+        sincos(x, &s, &c);
+        assert(s == sin(x) && c == cos(x));
+        sincos_fast(x, &s, &c);
+        assert(s == sin_fast(x) && c == cos_fast(x));
+        sincos_precise(x, &s, &c);
+        assert(s == sin_precise(x) && c == cos_precise(x));
+    }
+
+    // Large arguments keep full reduction accuracy in every tier.
+    const float big[5] = { 12345.677734375f, 300000.5f, -98765.4296875f, 100000.0f, 300000.0f };
+    const float big_sin[5] = { -0.70426991f, -0.38271269f, -0.03983340f, 0.03574880f, 0.10706365f };
+    const float big_cos[5] = { 0.70993231f, -0.92386741f, 0.99920634f, -0.99936081f, -0.99425217f };
+    for (int i = 0; i < 5; i++)
+    {
+        assert(is_near(sin(big[i]), big_sin[i], 0.001f) && is_near(cos(big[i]), big_cos[i], 0.001f));
+        assert(is_near(sin_fast(big[i]), big_sin[i], 0.001f));
+        assert(is_near(sin_precise(big[i]), big_sin[i], 2e-7f) && is_near(cos_precise(big[i]), big_cos[i], 2e-7f));
+    }
+
+    // Next to the zeros of sin and cos, where a reduction loses the most, the
+    // precise tier stays within the 1.6 ulp of the accuracy table.
+    for (int k = 1; k < 1000000; k += 7)
+    {
+        float x0 = (float)(k * 1.5707963267948966);
+        uint32_t u;
+        memcpy(&u, &x0, sizeof u);
+        for (uint32_t d = u - 1; d <= u + 1; d++)
+        {
+            float x, s, c;
+            memcpy(&x, &d, sizeof x);
+            sincos_precise(x, &s, &c);
+            assert(ulp_error(s, sin_d(x)) <= 1.6 && ulp_error(c, cos_d(x)) <= 1.6);
+        }
+    }
+
+    // Past 2^18 every tier reduces in integers, so the default and fast
+    // tiers keep their accuracy at any magnitude. Infinities give NaN.
+    const float tier_tol = (ZMATH_ACCURACY == ZMATH_ACCURACY_FAST) ? 1.2e-4f : 6e-6f;
+    for (float x = 1e6f; x <= 1e10f; x *= 1.37f)
+    {
+        float ps = sin_precise(x), pc = cos_precise(x);
+        assert(is_near(sin(x), ps, tier_tol) && is_near(sin(-x), -ps, tier_tol) && is_near(cos(-x), pc, tier_tol));
+        assert(is_near(sin_fast(x), ps, 1.2e-4f) && is_near(cos_fast(x), pc, 1.2e-4f));
+    }
+    assert(sin(ZMATH_INFINITY) != sin(ZMATH_INFINITY) && cos_fast(-ZMATH_INFINITY) != cos_fast(-ZMATH_INFINITY));
+    assert(sin_precise(ZMATH_INFINITY) != sin_precise(ZMATH_INFINITY));
+
+    // The precise tier keeps its quadrant count exact at any magnitude.
+    const float huge[3] = { 7e6f, 1e7f, 1e8f };
+    const float huge_sin[3] = { -0.59610684f, 0.42054779f, 0.93163903f };
+    const float huge_cos[3] = { -0.80290513f, -0.90727039f, -0.36338509f };
+    for (int i = 0; i < 3; i++)
+    {
+        float s, c;
+        sincos_precise(huge[i], &s, &c);
+        assert(abs(s) <= 1.0f && abs(c) <= 1.0f);
+        assert(is_near(s, huge_sin[i], 2e-7f) && is_near(c, huge_cos[i], 2e-7f));
+    }
+
+    // Turns: whole turns drop out exactly, even after hours of phase.
+    assert(is_near(sin_turns(0.25f), 1.0f, 0.001f) && is_near(sin_turns(-2.75f), 1.0f, 0.001f));
+    assert(is_near(sin_turns(1000000.25f), 1.0f, 0.001f));
+    assert(is_near(cos_turns(1584000.125f), 0.70710678f, 0.001f));
+    assert(is_near(cos_turns(-0.5f), -1.0f, 0.001f) && is_near(sin_turns(16777216.0f), 0.0f, 1e-6f));
+    for (float t = -3.0f; t < 3.0f; t += 0.0625f)
+    {
+        float s, c;
+        sincos_turns(t, &s, &c);
+        assert(s == sin_turns(t) && c == cos_turns(t));
+        assert(is_near(s, sin(t * TAU), 1e-5f) && is_near(c, cos(t * TAU), 1e-5f));
+    }
+
     // Atan2.
     assert(is_near(atan2(0.0f, 1.0f), 0.0f, 0.001f)); // 0 deg.
     assert(is_near(atan2(1.0f, 0.0f), ZMATH_HALF_PI, 0.001f)); // 90 deg.
@@ -115,6 +230,1908 @@ void test_vectors(void)
     PASS();
 }
 
+void test_accuracy_tiers(void) 
+{
+    TEST("Accuracy Tiers (fast/precise)");
+
+    // Reference values from double-precision libm on the float inputs.
+    const float x[4]   = { 1.0f, -2.5f, 7.0f, 1000.0f };
+    const float sx[4]  = { 0.84147098f, -0.59847214f, 0.65698660f, 0.82687954f };
+    const float cx[4]  = { 0.54030231f, -0.80114362f, 0.75390225f, 0.56237907f };
+    const float ex[4]  = { 2.71828183f, 0.08208500f, 1096.63316f, 0.0f };
+    const float lx[4]  = { 0.0f, 0.91629073f, 1.94591015f, 6.90775528f };
+    const float ix[4]  = { 1.0f, 0.63245553f, 0.37796447f, 0.03162278f };
+
+    for (int i = 0; i < 4; i++) 
+    {
+        float a = abs(x[i]);
+
+        assert(is_near(sin_fast(x[i]), sx[i], 1.2e-4f));
+        assert(is_near(cos_fast(x[i]), cx[i], 1.2e-4f));
+        assert(is_near(sin_precise(x[i]), sx[i], 2e-7f));
+        assert(is_near(cos_precise(x[i]), cx[i], 2e-7f));
+
+        assert(is_near(log_fast(a), lx[i], 1e-3f));
+        assert(is_near(log_precise(a), lx[i], 4e-7f * (1.0f + lx[i])));
+
+        assert(is_near(invsqrt_fast(a), ix[i], 3.5e-2f * ix[i]));
+        assert(is_near(invsqrt_precise(a), ix[i], 3e-7f * ix[i]));
+
+        if (i < 3) 
+        {
+            assert(is_near(exp_fast(x[i]), ex[i], 2e-3f * ex[i]));
+            assert(is_near(exp_precise(x[i]), ex[i], 2e-7f * ex[i]));
+        }
+    }
+
+    // The unsuffixed functions use the ZMATH_ACCURACY tier.
+#if ZMATH_ACCURACY == ZMATH_ACCURACY_FAST
+    assert(sin(x[1]) == sin_fast(x[1]) && exp(x[1]) == exp_fast(x[1]));
+#elif ZMATH_ACCURACY == ZMATH_ACCURACY_PRECISE
+    assert(sin(x[1]) == sin_precise(x[1]) && exp(x[1]) == exp_precise(x[1]));
+#else
+    assert(is_near(sin(x[1]), sx[1], 1e-5f));
+    assert(is_near(exp(x[1]), ex[1], 1e-3f * ex[1]));
+#endif
+
+    PASS();
+}
+
+void test_exp2_log2_pow(void) 
+{
+    TEST("Table-Driven exp2 / log2 / pow");
+
+#if ZMATH_ACCURACY != ZMATH_ACCURACY_FAST
+    // Exact at powers of two, and one rounding step from libm elsewhere.
+    for (int k = -126; k < 128; k += 7)
+    {
+        float p2 = exp2((float)k);
+        assert(log2(p2) == (float)k);
+    }
+    assert(exp2(10.0f) == 1024.0f && exp2(-3.0f) == 0.125f);
+    assert(exp2(128.0f) == ZMATH_INFINITY && exp2(-127.0f) == 0.0f);
+    assert(log2(1.0f) == 0.0f && log2(0.0f) == -ZMATH_INFINITY);
+
+    // Reference values from double-precision libm on the float inputs.
+    const float x[5]  = { 0.3f, 1.0001f, 2.5f, 77.0f, 1e-20f };
+    const float l2[5] = { -1.73696554f, 1.44286229e-4f, 1.32192809f, 6.26678654f, -66.43856190f };
+    const float e2[5] = { 1.23114442f, 2.00013866f, 5.65685425f, 1.51115727e23f, 1.0f };
+    for (int i = 0; i < 5; i++)
+    {
+        assert(is_near(log2(x[i]), l2[i], 2.5e-7f * abs(l2[i])));
+        assert(is_near(exp2(x[i]), e2[i], 2e-7f * e2[i]));
+    }
+
+    // y * log2(x) is carried in extra precision, so large exponents stay
+    // within a couple of ULP instead of amplifying the log error.
+    assert(pow(2.0f, 10.0f) == 1024.0f && pow(10.0f, 2.0f) == 100.0f);
+    assert(pow(4.0f, 0.5f) == 2.0f && pow(1.0f, 1e6f) == 1.0f);
+    assert(is_near(pow(0.0863036f, 19.8347f), 7.87867108e-22f, 3e-7f * 7.87867108e-22f));
+    assert(is_near(pow(32.9585f, -18.6599f), 4.73018816e-29f, 3e-7f * 4.73018816e-29f));
+    assert(is_near(pow(1.5f, 200.0f), 1.65291991e35f, 3e-7f * 1.65291991e35f));
+    assert(pow(10.0f, 39.0f) == ZMATH_INFINITY);
+#endif
+    assert(pow(3.0f, 0.0f) == 1.0f && pow(-2.0f, 2.0f) == 0.0f);
+
+    PASS();
+}
+
+void test_special_values(void) 
+{
+    TEST("Special Values and Flush-to-Zero");
+
+#ifndef ZMATH_FAST_MATH
+    // Overflow saturates, underflow flushes, NaN passes through, per tier.
+    float (*const exps[3])(float) = { zmath_exp, zmath_exp_fast, zmath_exp_precise };
+    float (*const logs[3])(float) = { zmath_log, zmath_log_fast, zmath_log_precise };
+    for (int t = 0; t < 3; t++)
+    {
+        assert(exps[t](89.0f) == ZMATH_INFINITY && exps[t](ZMATH_INFINITY) == ZMATH_INFINITY);
+        assert(exps[t](-88.0f) == 0.0f && exps[t](-ZMATH_INFINITY) == 0.0f && exps[t](-1e30f) == 0.0f);
+        assert(exps[t](88.7f) > 1e38f && exps[t](88.7f) != ZMATH_INFINITY);
+        assert(exps[t](-87.3f) >= 1.17549435e-38f);
+        assert(isnan(exps[t](ZMATH_NAN)));
+
+        // Subnormal inputs keep their exponent: ln(1e-40) and ln(2^-149).
+        assert(is_near(logs[t](1e-40f), -92.1034037f, 1e-3f));
+        assert(is_near(logs[t](1.4e-45f), -103.278929f, 1e-3f));
+        assert(logs[t](ZMATH_INFINITY) == ZMATH_INFINITY && isnan(logs[t](ZMATH_NAN)));
+    }
+    assert(exp2(1e30f) == ZMATH_INFINITY && exp2(-1e30f) == 0.0f && isnan(exp2(ZMATH_NAN)));
+    assert(log2(ZMATH_INFINITY) == ZMATH_INFINITY && isnan(log2(ZMATH_NAN)));
+    assert(pow(ZMATH_INFINITY, 2.0f) == ZMATH_INFINITY && pow(ZMATH_INFINITY, -1.0f) == 0.0f);
+    assert(isnan(pow(ZMATH_NAN, 2.0f)) && isnan(pow(2.0f, ZMATH_NAN)));
+#if ZMATH_ACCURACY != ZMATH_ACCURACY_FAST
+    // Through variables: with FLT_EVAL_METHOD 2 neither the literal nor the
+    // difference is rounded to float inside the expression.
+    float sub = 1e-40f;
+    float l_sub = log2(sub), l_scaled = log2(sub * 8388608.0f) - 23.0f;
+    assert(log2(1.4e-45f) == -149.0f && l_sub == l_scaled);
+    float sub_in = 7.17464814e-43f, root = 8.47032947e-22f, sub_root = pow(sub_in, 0.5f);
+    assert(sub_root == root);
+#endif
+
+    // The batch kernels agree with the scalar calls on every special value.
+    enum { COUNT = 16 };
+    const float in[COUNT] = {
+        ZMATH_INFINITY, -ZMATH_INFINITY, ZMATH_NAN, 0.0f, 1e-40f, 1.4e-45f, 89.0f, -88.0f,
+        88.7f, -87.3f, 1e30f, -1e30f, 1.0f, 2.5f, 1.17549435e-38f, 3.4e38f
+    };
+    float out[COUNT];
+    exp_array(in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], exp(in[i])) || (isnan(out[i]) && isnan(in[i])));
+    }
+    log_array(in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], log(in[i])) || (isnan(out[i]) && isnan(log(in[i]))));
+    }
+#endif
+
+    // Flush-to-zero treats subnormal inputs and results as zero, then the
+    // previous mode comes back. Volatile accesses pin the multiplies
+    // between the calls. MXCSR does not govern x87 arithmetic.
+#if defined(__SSE_MATH__) || defined(_M_X64) || defined(__aarch64__)
+    volatile float tiny = 1e-40f, flushed, kept;
+    fp_state saved = ftz_begin();
+    flushed = tiny * 3.0f;
+    ftz_end(saved);
+    kept = tiny * 3.0f;
+    assert(flushed == 0.0f && kept > 2e-40f);
+#endif
+
+    PASS();
+}
+
+void test_rcp_rsqrt(void) 
+{
+    TEST("Rcp, Rsqrt_n, Normalize");
+
+    // Each Newton step roughly squares the seed error.
+    const float x[5]  = { 1.0f, 0.25f, 2.0f, 123.456f, 1e-20f };
+    const float rs[5] = { 1.0f, 2.0f, 0.707106781f, 0.0900002875f, 1.00000002e10f };
+    for (int i = 0; i < 5; i++)
+    {
+        float ref = rs[i];
+        assert(is_near(rsqrt_n(x[i], 0), ref, 3.5e-2f * ref));
+        assert(is_near(rsqrt_n(x[i], 1), ref, 1.8e-3f * ref));
+        assert(is_near(rsqrt_n(x[i], 2), ref, 5e-6f * ref));
+        assert(is_near(rsqrt_n(x[i], 3), ref, 3e-7f * ref));
+        assert(is_near(rcp(x[i]), 1.0f / x[i], 3e-7f / x[i]));
+    }
+#ifndef ZMATH_USE_HW_RSQRT
+    assert(rsqrt_n(9.0f, 3) == invsqrt_precise(9.0f));
+    assert(rcp(4.0f) == 0.25f && rcp(-0.5f) == -2.0f);
+#endif
+    assert(rcp(0.0f) == ZMATH_INFINITY);
+
+    // Normalize is one invsqrt multiply at every tier; tiny vectors pass
+    // through.
+    const float tol = 5e-6f;
+    for (int i = 1; i < 200; i++)
+    {
+        float f = (float)i;
+        vec3 v = { f * 0.37f - 30.0f, 1e3f / f, f * f * 1e-3f };
+        vec3 n = v3_norm(v);
+        assert(is_near(v3_dot(n, n), 1.0f, 2.0f * tol));
+        assert(is_near(n.x * v3_len(v), v.x, 1e-3f * v3_len(v)));
+        vec2 w = { v.y, v.z };
+        vec2 m = v2_norm(w);
+        assert(is_near(v2_dot(m, m), 1.0f, 2.0f * tol));
+    }
+    vec3 tiny = { 1e-8f, 0.0f, 0.0f };
+    vec3 kept = v3_norm(tiny);
+    assert(kept.x == tiny.x && kept.y == 0.0f && kept.z == 0.0f);
+
+    // Zero gets a large finite invsqrt, also from the hardware estimate, so
+    // a zero quaternion normalizes to zero instead of NaN.
+    float zeros[8] = {0}, inv0[8];
+    invsqrt_array(zeros, inv0, 8);
+    assert(invsqrt(0.0f) > 1e18f && invsqrt(0.0f) < ZMATH_INFINITY && sqrt(0.0f) == 0.0f);
+    for (int i = 0; i < 8; i++)
+    {
+        assert(inv0[i] > 1e18f && inv0[i] < ZMATH_INFINITY);
+    }
+    quat q0 = {0.0f, 0.0f, 0.0f, 0.0f};
+    quat n0 = q_norm(q0);
+    quat l0 = q_nlerp(q0, q0, 0.5f);
+    assert(n0.x == 0.0f && n0.y == 0.0f && n0.z == 0.0f && n0.w == 0.0f);
+    assert(l0.x == 0.0f && l0.y == 0.0f && l0.z == 0.0f && l0.w == 0.0f);
+
+    PASS();
+}
+
+#ifdef ZMATH_TRIG_LUT
+void test_trig_lut(void) 
+{
+    TEST("Trig LUT (turns, nearest/linear)");
+
+    // Expected worst case for the configured table, plus reduction slop.
+    const float steps = (float)(1u << ZMATH_TRIG_LUT_BITS);
+#if ZMATH_TRIG_LUT_INTERP == ZMATH_TRIG_LUT_NEAREST
+    const float tol = 3.2f / steps + 2e-7f;
+#else
+    const float tol = 6.0f / (steps * steps) + 2e-7f;
+#endif
+
+    // Quadrant boundaries are exact table entries.
+    assert(sin_turn(0u) == 0.0f && cos_turn(0u) == 1.0f);
+    assert(sin_turn(0x40000000u) == 1.0f && sin_turn(0xC0000000u) == -1.0f);
+    assert(cos_turn(0x80000000u) == -1.0f);
+
+    for (uint32_t i = 0; i < 4096; i++) 
+    {
+        uint32_t phase = i * 1048573u + 12345u;
+        float a = (float)((double)phase * (6.283185307179586 / 4294967296.0));
+        assert(is_near(sin_turn(phase), sin_precise(a), tol));
+        assert(is_near(cos_turn(phase), cos_precise(a), tol));
+    }
+
+    for (float x = -40.0f; x < 40.0f; x += 0.013f) 
+    {
+        assert(is_near(sin_lut(x), sin_precise(x), tol + 2e-6f));
+        assert(is_near(cos_lut(x), cos_precise(x), tol + 2e-6f));
+    }
+
+    // Radians map onto the same phase circle, negative angles included.
+    assert(rad2turn(ZMATH_HALF_PI) - 0x40000000u + 256u < 512u);
+    assert(rad2turn(-ZMATH_HALF_PI) - 0xC0000000u + 256u < 512u);
+
+    // The oscillator fill matches stepping by hand and hands back the phase.
+    float wave[100];
+    uint32_t next = sin_turn_fill(0xFFFF0000u, 0x01234567u, wave, 100);
+    assert(next == 0xFFFF0000u + 100u * 0x01234567u);
+    for (uint32_t i = 0; i < 100; i++) 
+    {
+        assert(is_near(wave[i], sin_turn(0xFFFF0000u + i * 0x01234567u), 1e-6f));
+    }
+
+    PASS();
+}
+#endif
+
+void test_batch_kernels(void) 
+{
+    TEST("Batch Kernels (array == scalar)");
+
+    enum { COUNT = 257 };
+    float in[COUNT], in2[COUNT], out[COUNT];
+
+    for (int i = 0; i < COUNT; i++) 
+    {
+        in[i] = -20.0f + 40.0f * (float)i / (float)(COUNT - 1);
+        in2[i] = 0.25f * (float)(i % 17) - 2.0f;
+    }
+
+    // Every lane must be bit-identical to the scalar call.
+    sin_array(in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], sin(in[i])));
+    }
+    cos_array(in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], cos(in[i])));
+    }
+
+    // Lanes with large arguments take the scalar fallback next to ordinary
+    // ones.
+    float big[16], big_out[16];
+    for (int i = 0; i < 16; i++)
+    {
+        big[i] = (i % 3 == 0) ? 0.75f * (float)i : 1e5f * (float)(i * i * i + 3) * ((i & 1) ? -1.0f : 1.0f);
+    }
+    big[7] = ZMATH_INFINITY;
+    sin_array(big, big_out, 16);
+    for (int i = 0; i < 16; i++)
+    {
+        assert(SAME(big_out[i], sin(big[i])) || (i == 7 && big_out[i] != big_out[i]));
+    }
+    cos_array(big, big_out, 16);
+    for (int i = 0; i < 16; i++)
+    {
+        assert(SAME(big_out[i], cos(big[i])) || (i == 7 && big_out[i] != big_out[i]));
+    }
+    float out2[COUNT];
+    sincos_array(in, out, out2, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], sin(in[i])) && SAME(out2[i], cos(in[i])));
+    }
+    atan_array(in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], atan(in[i])));
+    }
+    atan2_array(in, in2, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], atan2(in[i], in2[i])));
+    }
+    exp_array(in2, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], exp(in2[i])));
+    }
+    log_array(in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], log(in[i])));
+    }
+    pow_array(in, in2, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], pow(in[i], in2[i])));
+    }
+    sqrt_array(in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], sqrt(in[i])));
+    }
+
+    // In-place use.
+    memcpy(out, in, sizeof(out));
+    asin_array(out, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], asin(in[i])));
+    }
+    memcpy(out, in, sizeof(out));
+    sincos_array(out, out, out2, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], sin(in[i])) && SAME(out2[i], cos(in[i])));
+    }
+
+    PASS();
+}
+
+void test_reductions(void) 
+{
+    TEST("Reductions (sum, min/max, dot, bounds)");
+
+    enum { COUNT = 5000 }; // Several 1024-element blocks plus a tail.
+    static float a[COUNT], b[COUNT];
+    static zvec3 pts[COUNT];
+    static float px[COUNT], py[COUNT], pz[COUNT];
+
+    // Small integers sum exactly in any order.
+    double sum = 0.0, sq = 0.0, dot = 0.0;
+    for (int i = 0; i < COUNT; i++) 
+    {
+        a[i] = (float)((i * 37) % 101) - 50.0f;
+        b[i] = (float)(i % 7) - 3.0f;
+        sum += a[i];
+        sq += (double)a[i] * a[i];
+        dot += (double)a[i] * b[i];
+    }
+    assert(sum_array(a, COUNT) == (float)sum && sum_kahan_array(a, COUNT) == (float)sum);
+    assert(sum_sq_array(a, COUNT) == (float)sq && dot_array(a, b, COUNT) == (float)dot);
+    assert(abs(len_array(a, COUNT) - sqrt((float)sq)) <= 1e-3f);
+    assert(sum_array(a, 0) == 0.0f && sum_array(a, 3) == a[0] + a[1] + a[2]);
+
+    // 0.1 does not sum exactly; a single accumulator drifts by about 1e-3
+    // relative over 2^20 terms.
+    enum { BIG = 1 << 20 };
+    static float tenth[BIG];
+    for (int i = 0; i < BIG; i++)
+    {
+        tenth[i] = 0.1f;
+    }
+    double exact = (double)0.1f * (double)BIG;
+    assert(abs((float)(sum_kahan_array(tenth, BIG) / exact) - 1.0f) <= 1.2e-7f);
+    assert(abs((float)(sum_array(tenth, BIG) / exact) - 1.0f) <= 1e-6f);
+
+    // Extremes, ties and NaNs.
+    a[4321] = -1000.0f;
+    a[17] = 1000.0f;
+    a[4000] = 1000.0f;
+    a[99] = ZMATH_NAN;
+    assert(min_array(a, COUNT) == -1000.0f && max_array(a, COUNT) == 1000.0f);
+    assert(argmin_array(a, COUNT) == 4321 && argmax_array(a, COUNT) == 17);
+    assert(argmax_array(a + 18, COUNT - 18) == 4000 - 18);
+    float nans[3] = { ZMATH_NAN, ZMATH_NAN, ZMATH_NAN };
+    assert(min_array(nans, 3) == ZMATH_INFINITY && max_array(a, 0) == -ZMATH_INFINITY);
+    assert(argmin_array(nans, 3) == 0 && argmax_array(a, 0) == 0);
+
+    for (int i = 0; i < COUNT; i++) 
+    {
+        pts[i].x = px[i] = (float)((i * 13) % 211) - 100.0f;
+        pts[i].y = py[i] = (float)((i * 29) % 307) - 7.0f;
+        pts[i].z = pz[i] = (float)(i % 50) * 0.5f;
+    }
+    pts[COUNT - 1].y = py[COUNT - 1] = 1000.0f;
+    zaabb box = v3_bounds(pts, COUNT);
+    assert(box.lo.x == -100.0f && box.lo.y == -7.0f && box.lo.z == 0.0f);
+    assert(box.hi.x == 110.0f && box.hi.y == 1000.0f && box.hi.z == 24.5f);
+    vec3_soa soa = { px, py, pz, COUNT };
+    zaabb box2 = v3_soa_bounds(soa);
+    assert(memcmp(&box, &box2, sizeof(box)) == 0);
+    box = v3_bounds(pts, 1);
+    assert(box.lo.x == pts[0].x && box.hi.z == pts[0].z);
+    box = v3_bounds(pts, 0);
+    assert(box.lo.x == ZMATH_INFINITY && box.hi.x == -ZMATH_INFINITY);
+    box = v3_bounds(NULL, 0);
+    assert(box.lo.z == ZMATH_INFINITY && box.hi.z == -ZMATH_INFINITY);
+
+    PASS();
+}
+
+void test_interpolation_batches(void) 
+{
+    TEST("Interpolation Batches (lerp, remap, smooth)");
+
+    enum { COUNT = 203 };
+    float in[COUNT], b[COUNT], out[COUNT];
+    for (int i = 0; i < COUNT; i++) 
+    {
+        in[i] = -3.0f + 10.0f * (float)i / (float)(COUNT - 1);
+        b[i] = (float)(i % 11) - 5.0f;
+    }
+
+    // lerp and clamp match the scalar calls bit for bit.
+    lerp_array(in, b, 0.3f, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], lerp(in[i], b[i], 0.3f)));
+    }
+    clamp_array(-1.0f, 2.0f, in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(SAME(out[i], clamp(in[i], -1.0f, 2.0f)));
+    }
+    float nan_in = ZMATH_NAN;
+    clamp_array(-1.0f, 2.0f, &nan_in, out, 1);
+    assert(zmath_isnan(out[0]) && zmath_isnan(clamp(nan_in, -1.0f, 2.0f)));
+    assert(clamp(5.0f, -1.0f, 2.0f) == 2.0f && clamp(-5.0f, -1.0f, 2.0f) == -1.0f);
+
+    // The hoisted reciprocals stay within a few ulps of t.
+    inv_lerp_array(-2.0f, 5.0f, in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(abs(out[i] - inv_lerp(-2.0f, 5.0f, in[i])) <= T_ULPS);
+    }
+    remap_array(-2.0f, 5.0f, 10.0f, 30.0f, in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(abs(out[i] - remap(-2.0f, 5.0f, 10.0f, 30.0f, in[i])) <= 20.0f * T_ULPS);
+    }
+    float ends[2] = { -2.0f, 5.0f };
+    remap_array(-2.0f, 5.0f, 10.0f, 30.0f, ends, ends, 2);
+    assert(ends[0] == 10.0f && ends[1] == 30.0f);
+    smoothstep_array(-1.0f, 4.0f, in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(abs(out[i] - smoothstep(-1.0f, 4.0f, in[i])) <= T_ULPS);
+    }
+    smootherstep_array(-1.0f, 4.0f, in, out, COUNT);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(abs(out[i] - smootherstep(-1.0f, 4.0f, in[i])) <= T_ULPS);
+    }
+    assert(out[0] == 0.0f && out[COUNT - 1] == 1.0f);
+
+    // Vector forms, in place.
+    vec2 p2[3] = { {0.0f, 1.0f}, {2.0f, 3.0f}, {4.0f, 5.0f} }, q2[3] = { {4.0f, 5.0f}, {2.0f, 1.0f}, {0.0f, 1.0f} };
+    v2_lerp_array(p2, q2, 0.25f, p2, 3);
+    assert(p2[0].x == 1.0f && p2[0].y == 2.0f && p2[1].y == 2.5f && p2[2].x == 3.0f);
+    vec3 p3[2] = { {0.0f, 0.0f, 0.0f}, {8.0f, 4.0f, 2.0f} }, q3[2] = { {4.0f, 8.0f, -4.0f}, {0.0f, 0.0f, 0.0f} };
+    vec3 r3[2];
+    v3_lerp_array(p3, q3, 0.5f, r3, 2);
+    assert(r3[0].y == 4.0f && r3[0].z == -2.0f && r3[1].x == 4.0f && r3[1].z == 1.0f);
+    v2_lerp_array(NULL, NULL, 0.5f, NULL, 0);
+    v3_lerp_array(NULL, NULL, 0.5f, NULL, 0);
+    float ax[2] = { 0.0f, 8.0f }, ay[2] = { 0.0f, 4.0f }, az[2] = { 0.0f, 2.0f };
+    float bx[2] = { 4.0f, 0.0f }, by[2] = { 8.0f, 0.0f }, bz[2] = { -4.0f, 0.0f };
+    vec3_soa sa = { ax, ay, az, 2 }, sb = { bx, by, bz, 2 };
+    v3_soa_lerp(sa, sb, 0.5f, sa);
+    assert(ay[0] == r3[0].y && az[0] == r3[0].z && ax[1] == r3[1].x && az[1] == r3[1].z);
+
+    PASS();
+}
+
+void test_vector_streams(void) 
+{
+    TEST("Vec3 SoA Streams");
+
+    enum { COUNT = 150 }; // Crosses the internal 64-element blocks.
+    static zvec3 aos[COUNT], back[COUNT];
+    static float ax[COUNT], ay[COUNT], az[COUNT];
+    static float bx[COUNT], by[COUNT], bz[COUNT];
+    static float dots[COUNT], lens[COUNT];
+    vec3_soa a = {ax, ay, az, COUNT};
+    vec3_soa b = {bx, by, bz, COUNT};
+
+    for (int i = 0; i < COUNT; i++) 
+    {
+        aos[i].x = (float)i;
+        aos[i].y = (float)(i % 7) - 3.0f;
+        aos[i].z = 0.5f * (float)(i % 5);
+        bx[i] = 1.0f;
+        by[i] = (float)(i % 3);
+        bz[i] = -2.0f;
+    }
+
+    // Transpose round trip.
+    v3_aos_to_soa(aos, a);
+    for (int i = 0; i < COUNT; i++)
+    {
+        assert(ax[i] == aos[i].x && ay[i] == aos[i].y && az[i] == aos[i].z);
+    }
+    v3_soa_to_aos(a, back);
+    assert(memcmp(aos, back, sizeof(aos)) == 0);
+
+    // Dot and cross against the scalar versions (cross runs in place).
+    v3_soa_dot(a, b, dots);
+    v3_soa_cross(a, b, a);
+    for (int i = 0; i < COUNT; i++) 
+    {
+        vec3 bi = {bx[i], by[i], bz[i]};
+        vec3 c = v3_cross(aos[i], bi);
+        assert(dots[i] == v3_dot(aos[i], bi));
+        assert(ax[i] == c.x && ay[i] == c.y && az[i] == c.z);
+    }
+
+    // Add, scale and normalize.
+    v3_aos_to_soa(aos, a);
+    v3_soa_add(a, b, a);
+    v3_soa_scale(a, 2.0f, a);
+    v3_soa_norm(a, a);
+    v3_soa_len(a, lens);
+    for (int i = 0; i < COUNT; i++) 
+    {
+        vec3 bi = {bx[i], by[i], bz[i]};
+        vec3 n = v3_norm(v3_scale(v3_add(aos[i], bi), 2.0f));
+        assert(is_near(ax[i], n.x, 1e-6f) && is_near(ay[i], n.y, 1e-6f) && is_near(az[i], n.z, 1e-6f));
+        assert(is_near(lens[i], 1.0f, 0.001f));
+    }
+
+    PASS();
+}
+
+void test_matrices(void) 
+{
+    TEST("Mat3/Mat4 Mul, Inverse, Transform");
+
+    // Column-major: the translation lives in m[12..14].
+    vec3 tv = {1.0f, 2.0f, 3.0f};
+    vec3 sv = {2.0f, 4.0f, 0.5f};
+    vec3 flat = {1.0f, 0.0f, 1.0f};
+    mat4 t = m4_translation(tv);
+    mat4 sc = m4_scaling(sv);
+    assert(t.m[12] == 1.0f && t.m[13] == 2.0f && t.m[14] == 3.0f);
+    assert(((uintptr_t)&t % 16) == 0 && sizeof(mat4) == 64);
+
+    // mul(a, b) applies b first.
+    vec3 p = {1.0f, 1.0f, 1.0f};
+    vec3 q = m4_transform_point(m4_mul(t, sc), p);
+    assert(q.x == 3.0f && q.y == 6.0f && q.z == 3.5f);
+    vec3 d = m4_transform_dir(m4_mul(t, sc), p);
+    assert(d.x == 2.0f && d.y == 4.0f && d.z == 0.5f);
+
+    // A general matrix times its inverse is the identity.
+    mat4 g = {{ 2.0f, 1.0f, 0.0f, 0.5f,  -1.0f, 3.0f, 1.0f, 0.0f,
+                0.0f, 2.0f, 1.0f, 1.0f,   0.5f, 0.0f, 4.0f, 2.0f }};
+    mat4 gi = m4_mul(g, m4_inverse(g));
+    mat4 id = m4_identity();
+    for (int i = 0; i < 16; i++)
+    {
+        assert(is_near(gi.m[i], id.m[i], 1e-5f));
+    }
+
+    // The affine inverse agrees with the general one and undoes the transform.
+    mat4 a = m4_mul(t, m4_mul(g, sc));
+    a.m[3] = a.m[7] = a.m[11] = 0.0f;
+    a.m[15] = 1.0f;
+    mat4 ai = m4_inverse_affine(a);
+    mat4 ag = m4_inverse(a);
+    for (int i = 0; i < 16; i++)
+    {
+        assert(is_near(ai.m[i], ag.m[i], 1e-5f));
+    }
+    vec3 back = m4_transform_point(ai, m4_transform_point(a, p));
+    assert(is_near(back.x, 1.0f, 1e-5f) && is_near(back.y, 1.0f, 1e-5f) && is_near(back.z, 1.0f, 1e-5f));
+
+    // Singular matrices invert to zeros; transposes round trip.
+    mat4 z = m4_inverse(m4_scaling(flat));
+    for (int i = 0; i < 16; i++)
+    {
+        assert(z.m[i] == 0.0f);
+    }
+    mat4 gt = m4_transpose(g);
+    assert(gt.m[1] == g.m[4] && gt.m[4] == g.m[1]);
+    gt = m4_transpose(gt);
+    assert(memcmp(gt.m, g.m, sizeof(g.m)) == 0);
+
+    // Mat3.
+    mat3 g3 = m3_from_m4(g);
+    mat3 g3i = m3_mul(m3_inverse(g3), g3);
+    mat3 id3 = m3_identity();
+    for (int i = 0; i < 9; i++)
+    {
+        assert(is_near(g3i.m[i], id3.m[i], 1e-5f));
+    }
+    vec3 r3 = m3_mul_v3(m3_transpose(g3), p);
+    vec3 r4 = m4_transform_dir(m4_transpose(g), p);
+    assert(r3.x == r4.x && r3.y == r4.y && r3.z == r4.z);
+
+    // Batch transforms match the single calls, in place and through streams.
+    enum { COUNT = 37 };
+    static zvec3 pts[COUNT], out[COUNT], dirs[COUNT];
+    static float sx[COUNT], sy[COUNT], sz[COUNT];
+    vec3_soa soa = {sx, sy, sz, COUNT};
+    for (int i = 0; i < COUNT; i++) 
+    {
+        pts[i].x = (float)i * 0.25f;
+        pts[i].y = (float)(i % 5) - 2.0f;
+        pts[i].z = 1.0f / (float)(i + 1);
+    }
+    v3_aos_to_soa(pts, soa);
+    m4_transform_points(&a, pts, out, COUNT);
+    m4_transform_dirs(&a, pts, dirs, COUNT);
+    m4_transform_points_soa(&a, soa, soa);
+    for (int i = 0; i < COUNT; i++) 
+    {
+        vec3 e = m4_transform_point(a, pts[i]);
+        vec3 f = m4_transform_dir(a, pts[i]);
+        assert(SAME(out[i].x, e.x) && SAME(out[i].y, e.y) && SAME(out[i].z, e.z));
+        assert(SAME(dirs[i].x, f.x) && SAME(dirs[i].y, f.y) && SAME(dirs[i].z, f.z));
+        assert(SAME(sx[i], e.x) && SAME(sy[i], e.y) && SAME(sz[i], e.z));
+    }
+    m4_transform_points(&a, pts, pts, COUNT);
+    assert(memcmp(pts, out, sizeof(out)) == 0);
+
+    // Directions ignore the translation, down to the sign of zero.
+    vec3 shift = {5.0f, -5.0f, 5.0f};
+    mat4 tm = m4_translation(shift);
+    vec3 nz[4], nz_out[4];
+    for (int i = 0; i < 4; i++)
+    {
+        nz[i].x = nz[i].y = nz[i].z = -0.0f;
+    }
+    m4_transform_dirs(&tm, nz, nz_out, 4);
+    vec3 nz_one = m4_transform_dir(tm, nz[0]);
+    assert(1.0f / nz_one.x < 0.0f && 1.0f / nz_one.z < 0.0f);
+    for (int i = 0; i < 4; i++)
+    {
+        assert(memcmp(&nz_out[i], &nz_one, sizeof(nz_one)) == 0);
+    }
+
+    PASS();
+}
+
+void test_quaternions(void) 
+{
+    TEST("Quat Mul, Rotate, Nlerp, Slerp");
+
+    vec3 up = {0.0f, 0.0f, 1.0f};
+    vec3 side = {1.0f, 0.0f, 0.0f};
+    vec3 x = {1.0f, 0.0f, 0.0f};
+    quat a = q_norm(q_from_axis_angle(up, ZMATH_HALF_PI));
+    quat b = q_norm(q_from_axis_angle(side, ZMATH_HALF_PI));
+
+    // Normalization inherits the invsqrt tier.
+#if ZMATH_ACCURACY == ZMATH_ACCURACY_FAST
+    const float tol = 2e-2f;
+#else
+    const float tol = 1e-4f;
+#endif
+
+    // 90 degrees about z takes x to y, and agrees with the matrix form.
+    vec3 r = q_rotate(a, x);
+    assert(is_near(r.x, 0.0f, tol) && is_near(r.y, 1.0f, tol) && is_near(r.z, 0.0f, tol));
+    vec3 p = {0.3f, -1.2f, 2.0f};
+    vec3 rq = q_rotate(q_mul(a, b), p);
+    vec3 rm = m4_transform_dir(m4_mul(q_to_m4(a), q_to_m4(b)), p);
+    vec3 rs = q_rotate(a, q_rotate(b, p));
+    assert(is_near(rq.x, rm.x, tol) && is_near(rq.y, rm.y, tol) && is_near(rq.z, rm.z, tol));
+    assert(is_near(rq.x, rs.x, tol) && is_near(rq.y, rs.y, tol) && is_near(rq.z, rs.z, tol));
+
+    // Conjugate undoes, normalize hits unit length.
+    quat ab = q_mul(a, b);
+    quat e = q_mul(ab, q_conj(ab));
+    assert(is_near(e.w, 1.0f, tol) && is_near(e.x, 0.0f, tol));
+    quat big = {1.0f, 2.0f, 3.0f, 4.0f};
+    assert(is_near(q_dot(q_norm(big), q_norm(big)), 1.0f, tol));
+
+    // Slerp tracks the true angle; nlerp only agrees at the ends and middle.
+    // The far-hemisphere copy takes the same short arc.
+    quat id = q_identity();
+    quat far = {-a.x, -a.y, -a.z, -a.w};
+    for (int i = 0; i <= 16; i++) 
+    {
+        float t = (float)i / 16.0f;
+        vec3 v = q_rotate(q_slerp(id, a, t), x);
+        vec3 w = q_rotate(q_slerp(id, far, t), x);
+        float angle = t * ZMATH_HALF_PI;
+        assert(is_near(v.x, cos_precise(angle), 1e-3f + tol) && is_near(v.y, sin_precise(angle), 1e-3f + tol));
+        assert(is_near(w.x, v.x, 1e-6f) && is_near(w.y, v.y, 1e-6f));
+    }
+    quat half = q_nlerp(id, a, 0.5f);
+    quat sh = q_slerp(id, a, 0.5f);
+    assert(is_near(half.z, sh.z, 1e-6f) && is_near(half.w, sh.w, 1e-6f));
+
+    // Pose batches match the single calls; blending two poses equals nlerp.
+    enum { JOINTS = 19 };
+    static quat pa[JOINTS], pb[JOINTS], out[JOINTS], blend[JOINTS];
+    for (int i = 0; i < JOINTS; i++) 
+    {
+        vec3 axis = v3_norm(v3_add(up, v3_scale(side, (float)i * 0.1f)));
+        pa[i] = q_from_axis_angle(axis, (float)i * 0.3f);
+        pb[i] = q_from_axis_angle(side, 3.0f - (float)i * 0.4f);
+    }
+    q_slerp_array(pa, pb, 0.3f, out, JOINTS);
+    for (int i = 0; i < JOINTS; i++) 
+    {
+        quat s = q_slerp(pa[i], pb[i], 0.3f);
+        assert(SAME(out[i].x, s.x) && SAME(out[i].y, s.y) && SAME(out[i].z, s.z) && SAME(out[i].w, s.w));
+    }
+    const quat* poses[2] = { pa, pb };
+    const float weights[2] = { 0.75f, 0.25f };
+    q_blend_poses(poses, weights, 2, blend, JOINTS);
+    q_nlerp_array(pa, pb, 0.25f, out, JOINTS);
+    for (int i = 0; i < JOINTS; i++) 
+    {
+        assert(is_near(q_dot(blend[i], out[i]), 1.0f, tol));
+    }
+
+    PASS();
+}
+
+void test_geometry(void) 
+{
+    TEST("Geometry (planes, boxes, rays, cull)");
+
+    plane pl = plane_from_point_normal((vec3){0.0f, 0.0f, 5.0f}, (vec3){0.0f, 0.0f, 2.0f});
+    assert(is_near(pl.n.z, 1.0f, 1e-5f) && is_near(pl.d, -5.0f, 1e-4f));
+    assert(is_near(plane_dist(pl, (vec3){3.0f, 1.0f, 7.0f}), 2.0f, 1e-4f));
+
+    aabb unit = { {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f} };
+    aabb far_box = { {2.0f, 0.0f, 0.0f}, {3.0f, 1.0f, 1.0f} };
+    aabb touching = { {1.0f, 1.0f, 1.0f}, {2.0f, 2.0f, 2.0f} };
+    assert(aabb_contains(unit, (vec3){0.5f, 1.0f, 0.0f}) && !aabb_contains(unit, (vec3){0.5f, 1.5f, 0.0f}));
+    assert(aabb_overlap(unit, touching) && !aabb_overlap(unit, far_box));
+    assert(sphere_aabb_overlap((sphere){ {1.5f, 0.5f, 0.5f}, 0.6f }, unit));
+    assert(!sphere_aabb_overlap((sphere){ {2.0f, 2.0f, 0.5f}, 1.0f }, unit));
+
+    // Slab rays, including axis-parallel directions and an inside origin.
+    float t = -1.0f;
+    assert(ray_aabb((ray){ {-5.0f, 0.5f, 0.5f}, {2.0f, 0.0f, 0.0f} }, unit, &t) && t == 2.5f);
+    assert(ray_aabb((ray){ {0.5f, 0.5f, 0.5f}, {0.0f, 1.0f, 0.0f} }, unit, &t) && t == 0.0f);
+    assert(!ray_aabb((ray){ {-5.0f, 2.0f, 0.5f}, {1.0f, 0.0f, 0.0f} }, unit, &t));
+    assert(!ray_aabb((ray){ {-5.0f, 0.5f, 0.5f}, {-1.0f, 0.0f, 0.0f} }, unit, &t));
+    assert(ray_aabb((ray){ {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f} }, unit, &t) && t == 1.0f);
+    sphere ball = { {0.0f, 0.0f, 0.0f}, 1.0f };
+    assert(ray_sphere((ray){ {0.0f, 0.0f, -10.0f}, {0.0f, 0.0f, 2.0f} }, ball, &t) && is_near(t, 4.5f, 1e-4f));
+    assert(ray_sphere((ray){ {0.0f, 0.5f, 0.0f}, {1.0f, 0.0f, 0.0f} }, ball, &t) && t == 0.0f);
+    assert(!ray_sphere((ray){ {0.0f, 0.0f, -10.0f}, {0.0f, 0.0f, -1.0f} }, ball, &t));
+    assert(!ray_sphere((ray){ {0.0f, 2.0f, -10.0f}, {0.0f, 0.0f, 1.0f} }, ball, &t));
+
+    // Identity clip space is the [-1, 1] cube, or z in [0, 1].
+    plane fr[6];
+    frustum_from_m4(m4_identity(), false, fr);
+    assert(is_near(fr[0].n.x, 1.0f, 1e-4f) && is_near(fr[0].d, 1.0f, 1e-4f));
+    assert(is_near(fr[5].n.z, -1.0f, 1e-4f) && is_near(fr[5].d, 1.0f, 1e-4f));
+    assert(frustum_sphere(fr, (sphere){ {1.5f, 0.0f, 0.0f}, 0.6f }));
+    assert(!frustum_sphere(fr, (sphere){ {3.0f, 0.0f, 0.0f}, 1.0f }));
+    frustum_from_m4(m4_identity(), true, fr);
+    assert(is_near(fr[4].n.z, 1.0f, 1e-4f) && fr[4].d == 0.0f);
+    assert(!frustum_aabb(fr, (aabb){ {0.0f, 0.0f, -2.0f}, {0.5f, 0.5f, -0.1f} }));
+
+    // 90 degree GL perspective looking down -z, near 1, far 100.
+    mat4 proj = {{ 1.0f, 0.0f, 0.0f, 0.0f,   0.0f, 1.0f, 0.0f, 0.0f,
+                   0.0f, 0.0f, -101.0f / 99.0f, -1.0f,   0.0f, 0.0f, -200.0f / 99.0f, 0.0f }};
+    frustum_from_m4(proj, false, fr);
+    assert(is_near(fr[4].d, -1.0f, 1e-4f) && is_near(fr[5].d, 100.0f, 1e-2f));
+    assert(frustum_sphere(fr, (sphere){ {0.0f, 0.0f, -50.0f}, 0.1f }));
+    assert(!frustum_sphere(fr, (sphere){ {0.0f, 0.0f, 50.0f}, 1.0f }));
+    assert(!frustum_sphere(fr, (sphere){ {60.0f, 0.0f, -50.0f}, 1.0f }));
+    assert(!frustum_sphere(fr, (sphere){ {0.0f, 0.0f, -0.5f}, 0.2f }));
+    assert(frustum_aabb(fr, (aabb){ {-1.0f, -1.0f, -0.9f}, {1.0f, 1.0f, -0.5f} }) == false);
+    assert(frustum_aabb(fr, (aabb){ {49.0f, -1.0f, -52.0f}, {52.0f, 1.0f, -50.0f} }));
+
+    // Batches match the scalar tests bit for bit, 32 objects per word.
+    enum { N = 77 };
+    float cx[N], cy[N], cz[N], rad[N], hx[N], hy[N], hz[N];
+    uint32_t mask[3], idx[N];
+    rng g = rng_seed(18);
+    for (int i = 0; i < N; i++)
+    {
+        cx[i] = rng_range(&g, -80.0f, 80.0f);
+        cy[i] = rng_range(&g, -80.0f, 80.0f);
+        cz[i] = rng_range(&g, -120.0f, 20.0f);
+        rad[i] = rng_range(&g, 0.1f, 10.0f);
+        hx[i] = cx[i] + rad[i];
+        hy[i] = cy[i] + 0.5f * rad[i];
+        hz[i] = cz[i] + 2.0f * rad[i];
+    }
+    vec3_soa centers = { cx, cy, cz, N };
+    vec3_soa maxs = { hx, hy, hz, N };
+
+    frustum_cull_spheres(fr, centers, rad, mask);
+    size_t visible = 0;
+    for (int i = 0; i < N; i++)
+    {
+        bool b = frustum_sphere(fr, (sphere){ {cx[i], cy[i], cz[i]}, rad[i] });
+        assert(((mask[i / 32] >> (i % 32)) & 1u) == (uint32_t)b);
+        visible += b;
+    }
+    assert((mask[2] >> (N - 64)) == 0 && visible > 5 && visible < N - 5);
+    assert(mask_compact(mask, N, idx) == visible);
+    for (size_t k = 0; k < visible; k++)
+    {
+        assert((mask[idx[k] / 32] >> (idx[k] % 32)) & 1u);
+        assert(k == 0 || idx[k] > idx[k - 1]);
+    }
+
+    frustum_cull_aabbs(fr, centers, maxs, mask);
+    for (int i = 0; i < N; i++)
+    {
+        aabb b = { {cx[i], cy[i], cz[i]}, {hx[i], hy[i], hz[i]} };
+        assert(((mask[i / 32] >> (i % 32)) & 1u) == (uint32_t)frustum_aabb(fr, b));
+    }
+
+    ray pick = { {0.0f, 0.0f, 0.0f}, {0.3f, -0.2f, -1.0f} };
+    ray_aabb_soa(pick, 90.0f, centers, maxs, mask);
+    for (int i = 0; i < N; i++)
+    {
+        aabb b = { {cx[i], cy[i], cz[i]}, {hx[i], hy[i], hz[i]} };
+        bool hit = ray_aabb(pick, b, &t) && t <= 90.0f;
+        assert(((mask[i / 32] >> (i % 32)) & 1u) == (uint32_t)hit);
+    }
+
+    PASS();
+}
+
+void test_rng(void) 
+{
+    TEST("Random Numbers (xoshiro128++)");
+
+    // Reference outputs of xoshiro128++ from state {1, 2, 3, 4}.
+    zrng r = { { 1, 2, 3, 4 } };
+    assert(rng_u32(&r) == 0x00000281u);
+    assert(rng_u32(&r) == 0x00180387u);
+    zrng j = { { 1, 2, 3, 4 } };
+    rng_jump(&j);
+    assert(rng_u32(&j) == 0xBA8C0DDCu);
+
+    // Seeding is deterministic; split hands out the state, then jumps.
+    zrng a = rng_seed(42), b = rng_seed(42);
+    assert(rng_u32(&a) == rng_u32(&b));
+    zrng base = rng_seed(7);
+    zrng w0 = rng_split(&base);
+    zrng w1 = rng_split(&base);
+    zrng check = rng_seed(7);
+    assert(rng_u32(&w0) == rng_u32(&check));
+    check = rng_seed(7);
+    rng_jump(&check);
+    assert(rng_u32(&w1) == rng_u32(&check));
+
+    // Uniform fills match the scalar draws and stay in [lo, hi).
+    float u[257];
+    zrng f = rng_seed(3), g = rng_seed(3);
+    rng_fill_uniform(&f, -2.0f, 3.0f, u, 257);
+    for (int i = 0; i < 257; i++)
+    {
+        assert(u[i] == rng_range(&g, -2.0f, 3.0f));
+        assert(u[i] >= -2.0f && u[i] < 3.0f);
+    }
+    zrng h = rng_seed(5);
+    for (int i = 0; i < 1000; i++)
+    {
+        float x = rng_float(&h);
+        assert(x >= 0.0f && x < 1.0f);
+    }
+
+    // Normal fills have the requested moments (odd n covers the tail).
+    static float nrm[20001];
+    zrng nr = rng_seed(11);
+    rng_fill_normal(&nr, 1.0f, 2.0f, nrm, 20001);
+    double mean = 0.0, var = 0.0;
+    for (int i = 0; i < 20001; i++)
+    {
+        mean += nrm[i];
+    }
+    mean /= 20001.0;
+    for (int i = 0; i < 20001; i++)
+    {
+        var += (nrm[i] - mean) * (nrm[i] - mean);
+    }
+    var /= 20001.0;
+    assert(mean > 0.95 && mean < 1.05);
+    assert(var > 3.8 && var < 4.2);
+
+    // Unit vectors have unit length and no preferred direction.
+    zvec3 dirs[2000];
+    zrng vr = rng_seed(13);
+    rng_fill_unit_vec3(&vr, dirs, 2000);
+    zvec3 sum = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 2000; i++)
+    {
+        assert(is_near(v3_len(dirs[i]), 1.0f, 2e-3f));
+        sum = v3_add(sum, dirs[i]);
+    }
+    assert(v3_len(sum) < 150.0f);
+
+    PASS();
+}
+
+typedef float (*noise2_fn)(float, float, uint32_t);
+typedef float (*noise3_fn)(float, float, float, uint32_t);
+
+void test_noise(void) 
+{
+    TEST("Noise (value, Perlin, simplex)");
+
+    // Gradient noise vanishes on the lattice, including negative cells.
+    for (int i = -3; i <= 3; i++)
+    {
+        assert(noise_perlin2((float)i, (float)(2 * i), 7u) == 0.0f);
+        assert(noise_perlin3((float)i, 1.0f, (float)-i, 7u) == 0.0f);
+    }
+
+    const noise2_fn f2[3] = { noise_value2, noise_perlin2, noise_simplex2 };
+    const noise3_fn f3[3] = { noise_value3, noise_perlin3, noise_simplex3 };
+    const int kinds[3] = { ZMATH_NOISE_VALUE, ZMATH_NOISE_PERLIN, ZMATH_NOISE_SIMPLEX };
+    for (int k = 0; k < 3; k++)
+    {
+        // Bounded, centred, continuous (also across x = 0) and seeded.
+        float sum = 0.0f, sq = 0.0f;
+        int diff = 0;
+        for (int i = 0; i < 4096; i++)
+        {
+            float x = (float)(i % 64) * 0.173f - 5.0f;
+            float y = (float)(i / 64) * 0.131f - 4.0f;
+            float z = (float)(i % 7) * 0.29f;
+            float a = f2[k](x, y, 3u), b = f3[k](x, y, z, 3u);
+            assert(abs(a) <= 1.05f && abs(b) <= 1.05f);
+            assert(abs(f2[k](x + 1e-3f, y, 3u) - a) < 0.02f);
+            assert(abs(f3[k](x, y, z + 1e-3f, 3u) - b) < 0.02f);
+            sum += a + b;
+            sq += a * a + b * b;
+            diff += f2[k](x, y, 4u) != a;
+        }
+        assert(abs(sum / 8192.0f) < 0.05f && sq / 8192.0f > 0.01f && diff > 4000);
+        assert(abs(f2[k](1e-4f, 0.3f, 1u) - f2[k](-1e-4f, 0.3f, 1u)) < 1e-3f);
+
+        // Batches equal the scalar calls.
+        float xs[37], ys[37], zs[37], out[37], grid[9 * 5];
+        for (int i = 0; i < 37; i++)
+        {
+            xs[i] = (float)i * 0.37f - 6.0f;
+            ys[i] = (float)(i * i % 11) * 0.5f - 2.0f;
+            zs[i] = (float)i * -0.21f;
+        }
+        noise2_array(kinds[k], 9u, xs, ys, out, 37);
+        for (int i = 0; i < 37; i++)
+        {
+            assert(SAME(out[i], f2[k](xs[i], ys[i], 9u)));
+        }
+        zvec3_soa p = { xs, ys, zs, 37 };
+        noise3_array(kinds[k], 9u, p, out);
+        for (int i = 0; i < 37; i++)
+        {
+            assert(SAME(out[i], f3[k](xs[i], ys[i], zs[i], 9u)));
+        }
+        noise2_grid(kinds[k], 9u, -1.5f, 2.25f, 0.3f, grid, 9, 5);
+        for (int j = 0; j < 5; j++)
+        {
+            for (int i = 0; i < 9; i++)
+            {
+                float e = f2[k](-1.5f + (float)i * 0.3f, 2.25f + (float)j * 0.3f, 9u);
+                assert(SAME(grid[j * 9 + i], e));
+            }
+        }
+    }
+
+    PASS();
+}
+
+void test_packing(void) 
+{
+    TEST("Half floats, snorm and unorm");
+
+    // Exact values, overflow, and ties to even in both ranges.
+    assert(f32_to_f16(1.0f) == 0x3C00 && f32_to_f16(-2.0f) == 0xC000 && f32_to_f16(-0.0f) == 0x8000);
+    assert(f32_to_f16(0.1f) == 0x2E66 && f32_to_f16(65504.0f) == 0x7BFF);
+    assert(f32_to_f16(65519.0f) == 0x7BFF && f32_to_f16(65520.0f) == 0x7C00);
+    assert(f32_to_f16(1e10f) == 0x7C00 && f32_to_f16(-ZMATH_INFINITY) == 0xFC00);
+    assert(f32_to_f16(1.0f + 0.00048828125f) == 0x3C00 && f32_to_f16(1.0f + 0.0014648438f) == 0x3C02);
+    assert(f32_to_f16(5.9604645e-08f) == 0x0001 && f32_to_f16(2.9802322e-08f) == 0x0000);
+    assert(f32_to_f16(8.940697e-08f) == 0x0002 && f32_to_f16(6.097555e-05f) == 0x03FF);
+    assert(f32_to_f16(6.1005354e-05f) == 0x0400 && f32_to_f16(1e-30f) == 0x0000);
+    assert((f32_to_f16(ZMATH_NAN) & 0x7E00) == 0x7E00);
+    float tiny = 5.9604645e-08f, min_n = -6.1035156e-05f;
+    assert(f16_to_f32(0x0001) == tiny && f16_to_f32(0x8400) == min_n);
+    assert(f16_to_f32(0x7C00) == ZMATH_INFINITY && isnan(f16_to_f32(0x7C01)));
+
+    // Every half survives the round trip; NaNs come back quieted.
+    for (uint32_t h = 0; h < 65536; h++)
+    {
+        uint16_t back = f32_to_f16(f16_to_f32((uint16_t)h));
+        bool is_nan = (h & 0x7C00) == 0x7C00 && (h & 0x3FF);
+        assert(back == (is_nan ? (h | 0x200) : h));
+    }
+
+    // Within half an f16 ulp, and the hardware paths give the scalar bits.
+    enum { N = 1003 };
+    float in[N], back[N];
+    uint16_t h16[N];
+    rng g = rng_seed(19);
+    for (int i = 0; i < N; i++)
+    {
+        in[i] = rng_range(&g, -1.0f, 1.0f) * exp2(rng_range(&g, -30.0f, 18.0f));
+    }
+    in[0] = ZMATH_NAN;
+    in[1] = ZMATH_INFINITY;
+    in[2] = 9.536743e-07f;
+    f32_to_f16_array(in, h16, N);
+    f16_to_f32_array(h16, back, N);
+    for (int i = 0; i < N; i++)
+    {
+        assert(h16[i] == f32_to_f16(in[i]));
+        assert(i < 2 || isnan(back[i]) == isnan(in[i]));
+        float m = abs(in[i]);
+        if (i >= 2 && m <= 65504.0f)
+        {
+            float ulp = (m < 6.1035156e-05f) ? 5.9604645e-08f : exp2(floor(log2(m)) - 10.0f);
+            assert(abs(back[i] - in[i]) <= 0.5f * ulp * 1.0001f);
+        }
+    }
+    assert(isnan(back[0]) && back[1] == ZMATH_INFINITY);
+
+    // Clamping, NaN to 0, round to nearest even, and -1 at both ends.
+    assert(f32_to_snorm16(1.0f) == 32767 && f32_to_snorm16(-3.0f) == -32767 && f32_to_snorm16(ZMATH_NAN) == 0);
+    assert(f32_to_unorm8(0.5f) == 128 && f32_to_unorm8(2.5f / 255.0f) == 2 && f32_to_unorm8(-0.2f) == 0);
+    assert(f32_to_unorm8(ZMATH_NAN) == 0 && f32_to_unorm8(7.0f) == 255 && f32_to_unorm16(1.0f) == 65535);
+    assert(f32_to_snorm8(-1.0f) == -127 && f32_to_snorm8(0.5f) == 64);
+    assert(snorm16_to_f32(-32768) == -1.0f && snorm16_to_f32(-32767) == -1.0f && snorm8_to_f32(-128) == -1.0f);
+    float fifth = 0.2f, u51 = unorm8_to_f32(51);
+    assert(unorm8_to_f32(255) == 1.0f && u51 == fifth && unorm16_to_f32(0) == 0.0f);
+    for (int v = -32767; v <= 32767; v++)
+    {
+        assert(f32_to_snorm16(snorm16_to_f32((int16_t)v)) == v);
+        assert(f32_to_unorm16(unorm16_to_f32((uint16_t)(v + 32767))) == v + 32767);
+    }
+    for (int v = 0; v < 256; v++)
+    {
+        assert(f32_to_unorm8(unorm8_to_f32((uint8_t)v)) == v);
+        assert(v == 0 || f32_to_snorm8(snorm8_to_f32((int8_t)(v - 128))) == v - 128);
+    }
+
+    int16_t s16[N];
+    uint16_t u16[N];
+    int8_t s8[N];
+    uint8_t u8[N];
+    float unpacked[N];
+    f32_to_snorm16_array(in, s16, N);
+    f32_to_unorm16_array(in, u16, N);
+    f32_to_snorm8_array(in, s8, N);
+    f32_to_unorm8_array(in, u8, N);
+    for (int i = 0; i < N; i++)
+    {
+        assert(s16[i] == f32_to_snorm16(in[i]) && u16[i] == f32_to_unorm16(in[i]));
+        assert(s8[i] == f32_to_snorm8(in[i]) && u8[i] == f32_to_unorm8(in[i]));
+    }
+    snorm16_to_f32_array(s16, unpacked, N);
+    for (int i = 0; i < N; i++)
+    {
+        assert(unpacked[i] == snorm16_to_f32(s16[i]));
+    }
+    unorm8_to_f32_array(u8, unpacked, N);
+    for (int i = 0; i < N; i++)
+    {
+        assert(unpacked[i] == unorm8_to_f32(u8[i]));
+    }
+
+    PASS();
+}
+
+void test_curves(void) 
+{
+    TEST("Polynomials, Bezier, Hermite, CR");
+
+    const float quad[3] = { 1.0f, 2.0f, 3.0f };
+    assert(poly(quad, 3, 2.0f) == 17.0f && poly_horner(quad, 3, 2.0f) == 17.0f);
+    assert(poly(quad, 0, 2.0f) == 0.0f && poly(quad, 1, ZMATH_INFINITY) == 1.0f);
+
+    // Taylor series of exp, 12 terms.
+    float taylor[12];
+    taylor[0] = 1.0f;
+    for (int i = 1; i < 12; i++)
+    {
+        taylor[i] = taylor[i - 1] / (float)i;
+    }
+    assert(is_near(poly(taylor, 12, 0.5f), 1.6487213f, 1e-6f));
+    assert(is_near(poly(taylor, 12, -1.0f), 0.36787944f, 1e-6f));
+
+    // Estrin and Horner agree to rounding for every block split.
+    rng g = rng_seed(20);
+    float c[21];
+    for (int i = 0; i < 21; i++)
+    {
+        c[i] = rng_range(&g, -1.0f, 1.0f);
+    }
+    for (size_t terms = 1; terms <= 21; terms++)
+    {
+        for (int k = 0; k < 16; k++)
+        {
+            float x = rng_range(&g, -1.2f, 1.2f);
+            float scale = 0.0f, xk = 1.0f;
+            for (size_t i = 0; i < terms; i++)
+            {
+                scale += abs(c[i]) * xk;
+                xk *= abs(x);
+            }
+            assert(is_near(poly(c, terms, x), poly_horner(c, terms, x), 1e-6f * scale));
+        }
+    }
+
+    // Arrays equal the scalar calls, with a partial element block and in place.
+    enum { N = 150 };
+    float xs[N], ys[N];
+    for (int i = 0; i < N; i++)
+    {
+        xs[i] = rng_range(&g, -1.5f, 1.5f);
+    }
+    poly_array(c, 13, xs, ys, N);
+    for (int i = 0; i < N; i++)
+    {
+        assert(SAME(ys[i], poly(c, 13, xs[i])));
+    }
+    memcpy(ys, xs, sizeof(xs));
+    poly_array(c, 5, ys, ys, N);
+    for (int i = 0; i < N; i++)
+    {
+        assert(SAME(ys[i], poly(c, 5, xs[i])));
+    }
+
+    // End points are exact, and the midpoints match the closed forms.
+    assert(bezier3(2.0f, 7.0f, -3.0f, 5.0f, 0.0f) == 2.0f && bezier3(2.0f, 7.0f, -3.0f, 5.0f, 1.0f) == 5.0f);
+    assert(is_near(bezier3(2.0f, 7.0f, -3.0f, 5.0f, 0.5f), (2.0f + 21.0f - 9.0f + 5.0f) / 8.0f, 1e-6f));
+    assert(hermite(2.0f, 4.0f, 5.0f, -1.0f, 0.0f) == 2.0f && hermite(2.0f, 4.0f, 5.0f, -1.0f, 1.0f) == 5.0f);
+    assert(is_near(hermite(2.0f, 4.0f, 5.0f, -1.0f, 0.5f), 3.5f + 0.125f * 5.0f, 1e-6f));
+    float slope = (hermite(2.0f, 4.0f, 5.0f, -1.0f, 1e-3f) - hermite(2.0f, 4.0f, 5.0f, -1.0f, 0.0f)) / 1e-3f;
+    assert(is_near(slope, 4.0f, 1e-2f));
+    assert(catmull_rom(1.0f, 2.0f, 6.0f, 3.0f, 0.0f) == 2.0f && catmull_rom(1.0f, 2.0f, 6.0f, 3.0f, 1.0f) == 6.0f);
+    assert(is_near(catmull_rom(1.0f, 2.0f, 6.0f, 3.0f, 0.5f), (-1.0f + 18.0f + 54.0f - 3.0f) / 16.0f, 1e-6f));
+    assert(is_near(catmull_rom(0.0f, 1.0f, 2.0f, 3.0f, 0.3f), 1.3f, 1e-6f));
+
+    vec3 a = {0.0f, 1.0f, 2.0f}, b = {1.0f, 0.0f, -1.0f}, d = {4.0f, 4.0f, 0.5f}, e = {-2.0f, 3.0f, 1.0f};
+    vec3 q = v3_bezier3(a, b, d, e, 0.3f);
+    assert(q.x == bezier3(a.x, b.x, d.x, e.x, 0.3f) && q.z == bezier3(a.z, b.z, d.z, e.z, 0.3f));
+    vec2 r = v2_catmull_rom((vec2){a.x, a.y}, (vec2){b.x, b.y}, (vec2){d.x, d.y}, (vec2){e.x, e.y}, 0.7f);
+    assert(SAME(r.y, catmull_rom(a.y, b.y, d.y, e.y, 0.7f)));
+    vec3 h = v3_hermite(a, b, d, e, 1.0f);
+    assert(h.x == d.x && h.y == d.y && h.z == d.z);
+
+    float ts[37], f1[37];
+    vec2 f2[37];
+    vec3 f3[37];
+    for (int i = 0; i < 37; i++)
+    {
+        ts[i] = (float)i / 36.0f;
+    }
+    const float p1[4] = { 2.0f, 7.0f, -3.0f, 5.0f };
+    const vec2 p2[4] = { {a.x, a.y}, {b.x, b.y}, {d.x, d.y}, {e.x, e.y} };
+    const vec3 p3[4] = { a, b, d, e };
+    for (int kind = ZMATH_CURVE_BEZIER; kind <= ZMATH_CURVE_CATMULL_ROM; kind++)
+    {
+        curve_array(kind, p1, ts, f1, 37);
+        v2_curve_array(kind, p2, ts, f2, 37);
+        v3_curve_array(kind, p3, ts, f3, 37);
+        for (int i = 0; i < 37; i++)
+        {
+            float s1 = (kind == ZMATH_CURVE_BEZIER) ? bezier3(p1[0], p1[1], p1[2], p1[3], ts[i])
+                     : (kind == ZMATH_CURVE_HERMITE) ? hermite(p1[0], p1[1], p1[2], p1[3], ts[i])
+                     : catmull_rom(p1[0], p1[1], p1[2], p1[3], ts[i]);
+            vec2 s2 = (kind == ZMATH_CURVE_BEZIER) ? v2_bezier3(p2[0], p2[1], p2[2], p2[3], ts[i])
+                    : (kind == ZMATH_CURVE_HERMITE) ? v2_hermite(p2[0], p2[1], p2[2], p2[3], ts[i])
+                    : v2_catmull_rom(p2[0], p2[1], p2[2], p2[3], ts[i]);
+            vec3 s3 = (kind == ZMATH_CURVE_BEZIER) ? v3_bezier3(a, b, d, e, ts[i])
+                    : (kind == ZMATH_CURVE_HERMITE) ? v3_hermite(a, b, d, e, ts[i])
+                    : v3_catmull_rom(a, b, d, e, ts[i]);
+            assert(SAME(f1[i], s1) && SAME(f2[i].x, s2.x) && SAME(f2[i].y, s2.y));
+            assert(SAME(f3[i].x, s3.x) && SAME(f3[i].y, s3.y) && SAME(f3[i].z, s3.z));
+        }
+        assert(f1[0] == p1[kind == ZMATH_CURVE_CATMULL_ROM ? 1 : 0]);
+        assert(f1[36] == p1[kind == ZMATH_CURVE_BEZIER ? 3 : 2]);
+    }
+
+    PASS();
+}
+
+// Reference DFT with exact angle reduction and double accumulation.
+static void naive_dft(const float* xr, const float* xi, double* yr, double* yi, size_t n)
+{
+    for (size_t k = 0; k < n; k++)
+    {
+        double sr = 0.0, si = 0.0;
+        for (size_t j = 0; j < n; j++)
+        {
+            float s, c;
+            sincos_precise(-TAU * (float)((j * k) % n) / (float)n, &s, &c);
+            sr += (double)xr[j] * c - (double)xi[j] * s;
+            si += (double)xr[j] * s + (double)xi[j] * c;
+        }
+        yr[k] = sr;
+        yi[k] = si;
+    }
+}
+
+void test_fft(void) 
+{
+    TEST("FFT (complex, real, inverse)");
+
+    enum { MAX = 1024 };
+    static float table[2 * MAX], re[MAX + 1], im[MAX + 1], xr[MAX], xi[MAX], back[MAX];
+    static double yr[MAX], yi[MAX];
+    fft_plan plan;
+    assert(!fft_init(&plan, 12, table) && !fft_init(&plan, 0, table) && !fft_real_init(&plan, 1, table));
+
+    rng g = rng_seed(21);
+    for (size_t n = 1; n <= MAX; n *= 2)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            xr[i] = rng_range(&g, -1.0f, 1.0f);
+            xi[i] = rng_range(&g, -1.0f, 1.0f);
+            re[i] = xr[i];
+            im[i] = xi[i];
+        }
+        naive_dft(xr, xi, yr, yi, n);
+        assert(fft_init(&plan, n, table));
+        fft(&plan, re, im);
+        // Rounding grows with log2(n) against a spectrum of size ~sqrt(n).
+        float tol = 4e-7f * (float)(sqrt((float)n) * (2.0f + log2((float)n)));
+        for (size_t k = 0; k < n; k++)
+        {
+            assert(abs((float)(re[k] - yr[k])) <= tol && abs((float)(im[k] - yi[k])) <= tol);
+        }
+        ifft(&plan, re, im);
+        for (size_t i = 0; i < n; i++)
+        {
+            assert(is_near(re[i], xr[i], 1e-5f) && is_near(im[i], xi[i], 1e-5f));
+        }
+
+        // The real transform gives bins 0 .. n / 2 of the complex one.
+        if (n < 2)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            xi[i] = 0.0f;
+        }
+        naive_dft(xr, xi, yr, yi, n);
+        assert(fft_real_init(&plan, n, table));
+        fft_real(&plan, xr, re, im);
+        for (size_t k = 0; k <= n / 2; k++)
+        {
+            assert(abs((float)(re[k] - yr[k])) <= tol && abs((float)(im[k] - yi[k])) <= tol);
+        }
+        assert(im[0] == 0.0f && im[n / 2] == 0.0f);
+        ifft_real(&plan, re, im, back);
+        for (size_t i = 0; i < n; i++)
+        {
+            assert(is_near(back[i], xr[i], 1e-5f));
+        }
+    }
+
+    // A pure tone lands in its bin: 2 cos(2 pi 5 t) over 64 samples.
+    assert(fft_real_init(&plan, 64, table));
+    for (int i = 0; i < 64; i++)
+    {
+        xr[i] = 2.0f * cos_precise(TAU * (float)((5 * i) % 64) / 64.0f);
+    }
+    fft_real(&plan, xr, re, im);
+    for (int k = 0; k <= 32; k++)
+    {
+        float power = re[k] * re[k] + im[k] * im[k];
+        assert(is_near(power, (k == 5) ? 4096.0f : 0.0f, 1e-2f));
+    }
+
+    PASS();
+}
+
+void test_angle_tables(void) 
+{
+    TEST("Angle Tables (sincos_table, v2_rotate_sc)");
+
+    enum { N = 4099 };
+    static float ts[N], tc[N];
+    const float starts[3] = { 0.0f, 0.25f, -3000.5f };
+    const float steps[3] = { 0.001f, 2.0f, -TAU / 4096.0f };
+    for (int r = 0; r < 3; r++)
+    {
+        sincos_table(starts[r], steps[r], ts, tc, N);
+        for (size_t k = 0; k < N; k++)
+        {
+            // The exact angle, reduced in double before it is rounded.
+            double a = (double)starts[r] + (double)k * (double)steps[r];
+            double q = a * 0.15915494309189533577;
+            double turns = (double)(long long)(q + (q < 0.0 ? -0.5 : 0.5));
+            float x = (float)(a - turns * 6.28318530717958647692);
+            float s, c;
+            sincos_precise(x, &s, &c);
+            assert(abs(ts[k] - s) <= 4e-7f && abs(tc[k] - c) <= 4e-7f);
+        }
+    }
+
+    // Every tail length, and nothing written past n.
+    for (size_t n = 0; n <= 17; n++)
+    {
+        for (size_t k = 0; k < 18; k++)
+        {
+            ts[k] = tc[k] = 7.0f;
+        }
+        sincos_table(1.0f, 0.5f, ts, tc, n);
+        for (size_t k = 0; k < n; k++)
+        {
+            float s, c;
+            sincos_precise(1.0f + 0.5f * (float)k, &s, &c);
+            assert(abs(ts[k] - s) <= 4e-7f && abs(tc[k] - c) <= 4e-7f);
+        }
+        assert(ts[n] == 7.0f && tc[n] == 7.0f);
+    }
+
+    // A quarter turn from the table rotates x onto y.
+    sincos_table(0.0f, ZMATH_HALF_PI, ts, tc, 4);
+    vec2 v = { 2.0f, 0.0f };
+    vec2 r1 = v2_rotate_sc(v, ts[1], tc[1]);
+    vec2 r2 = v2_rotate_sc(v, ts[2], tc[2]);
+    assert(is_near(r1.x, 0.0f, 1e-6f) && is_near(r1.y, 2.0f, 1e-6f));
+    assert(is_near(r2.x, -2.0f, 1e-6f) && is_near(r2.y, 0.0f, 1e-6f));
+
+    PASS();
+}
+
+// Relative error within a few double ulps.
+static bool near_d(double a, double b)
+{
+    double d = a - b;
+    double m = b < 0.0 ? -b : b;
+    return (d < 0.0 ? -d : d) <= 1e-15 * m;
+}
+
+void test_double_precision(void) 
+{
+    TEST("Double Precision (_d, vec3d)");
+
+    // Reduction stays exact at planet-scale coordinates.
+    const double xs[5] = { 1e6, 123456.789, -1.5e6, 0.5, 3.0 };
+    const double sins[5] = {
+        -0.34999350217129294, -0.99866408234322457, -0.51099871424626775,
+        0.47942553860420301, 0.14112000805986721
+    };
+    const double coss[5] = {
+        0.93675212753314474, 0.051672532718701383, -0.8595814760909295,
+        0.87758256189037276, -0.98999249660044542
+    };
+    double bs[5], bc[5], bs2[5];
+    sincos_d_array(xs, bs, bc, 5);
+    sin_d_array(xs, bs2, 5);
+    for (int i = 0; i < 5; i++)
+    {
+        double s, c;
+        sincos_d(xs[i], &s, &c);
+        assert(near_d(sin_d(xs[i]), sins[i]) && near_d(cos_d(xs[i]), coss[i]));
+        assert(s == sin_d(xs[i]) && c == cos_d(xs[i]));
+        assert(bs[i] == s && bc[i] == c && bs2[i] == s);
+    }
+    assert(sin_d(0.0) == 0.0 && cos_d(0.0) == 1.0);
+    assert(near_d(sin_d(3.141592653589793), 1.2246467991473532e-16));
+
+    assert(near_d(exp_d(1.0), 2.7182818284590451));
+    assert(near_d(exp_d(-700.0), 9.8596765437597708e-305));
+    assert(near_d(exp_d(700.0), 1.0142320547350045e+304));
+    assert(near_d(exp_d(1e-3), 1.0010005001667084) && exp_d(0.0) == 1.0);
+    assert(near_d(log_d(1e300), 690.77552789821368));
+    assert(near_d(log_d(2.0), 0.69314718055994529) && log_d(1.0) == 0.0);
+    assert(near_d(log_d(1.000001), 9.9999949991806676e-07));
+    assert(log_d(0.0) == -(double)ZMATH_INFINITY);
+#ifndef ZMATH_FAST_MATH
+    assert(near_d(log_d(1e-310), -713.80137882815416));
+    assert(exp_d(710.0) == (double)ZMATH_INFINITY && exp_d(-709.0) == 0.0);
+    assert(log_d((double)ZMATH_INFINITY) == (double)ZMATH_INFINITY);
+#endif
+
+    assert(near_d(sqrt_d(2.0), 1.4142135623730951) && sqrt_d(0.0) == 0.0);
+    assert(near_d(sqrt_d(4e12 + 1.0), 2000000.0000002501) && sqrt_d(-4.0) == 0.0);
+    assert(near_d(invsqrt_d(3e200), 5.7735026918962577e-101));
+    double in[3] = { 4.0, 1e-3, 700.0 }, out[3];
+    sqrt_d_array(in, out, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        assert(out[i] == sqrt_d(in[i]));
+    }
+    exp_d_array(in, out, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        assert(out[i] == exp_d(in[i]));
+    }
+    log_d_array(in, out, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        assert(out[i] == log_d(in[i]));
+    }
+
+    // Two points 6.4e6 apart a centimetre from each other: float would merge
+    // them, double keeps the offset.
+    vec3d a = { 6.4e6, 1.0e3, -2.5e5 };
+    vec3d b = v3d_add(a, (vec3d){ 0.01, 0.0, 0.0 });
+    double off = v3d_dist(a, b) - 0.01;
+    assert(off < 1e-8 && off > -1e-8);
+    vec3 rel = v3d_to_v3_rel(b, a);
+    assert(is_near(rel.x, 0.01f, 1e-9f) && rel.y == 0.0f && rel.z == 0.0f);
+    assert(v3d_sub(b, a).x == b.x - a.x && v3d_scale(a, 2.0).z == -5.0e5);
+
+    vec3d x = { 1.0, 0.0, 0.0 }, y = { 0.0, 1.0, 0.0 };
+    vec3d z = v3d_cross(x, y);
+    assert(z.x == 0.0 && z.y == 0.0 && z.z == 1.0 && v3d_dot(x, y) == 0.0);
+    vec3d n = v3d_norm((vec3d){ 3.0, 0.0, 4.0 });
+    assert(near_d(n.x, 0.6) && near_d(n.z, 0.8) && near_d(v3d_len(n), 1.0));
+    vec3d zero = { 0.0, 0.0, 0.0 };
+    assert(v3d_norm(zero).x == 0.0);
+    vec3d m = v3d_lerp(a, b, 0.5);
+    assert(near_d(m.x, 6.4e6 + 0.005));
+    vec3 f = v3d_to_v3(v3d_from_v3((vec3){ 1.5f, -2.0f, 3.25f }));
+    assert(f.x == 1.5f && f.y == -2.0f && f.z == 3.25f);
+
+    PASS();
+}
+
+// FNV-1a over the bytes of a Q16.16 value, least significant first.
+static uint32_t fix_hash(uint32_t h, fix v)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        h = (h ^ (((uint32_t)v >> (8 * i)) & 0xFFu)) * 16777619u;
+    }
+    return h;
+}
+
+void test_fixed_point(void) 
+{
+    TEST("Fixed Point (Q16.16)");
+
+    const fix one = ZMATH_FIX_ONE;
+    assert(fix_from_int(-3) == -3 * one && fix_to_int(fix_from_float(-2.25f)) == -3);
+    assert(fix_from_float(1.5f) == 98304 && fix_to_float(98304) == 1.5f);
+    assert(fix_from_float(1e10f) == INT32_MAX && fix_from_float(-1e10f) == INT32_MIN);
+    const float below_half = 0.49999997f / 65536.0f, half = 0.5f / 65536.0f;
+    assert(fix_from_float(below_half) == 0 && fix_from_float(-below_half) == 0);
+    assert(fix_from_float(half) == 1 && fix_from_float(-half) == -1);
+    assert(fix_mul(3 * one / 2, -2 * one) == -3 * one && fix_mul(1, one / 2) == 1);
+    assert(fix_div(one, 3 * one) == 21845 && fix_div(-2 * one, 4 * one) == -one / 2);
+    assert(fix_div(one, 0) == INT32_MAX && fix_div(-one, 0) == INT32_MIN);
+    // Halves round away from zero for every sign pair, negative divisors too.
+    assert(fix_div(-437801211, -22015) == 1303281406 && fix_div(437801211, -22015) == -1303281406);
+    assert(fix_div(one, -3 * one) == -21845 && fix_div(-one, -3 * one) == 21845);
+    assert(fix_div(3, -2 * one) == -2 && fix_div(-3, -2 * one) == 2 && fix_div(-3, 2 * one) == -2);
+    assert(fix_add(INT32_MAX, 1) == INT32_MIN && fix_lerp(0, 4 * one, one / 4) == one);
+    assert(fix_sqrt(4 * one) == 2 * one && fix_sqrt(2 * one) == 92682 && fix_sqrt(-one) == 0);
+
+    // Trig within 2^-16 of the true values.
+    assert(fix_sin(0) == 0 && fix_sin(ZMATH_FIX_HALF_PI) == one && fix_cos(0) == one);
+    assert(abs(fix_to_float(fix_cos(ZMATH_FIX_PI)) + 1.0f) <= 1.6e-5f);
+    assert(abs(fix_to_float(fix_sin(fix_from_float(-2.5f))) + 0.59847214f) <= 1.6e-5f);
+    assert(abs(fix_to_float(fix_atan2(one, one)) - 0.78539816f) <= 1.6e-5f);
+    assert(abs(fix_to_float(fix_atan2(-one, -one)) + 2.35619449f) <= 1.6e-5f);
+    assert(fix_atan2(0, -one) == ZMATH_FIX_PI && fix_atan2(0, 0) == 0);
+    assert(fix_atan2(one, 0) == ZMATH_FIX_HALF_PI && fix_atan2(-one, 0) == -ZMATH_FIX_HALF_PI);
+
+    vec3fx a = { 3 * one, 0, 4 * one }, b = { 0, one, 0 };
+    assert(v3fx_len(a) == 5 * one && v3fx_dot(a, b) == 0);
+    vec3fx n = v3fx_norm(a), c = v3fx_cross(a, b);
+    assert(n.x == fix_div(3 * one, 5 * one) && n.z == fix_div(4 * one, 5 * one));
+    assert(c.x == -4 * one && c.y == 0 && c.z == 3 * one);
+    vec2fx p = { one, one };
+    assert(v2fx_len(p) == fix_sqrt(2 * one) && v2fx_dot(p, v2fx_scale(p, 2 * one)) == 4 * one);
+    assert(v2fx_sub(v2fx_add(p, p), p).x == one && v2fx_norm(p).x == fix_div(one, 92682));
+
+    // Determinism: a fixed walk through every operation hashes to the same
+    // value on any target and with any compiler flags.
+    uint32_t h = 2166136261u, s = 12345u;
+    fix acc = one;
+    for (int i = 0; i < 4096; i++)
+    {
+        s = s * 1664525u + 1013904223u;
+        fix x = (fix)(s >> 8) - (1 << 23);
+        s = s * 1664525u + 1013904223u;
+        fix y = (fix)(s >> 8) - (1 << 23);
+        acc = fix_add(fix_mul(acc, fix_cos(x)), fix_div(fix_sin(y), 3 * one));
+        h = fix_hash(h, acc);
+        h = fix_hash(h, fix_atan2(y, x));
+        h = fix_hash(h, fix_sqrt(x < 0 ? -x : x));
+        h = fix_hash(h, fix_div(y, x));
+        vec3fx v = { x, y, acc };
+        vec3fx r = v3fx_norm(v3fx_cross(v, a));
+        h = fix_hash(h, r.x ^ r.y ^ r.z);
+        h = fix_hash(h, v3fx_len(v));
+    }
+    assert(h == 1334966721u);
+
+    PASS();
+}
+
+void test_arena(void) 
+{
+    TEST("Arena (aligned SoA, matrices, FFT)");
+
+    // Start the block off a cache line to check the address is aligned,
+    // not the offset.
+    static unsigned char block[8192 + 64];
+    arena a = arena_init(block + 3, 8192);
+    unsigned char* p = (unsigned char*)arena_alloc(&a, 5, 1);
+    assert(p == block + 3 && arena_mark(&a) == 5);
+    p = (unsigned char*)arena_alloc(&a, 8, 16);
+    assert(((uintptr_t)p & 15u) == 0 && p >= block + 8);
+
+    size_t frame = arena_mark(&a);
+    vec3_soa v;
+    assert(arena_v3_soa(&a, 100, &v) && v.count == 100);
+    assert(((uintptr_t)v.x & 63u) == 0 && ((uintptr_t)v.y & 63u) == 0 && ((uintptr_t)v.z & 63u) == 0);
+    assert(v.y - v.x == 112 && v.z - v.y == 112); // 100 floats padded to 7 cache lines.
+    for (size_t i = 0; i < v.count; i++)
+    {
+        v.x[i] = v.y[i] = v.z[i] = 1.0f;
+    }
+    v3_soa_norm(v, v);
+    mat4* m = arena_m4(&a, 3);
+    assert(m && ((uintptr_t)m & 63u) == 0);
+    m[2] = m4_identity();
+    mat3* m3 = arena_m3(&a, 2);
+    assert(m3 && ((uintptr_t)m3 & 63u) == 0 && (unsigned char*)m3 >= (unsigned char*)(m + 3));
+
+    // A plan from the arena transforms like one over a caller table.
+    fft_plan plan;
+    assert(arena_fft_plan(&a, &plan, 64) && ((uintptr_t)plan.tw & 63u) == 0);
+    float* re = arena_floats(&a, 64);
+    float* im = arena_floats(&a, 64);
+    assert(re && im);
+    for (int i = 0; i < 64; i++) { re[i] = (i == 1) ? 1.0f : 0.0f; im[i] = 0.0f; }
+    fft(&plan, re, im);
+    assert(abs(re[0] - 1.0f) < 1e-6f && abs(re[16]) < 1e-6f && abs(im[16] + 1.0f) < 1e-6f);
+    size_t before = arena_mark(&a);
+    assert(!arena_fft_plan(&a, &plan, 48) && arena_mark(&a) == before);
+    assert(arena_fft_real_plan(&a, &plan, 32));
+
+    // Running out leaves the arena unchanged; rewinding frees everything
+    // after the mark.
+    before = arena_mark(&a);
+    assert(arena_floats(&a, 100000) == NULL && arena_mark(&a) == before);
+    assert(!arena_v3_soa(&a, 1000, &v) && arena_mark(&a) == before);
+    assert(arena_alloc(&a, (size_t)-1, 64) == NULL && arena_m4(&a, (size_t)-1 / 8) == NULL);
+    arena_reset(&a, frame);
+    assert(arena_mark(&a) == frame);
+    assert(arena_v3_soa(&a, 600, &v));
+    arena_reset(&a, 0);
+    assert(arena_mark(&a) == 0 && arena_alloc(&a, 8192, 1) == block + 3 && arena_alloc(&a, 1, 1) == NULL);
+
+    arena empty = arena_init(NULL, 100);
+    assert(arena_alloc(&empty, 1, 1) == NULL);
+
+    PASS();
+}
+
+#ifdef ZMATH_PARALLEL
+// Runs the jobs backwards on the calling thread and records how many came.
+static void test_reverse_dispatch(void* user, zmath_job_fn job, void* ctx, size_t count)
+{
+    *(size_t*)user = count;
+    for (size_t i = count; i > 0; i--)
+    {
+        job(ctx, i - 1);
+    }
+}
+
+static void test_fill_index(void* ctx, size_t begin, size_t end)
+{
+    float* out = (float*)ctx;
+    for (size_t i = begin; i < end; i++)
+    {
+        out[i] = (float)i;
+    }
+}
+
+void test_parallel(void) 
+{
+    TEST("Parallel Dispatch (ZMATH_PARALLEL)");
+
+    enum { N = 100003 };
+    static float in[N], in2[N], ref[N], out[N];
+    static zvec3 pts[N], pts_ref[N], pts_out[N];
+    zrng r = rng_seed(21);
+    rng_fill_uniform(&r, -50.0f, 50.0f, in, N);
+    rng_fill_uniform(&r, 0.1f, 4.0f, in2, N);
+    for (int i = 0; i < N; i++)
+    {
+        pts[i].x = in[i];
+        pts[i].y = in2[i];
+        pts[i].z = -in[i];
+    }
+
+    // The pool gives the same bits as one single-threaded call.
+    zmath_pool* pool = pool_create(4);
+    assert(pool != NULL);
+    zmath_parallel par = pool_parallel(pool);
+    par.chunk = 1000;
+    sin_array(in, ref, N);
+    parallel_unary(&par, zmath_sin_array, in, out, N);
+    assert(memcmp(ref, out, sizeof(ref)) == 0);
+    pow_array(in2, in2, ref, N);
+    parallel_binary(&par, zmath_pow_array, in2, in2, out, N);
+    assert(memcmp(ref, out, sizeof(ref)) == 0);
+    zmat4 m = m4_mul(m4_translation(pts[1]), m4_scaling(pts[2]));
+    m4_transform_points(&m, pts, pts_ref, N);
+    parallel_transform_points(&par, &m, pts, pts_out, N);
+    assert(memcmp(pts_ref, pts_out, sizeof(pts_ref)) == 0);
+
+    // In place, with a chunk that is not a multiple of 8 and many dispatches,
+    // against the same steps run single-threaded.
+    memcpy(out, in, sizeof(in));
+    memcpy(ref, in, sizeof(in));
+    par.chunk = 777;
+    for (int k = 0; k < 50; k++)
+    {
+        parallel_unary(&par, zmath_sin_array, out, out, 4096);
+        sin_array(ref, ref, 4096);
+    }
+    assert(memcmp(ref, out, sizeof(ref)) == 0);
+    pool_destroy(pool);
+
+    // Chunks are rounded up to multiples of 8, and order does not matter.
+    size_t jobs = 0;
+    zmath_parallel custom = { test_reverse_dispatch, &jobs, 1001 };
+    parallel_for(&custom, N, test_fill_index, out);
+    assert(jobs == (N + 1007) / 1008);
+    for (int i = 0; i < N; i++)
+    {
+        assert(out[i] == (float)i);
+    }
+
+    // Chunks past n, up to SIZE_MAX, give one job run in place instead of
+    // rounding up to 0.
+    const size_t whole[3] = { SIZE_MAX, SIZE_MAX - 3, (size_t)N + 1 };
+    for (int k = 0; k < 3; k++)
+    {
+        jobs = 0;
+        memset(out, 0, sizeof(out));
+        custom.chunk = whole[k];
+        parallel_for(&custom, N, test_fill_index, out);
+        assert(jobs == 0 && out[0] == 0.0f && out[N - 1] == (float)(N - 1));
+    }
+
+    // A zeroed dispatcher runs serially.
+    zmath_parallel serial = { NULL, NULL, 0 };
+    parallel_unary(&serial, zmath_sqrt_array, in2, out, N);
+    sqrt_array(in2, ref, N);
+    assert(memcmp(ref, out, sizeof(ref)) == 0);
+
+    PASS();
+}
+#endif
+
+#ifdef ZMATH_PROFILE
+void test_profile(void) 
+{
+    TEST("Profiling Counters (ZMATH_PROFILE)");
+
+    enum { COUNT = 300 };
+    float in[COUNT], out[COUNT];
+    for (int i = 0; i < COUNT; i++)
+    {
+        in[i] = (float)i * 0.01f;
+    }
+
+    profile_reset();
+    zmath_profile p;
+    profile_snapshot(&p);
+    for (int i = 0; i < ZMATH_PROF_COUNT; i++)
+    {
+        assert(p.c[i].calls == 0 && p.c[i].elems == 0);
+    }
+
+    sin_array(in, out, COUNT);
+    sin_array(in, out, 10);
+    exp_array(in, out, COUNT);
+    float s = sum_array(in, COUNT);
+    (void)s;
+    float ax[4] = {0}, ay[4] = {0}, az[4] = {0};
+    vec3_soa v = { ax, ay, az, 4 };
+    v3_soa_lerp(v, v, 0.5f, v);
+    profile_snapshot(&p);
+    assert(p.c[ZMATH_PROF_SIN_ARRAY].calls == 2 && p.c[ZMATH_PROF_SIN_ARRAY].elems == COUNT + 10);
+    assert(p.c[ZMATH_PROF_EXP_ARRAY].calls == 1 && p.c[ZMATH_PROF_SUM_ARRAY].elems == COUNT);
+    // Composite kernels count once, not through the kernels they share
+    // loops with.
+    assert(p.c[ZMATH_PROF_V3_SOA_LERP].calls == 1 && p.c[ZMATH_PROF_LERP_ARRAY].calls == 0);
+    assert(p.c[ZMATH_PROF_COS_ARRAY].calls == 0);
+#ifndef ZMATH_PROFILE_TIMING
+    assert(p.c[ZMATH_PROF_SIN_ARRAY].ticks == 0);
+#endif
+
+    assert(strcmp(profile_name(ZMATH_PROF_SIN_ARRAY), "zmath_sin_array") == 0);
+    assert(strcmp(profile_name(ZMATH_PROF_LOG_D_ARRAY), "zmath_log_d_array") == 0);
+    assert(strcmp(profile_name(ZMATH_PROF_COUNT), "") == 0);
+
+    profile_reset();
+    profile_snapshot(&p);
+    assert(p.c[ZMATH_PROF_SIN_ARRAY].calls == 0 && p.c[ZMATH_PROF_SIN_ARRAY].ticks == 0);
+
+    PASS();
+}
+#endif
+
+void test_inline_mode(void) 
+{
+    TEST("Inline / Constexpr Mode");
+
+#if ZMATH_HAS_CONSTEXPR
+    // Under C++20 the scalar core folds at compile time.
+    constexpr float s = zmath_sin(0.5f);
+    static_assert(s > 0.479f && s < 0.480f, "constexpr sin");
+    static_assert(zmath_abs(-2.0f) == 2.0f, "constexpr abs");
+    static_assert(zmath_floor(-1.5f) == -2.0f, "constexpr floor");
+    constexpr zvec3 ex = {1.0f, 0.0f, 0.0f};
+    constexpr zvec3 ey = {0.0f, 1.0f, 0.0f};
+    static_assert(zmath_v3_cross(ex, ey).z == 1.0f, "constexpr cross");
+    constexpr zvec3 t = {1.0f, 2.0f, 3.0f};
+    constexpr zmat4 m = zmath_m4_inverse(zmath_m4_translation(t));
+    static_assert(m.m[12] == -1.0f && m.m[14] == -3.0f, "constexpr inverse");
+    constexpr zvec3 pts[3] = { {1.0f, -2.0f, 3.0f}, {-4.0f, 5.0f, 0.0f}, {2.0f, 2.0f, -6.0f} };
+    constexpr zaabb box = zmath_v3_bounds(pts, 3);
+    static_assert(box.lo.x == -4.0f && box.lo.z == -6.0f && box.hi.y == 5.0f, "constexpr bounds");
+#endif
+
+    // The same calls behave identically when evaluated at run time.
+    volatile float x = 0.5f;
+    assert(is_near(zmath_sin(x), 0.4794255f, 1e-3f));
+#if ZMATH_HAS_CONSTEXPR
+    assert(is_near(zmath_sin(x), s, 1e-6f));
+#endif
+    zvec3 tr = {1.0f, 2.0f, 3.0f};
+    zmat4 r = m4_inverse(m4_translation(tr));
+    assert(r.m[12] == -1.0f && r.m[13] == -2.0f && r.m[14] == -3.0f);
+
+    PASS();
+}
+
+#ifdef __cplusplus
+void test_cpp_layer(void) 
+{
+    TEST("C++ Expression Layer (zm::vec)");
+
+    // Fused expressions give the same lanes as the chained C calls.
+    zm::vec3 a(1.0f, 2.0f, 3.0f), b(4.0f, 5.0f, 6.0f), c(0.5f, 0.5f, 0.5f);
+    zm::vec3 r = a * 2.0f + (b - c);
+    zvec3 ref = v3_add(v3_scale(a, 2.0f), v3_sub(b, c));
+    assert(r.x == ref.x && r.y == ref.y && r.z == ref.z);
+    r -= a;
+    r *= 2.0f;
+    assert(r.x == 9.0f && r.y == 13.0f && r.z == 17.0f);
+    r = -r / 2.0f + r;
+    assert(r.x == 4.5f && r.z == 8.5f);
+
+    // The wrapper is the C struct: it passes by value and aliases arrays.
+    assert(zm::dot(a, b) == 32.0f && v3_dot(a, b) == 32.0f);
+    zm::vec3 n = zm::cross(a - c, b);
+    zvec3 nc = v3_cross(v3_sub(a, c), b);
+    assert(n.x == nc.x && n.y == nc.y && n.z == nc.z);
+    assert(is_near(zm::length(zm::normalize(a + b)), 1.0f, 1e-3f));
+    zm::vec2 p(3.0f, 4.0f);
+    assert(zm::length(p * 2.0f) == v2_len(v2_scale(p, 2.0f)));
+    zvec3 arr[2] = { {1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f} };
+    zm::vec3* view = reinterpret_cast<zm::vec3*>(arr);
+    view[1] += view[0];
+    assert(arr[1].x == 5.0f && arr[1].z == 9.0f);
+
+    // Stream expressions run one pass per component, broadcasting vectors.
+    float px[37], py[37], pz[37], vx[37], vy[37], vz[37];
+    for (int i = 0; i < 37; i++)
+    {
+        px[i] = (float)i; py[i] = (float)(2 * i); pz[i] = -(float)i;
+        vx[i] = 1.0f; vy[i] = (float)(i % 5); vz[i] = 0.25f * (float)i;
+    }
+    zm::vec3_soa pos(px, py, pz, 37), vel(vx, vy, vz, 37);
+    zm::vec3 g(0.0f, -1.0f, 0.0f);
+    pos += vel * 0.5f + g;
+    for (int i = 0; i < 37; i++)
+    {
+        assert(px[i] == (float)i + 0.5f);
+        assert(py[i] == (float)(2 * i) + 0.5f * (float)(i % 5) - 1.0f);
+        assert(pz[i] == -(float)i + 0.125f * (float)i);
+    }
+    vel = pos;
+    assert(vx[36] == px[36] && vel.x == vx);
+
+    PASS();
+}
+#endif
+
+#ifdef ZMATH_SIMD
+void test_simd_lanes(void) 
+{
+    TEST("SIMD Lanes (zvec4f)");
+
+    float in[4] = {-7.5f, -0.5f, 0.49f, 3.7f};
+    float out[4];
+    zvec4f v = zmath_v4f_load(in);
+
+    zmath_v4f_store(out, zmath_v4f_floor(v));
+    for (int i = 0; i < 4; i++)
+    {
+        assert(out[i] == floor(in[i]));
+    }
+    zmath_v4f_store(out, zmath_v4f_round(v));
+    for (int i = 0; i < 4; i++)
+    {
+        assert(out[i] == round(in[i]));
+    }
+
+    // Halfway lanes round to even like the scalar kernel, -ffast-math too.
+    const float halves[8] = { -2.5f, -1.5f, -0.5f, 0.5f, 1.5f, 2.5f, 3.5f, -3.5f };
+    for (int j = 0; j < 8; j += 4)
+    {
+        zmath_v4f_store(out, zmath__v4f_rint(zmath_v4f_load(halves + j)));
+        for (int i = 0; i < 4; i++)
+        {
+            assert(out[i] == zmath__rint_k(halves[j + i]));
+        }
+    }
+#ifdef ZMATH_SIMD_AVX2
+    float out8[8];
+    zmath_v8f_store(out8, zmath__v8f_rint(zmath_v8f_load(halves)));
+    for (int i = 0; i < 8; i++)
+    {
+        assert(out8[i] == zmath__rint_k(halves[i]));
+    }
+#endif
+#if ZMATH_ACCURACY == ZMATH_ACCURACY_DEFAULT
+    // The lanes implement the default accuracy tier.
+    zmath_v4f_store(out, zmath_v4f_sin(v));
+    for (int i = 0; i < 4; i++)
+    {
+        assert(SAME(out[i], sin(in[i])));
+    }
+    zmath_v4f_store(out, zmath_v4f_cos(v));
+    for (int i = 0; i < 4; i++)
+    {
+        assert(SAME(out[i], cos(in[i])));
+    }
+    zvec4f vs, vc;
+    zmath_v4f_sincos(v, &vs, &vc);
+    float out2[4];
+    zmath_v4f_store(out, vs);
+    zmath_v4f_store(out2, vc);
+    for (int i = 0; i < 4; i++)
+    {
+        assert(SAME(out[i], sin(in[i])) && SAME(out2[i], cos(in[i])));
+    }
+    zmath_v4f_store(out, zmath_v4f_exp(v));
+    for (int i = 0; i < 4; i++)
+    {
+        assert(SAME(out[i], exp(in[i])));
+    }
+    zmath_v4f_store(out, zmath_v4f_log(zmath_v4f_set1(10.0f)));
+    assert(SAME(out[0], log(10.0f)));
+    zmath_v4f_store(out, zmath_v4f_invsqrt(zmath_v4f_set1(4.0f)));
+    assert(out[3] == invsqrt(4.0f));
+#endif
+
+    // Arithmetic.
+    zvec4f w = zmath_v4f_madd(v, zmath_v4f_set1(2.0f), zmath_v4f_set1(1.0f));
+    zmath_v4f_store(out, w);
+    assert(out[0] == -14.0f && out[3] == 8.4f);
+
+    PASS();
+}
+#endif
+
 int main(void) 
 {
     printf("=> Running tests (zmath.h, main).\n");
@@ -123,6 +2140,42 @@ int main(void)
     test_interpolation();
     test_trigonometry();
     test_vectors();
+    test_accuracy_tiers();
+    test_exp2_log2_pow();
+    test_special_values();
+    test_rcp_rsqrt();
+#ifdef ZMATH_TRIG_LUT
+    test_trig_lut();
+#endif
+    test_batch_kernels();
+    test_vector_streams();
+    test_reductions();
+    test_interpolation_batches();
+    test_matrices();
+    test_quaternions();
+    test_geometry();
+    test_rng();
+    test_noise();
+    test_packing();
+    test_curves();
+    test_fft();
+    test_angle_tables();
+    test_double_precision();
+    test_fixed_point();
+    test_arena();
+#ifdef ZMATH_PARALLEL
+    test_parallel();
+#endif
+#ifdef ZMATH_PROFILE
+    test_profile();
+#endif
+    test_inline_mode();
+#ifdef __cplusplus
+    test_cpp_layer();
+#endif
+#ifdef ZMATH_SIMD
+    test_simd_lanes();
+#endif
 
     printf("=> All tests passed successfully.\n");
     return 0;
@@ -7,7 +7,9 @@
  * • Zero standard library dependencies (No <math.h> needed).
  * • Scalar math (clamp, lerp, smoothstep).
  * • Fast approximate trigonometry (polynomial).
- * • Vector math (vec2, vec3).
+ * • Vector math (vec2, vec3) and matrices (mat3, mat4).
+ * • Branch-free batch kernels over float arrays.
+ * • Optional SIMD lanes (SSE2, AVX2+FMA, NEON) behind ZMATH_SIMD.
  *
  * License: MIT
  * Author: Zuhaitz
@@ -19,8 +21,82 @@
 #define ZMATH_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 
+// SIMD backend selection (opt-in with ZMATH_SIMD).
+// Picks the widest instruction set the compiler targets. Define one of
+// ZMATH_SIMD_AVX2, ZMATH_SIMD_SSE2, ZMATH_SIMD_NEON or ZMATH_SIMD_SCALAR
+// yourself to force a backend.
+#ifdef ZMATH_SIMD
+#   if !defined(ZMATH_SIMD_AVX2) && !defined(ZMATH_SIMD_SSE2) && \
+       !defined(ZMATH_SIMD_NEON) && !defined(ZMATH_SIMD_SCALAR)
+#       if defined(__AVX2__) && defined(__FMA__)
+#           define ZMATH_SIMD_AVX2
+#       elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#           define ZMATH_SIMD_SSE2
+#       elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#           define ZMATH_SIMD_NEON
+#       else
+#           define ZMATH_SIMD_SCALAR
+#       endif
+#   endif
+#   if defined(ZMATH_SIMD_AVX2)
+#       include <immintrin.h>
+#       define ZMATH_SIMD_WIDTH 8
+#   elif defined(ZMATH_SIMD_SSE2)
+#       include <emmintrin.h>
+#       define ZMATH_SIMD_WIDTH 4
+#   elif defined(ZMATH_SIMD_NEON)
+#       include <arm_neon.h>
+#       define ZMATH_SIMD_WIDTH 4
+#   else
+#       include <string.h>
+#       define ZMATH_SIMD_WIDTH 4
+#   endif
+#endif
+
+// Hardware reciprocal estimates (opt-in with ZMATH_USE_HW_RSQRT).
+// Seeds invsqrt from rsqrtss on x86 or vrsqrte on ARM instead of the
+// integer bit trick, then refines with Newton steps. On ARM rcp likewise
+// starts from vrecpe; on x86 it stays a division, as fast as rcpss plus a
+// Newton step and exact. The estimate tables are implementation defined
+// (Intel and AMD differ), so results are no longer bit-identical across
+// CPUs. Other targets ignore it.
+#ifdef ZMATH_USE_HW_RSQRT
+#   if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#       include <xmmintrin.h>
+#       define ZMATH__HW_RSQRT_SSE
+#   elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#       include <arm_neon.h>
+#       define ZMATH__HW_RSQRT_NEON
+#   endif
+#endif
+
+// Half-float conversion instructions.
+// The bulk f16 conversions use F16C on x86 (-mf16c, implied by
+// -march=haswell) and fcvt on AArch64 whenever the compiler targets them.
+// Both round exactly like the portable code, so only the speed changes.
+#if defined(__F16C__)
+#   include <immintrin.h>
+#   define ZMATH__F16C
+#elif defined(__aarch64__)
+#   include <arm_neon.h>
+#   define ZMATH__F16_NEON
+#endif
+
+// Denormal control.
+// zmath_ftz_begin sets flush-to-zero and denormals-are-zero through MXCSR on
+// x86 with SSE and FZ in FPCR on AArch64. Other targets leave the state
+// alone, and the calls do nothing. MXCSR does not apply to x87 arithmetic
+// (-mfpmath=387), which keeps its subnormals.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#   include <xmmintrin.h>
+#   define ZMATH__FTZ_SSE
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#   define ZMATH__FTZ_ARM64
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -35,22 +111,256 @@ extern "C" {
 #define ZMATH_EPSILON   1.19209290e-7f
 #define ZMATH_SQRT2     1.41421356237f
 
-#define ZMATH_INFINITY  (1e30f * 1e30f)
+// 1e30f * 1e30f is only infinite once rounded to float, which x87 code does
+// not do inside an expression.
+#if defined(__GNUC__) || defined(__clang__)
+#   define ZMATH_INFINITY  __builtin_inff()
+#else
+#   define ZMATH_INFINITY  (1e30f * 1e30f)
+#endif
 #define ZMATH_NAN       (ZMATH_INFINITY * 0.0f)
 
+// Floats at or above this magnitude (2^23) have no fractional part.
+#define ZMATH_NO_FRACT_LIMIT 8388608.0f
+
+// 1.5 * 2^23. For |x| < 2^22, x + ZMATH__RINT_MAGIC holds round(x) in its low
+// mantissa bits (biased by 2^22), so the integer can be read off the bits.
+#define ZMATH__RINT_MAGIC 12582912.0f
+
+// Cody-Waite split of 2pi. P1 and P2 have 8 significant bits, so q * P1 and
+// q * P2 are exact for turn counts below 2^16 (|x| < ~4.1e5).
+#define ZMATH__TAU_P1 6.28125f
+#define ZMATH__TAU_P2 1.9378662109375e-3f
+#define ZMATH__TAU_P3 -2.55903137258428614587e-6f
+
+// From this magnitude (2^18, safely below those 2^16 turns) the radian
+// kernels reduce through zmath__turns_frac_k instead.
+#define ZMATH__TAU_BIG 262144.0f
+
+// The smallest normal float, and the natural logs of it and of FLT_MAX:
+// exp(x) is normal and finite for x in [ZMATH__EXP_LO, ZMATH__EXP_HI).
+#define ZMATH__FLT_MIN 1.17549435e-38f
+#define ZMATH__EXP_LO  (-87.33654475f)
+#define ZMATH__EXP_HI  88.72283905f
+
+// Polynomial coefficients, shared by the scalar and SIMD kernels.
+// Odd minimax sine on [-pi/2, pi/2]: x * (1 + x^2 * (C0 + x^2 * (C1 + ...))).
+#define ZMATH_SIN_C0 -0.1666666664f
+#define ZMATH_SIN_C1  0.0083333315f
+#define ZMATH_SIN_C2 -0.0001984090f
+#define ZMATH_SIN_C3  0.0000027526f
+
+// Odd minimax arctangent on [0, 1]: x * (C0 + x^2 * (C1 + ...)).
+#define ZMATH_ATAN_C0  0.99997726f
+#define ZMATH_ATAN_C1 -0.33262347f
+#define ZMATH_ATAN_C2  0.19354346f
+#define ZMATH_ATAN_C3 -0.11643287f
+#define ZMATH_ATAN_C4  0.05265332f
+#define ZMATH_ATAN_C5 -0.01172120f
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#   define ZMATH_ALIGN(n) alignas(n)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#   define ZMATH_ALIGN(n) _Alignas(n)
+#elif defined(_MSC_VER)
+#   define ZMATH_ALIGN(n) __declspec(align(n))
+#else
+#   define ZMATH_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
 // Types.
 
 typedef struct { float x, y; } zvec2;
 typedef struct { float x, y, z; } zvec3;
 
+// 3D vector in double, for coordinates too large for float.
+typedef struct { double x, y, z; } zvec3d;
+
+// Q16.16 fixed-point number and vectors (see "Fixed point").
+typedef int32_t zfix;
+typedef struct { zfix x, y; } zvec2fx;
+typedef struct { zfix x, y, z; } zvec3fx;
+
+// Structure-of-arrays view over `count` 3D vectors. Does not own its memory.
+typedef struct { float* x; float* y; float* z; size_t count; } zvec3_soa;
+
+// Column-major matrices: element (row r, column c) is m[c * N + r], so each
+// column is contiguous and a zmat4 column loads straight into a zvec4f.
+typedef struct { ZMATH_ALIGN(16) float m[9]; } zmat3;
+typedef struct { ZMATH_ALIGN(16) float m[16]; } zmat4;
+
+// Rotation quaternion x*i + y*j + z*k + w.
+typedef struct { float x, y, z, w; } zquat;
+
+// Geometry. A plane keeps the points with dot(n, p) + d >= 0. A ray's
+// points are origin + t * dir for t >= 0; dir need not be unit length.
+typedef struct { zvec3 lo, hi; } zaabb;
+typedef struct { zvec3 center; float radius; } zsphere;
+typedef struct { zvec3 origin, dir; } zray;
+typedef struct { zvec3 n; float d; } zplane;
+
+// xoshiro128++ generator state. Not thread-safe: give each thread its own.
+typedef struct { uint32_t s[4]; } zrng;
+
+// FFT plan: a power-of-two length and its twiddles, which live in a caller
+// buffer of 2 * n floats. Does not own its memory.
+typedef struct { size_t n; const float* tw; } zfft_plan;
+
+// Bump allocator over a caller-supplied block. Does not own its memory.
+typedef struct { unsigned char* base; size_t size; size_t used; } zarena;
+
+// Floating-point control state saved by zmath_ftz_begin.
+typedef struct { uint64_t reg; } zfp_state;
+
 // API declarations.
 
-#ifdef ZMATH_STATIC
+// ZMATH_INLINE compiles the implementation into every file that includes
+// the header, with each function static and force-inlined, so hot calls
+// inline across translation units without LTO. In C++20 it also makes the
+// functions constexpr (ZMATH_HAS_CONSTEXPR is then 1): bit casts go through
+// __builtin_bit_cast, and SIMD paths only run outside constant evaluation.
+#if defined(ZMATH_INLINE) && defined(__cplusplus) && __cplusplus >= 202002L
+#   if defined(__has_builtin)
+#       if __has_builtin(__builtin_bit_cast) && __has_builtin(__builtin_is_constant_evaluated)
+#           define ZMATH_HAS_CONSTEXPR 1
+#       endif
+#   elif defined(_MSC_VER) && _MSC_VER >= 1927
+#       define ZMATH_HAS_CONSTEXPR 1
+#   endif
+#endif
+
+#ifndef ZMATH_HAS_CONSTEXPR
+#   define ZMATH_HAS_CONSTEXPR 0
+#endif
+
+#if ZMATH_HAS_CONSTEXPR
+#   define ZMATH_CONSTEXPR constexpr
+#else
+#   define ZMATH_CONSTEXPR
+#endif
+
+#ifdef ZMATH_INLINE
+#   if defined(_MSC_VER)
+#       define ZMATHDEF static __forceinline ZMATH_CONSTEXPR
+#   elif defined(__GNUC__) || defined(__clang__)
+#       define ZMATHDEF static inline __attribute__((always_inline)) ZMATH_CONSTEXPR
+#   else
+#       define ZMATHDEF static inline
+#   endif
+#   ifndef ZMATH_IMPLEMENTATION
+#       define ZMATH_IMPLEMENTATION
+#   endif
+#elif defined(ZMATH_STATIC)
 #   define ZMATHDEF static
 #else
 #   define ZMATHDEF extern
 #endif
 
+// For kernels past the compiler's inlining budget whose batch loops only
+// vectorize once the kernel is inlined.
+#if defined(_MSC_VER)
+#   define ZMATH__FORCE_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#   define ZMATH__FORCE_INLINE inline __attribute__((always_inline))
+#else
+#   define ZMATH__FORCE_INLINE inline
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#   define ZMATH_RESTRICT __restrict
+#else
+#   define ZMATH_RESTRICT
+#endif
+
+// Keeps rarely taken fallbacks out of line, away from the loops that call
+// them.
+#if defined(__GNUC__) || defined(__clang__)
+#   define ZMATH__COLD __attribute__((noinline, cold))
+#elif defined(_MSC_VER)
+#   define ZMATH__COLD __declspec(noinline)
+#else
+#   define ZMATH__COLD
+#endif
+
+// Optimization barrier for Cody-Waite chains. -ffast-math may reassociate
+// ((x - q * P1) - q * P2) - q * P3 into x - q * (P1 + P2 + P3), which throws
+// the split away; an empty asm that claims to change v keeps each partial
+// remainder. ZMATH__PIN_MEM suits any type, ZMATH__PIN only floats and
+// native vectors. Both are no-ops without __FAST_MATH__.
+#if defined(__FAST_MATH__) && (defined(__GNUC__) || defined(__clang__))
+#   define ZMATH__PIN_MEM(v) __asm__("" : "+m"(v))
+#   if defined(__SSE2__) && (!defined(__FLT_EVAL_METHOD__) || __FLT_EVAL_METHOD__ == 0)
+#       define ZMATH__PIN(v) __asm__("" : "+x"(v))
+#   elif defined(__aarch64__) || defined(__ARM_NEON)
+#       define ZMATH__PIN(v) __asm__("" : "+w"(v))
+#   else
+#       define ZMATH__PIN(v) ZMATH__PIN_MEM(v)
+#   endif
+#else
+#   define ZMATH__PIN_MEM(v) ((void)0)
+#   define ZMATH__PIN(v) ((void)0)
+#endif
+
+// Accuracy tiers.
+// sin, cos, sincos, exp, log and invsqrt come in three tiers: the explicit
+// zmath_*_fast and zmath_*_precise functions, and the unsuffixed one, which
+// uses the tier picked by ZMATH_ACCURACY (default: ZMATH_ACCURACY_DEFAULT).
+// Functions built on them (tan, asin, acos, sqrt and the *_array
+// kernels) follow ZMATH_ACCURACY as well. Measured worst case against libm:
+//
+//   function  fast              default             precise
+//   sin/cos   1.1e-4 abs        5.4e-6 abs          1.6 ULP
+//   exp       1.8e-3 rel        8.0e-4 rel          1.3 ULP
+//   log       8.6e-4 abs        1.9e-5 abs          2 ULP
+//   invsqrt   3.5e-2 rel        1.8e-3 rel          2.2 ULP
+//   exp2      1.4e-3 rel        1.0 ULP             1.0 ULP
+//   log2      1.3e-3 abs        1.6 ULP             1.6 ULP
+//   pow       7.3e-3 rel        1.5 ULP             1.5 ULP
+//
+// exp2, log2 and pow use 32-entry tables from the default tier up, so only
+// the fast tier differs; pow carries y * log2(x) as a head/tail pair.
+#define ZMATH_ACCURACY_FAST     0
+#define ZMATH_ACCURACY_DEFAULT  1
+#define ZMATH_ACCURACY_PRECISE  2
+
+#ifndef ZMATH_ACCURACY
+#   define ZMATH_ACCURACY ZMATH_ACCURACY_DEFAULT
+#endif
+
+// Special values (ZMATH_FAST_MATH drops the checks).
+// By default exp, exp2 and pow flush results below 2^-126 to zero, saturate
+// past FLT_MAX to infinity and pass NaN through; log and log2 take
+// subnormal inputs at full accuracy, return infinity for infinity and pass
+// NaN through. All of it is branch-free selects, so batch loops still
+// vectorize. With ZMATH_FAST_MATH the checks are compiled out: exp inputs
+// must keep results normal (|x| < 87), log inputs must be positive normal
+// floats, and anything else gives an unspecified finite value, infinity or
+// NaN. Run bulk kernels between zmath_ftz_begin and zmath_ftz_end so that
+// subnormals in intermediates cannot reach the slow microcode paths either.
+
+// Table-driven trigonometry (opt-in with ZMATH_TRIG_LUT).
+// A quarter-wave sine table built at compile time, 2^ZMATH_TRIG_LUT_BITS
+// steps per turn (4..16, default 12), read with nearest-entry or linear
+// interpolation (ZMATH_TRIG_LUT_INTERP, default linear). With the default
+// 12 bits, linear is within 3.5e-7 abs and nearest within 7.7e-4 abs; each
+// doubling of the table divides those by 4 and 2. The table is generated by
+// the preprocessor, which costs the implementation file about 0.7 s of
+// compile time at 12 bits.
+#define ZMATH_TRIG_LUT_NEAREST  0
+#define ZMATH_TRIG_LUT_LINEAR   1
+
+#ifdef ZMATH_TRIG_LUT
+#   ifndef ZMATH_TRIG_LUT_BITS
+#       define ZMATH_TRIG_LUT_BITS 12
+#   endif
+#   ifndef ZMATH_TRIG_LUT_INTERP
+#       define ZMATH_TRIG_LUT_INTERP ZMATH_TRIG_LUT_LINEAR
+#   endif
+#   if ZMATH_TRIG_LUT_BITS < 4 || ZMATH_TRIG_LUT_BITS > 16
+#       error "ZMATH_TRIG_LUT_BITS must be between 4 and 16"
+#   endif
+#endif
+
 // Logic and bitwise.
 ZMATHDEF bool  zmath_is_near(float a, float b, float tol);
 ZMATHDEF bool  zmath_isnan(float x);
@@ -83,16 +393,20 @@ ZMATHDEF float zmath_mod(float x, float y);
 // Power and roots.
 ZMATHDEF float zmath_sqrt(float x);
 ZMATHDEF float zmath_invsqrt(float x);
+ZMATHDEF float zmath_rsqrt_n(float x, int iterations);
+ZMATHDEF float zmath_rcp(float x);
 ZMATHDEF float zmath_hypot(float x, float y);
 ZMATHDEF float zmath_log(float x);
 ZMATHDEF float zmath_log2(float x);
 ZMATHDEF float zmath_pow(float x, float y);
 ZMATHDEF float zmath_exp(float x);
+ZMATHDEF float zmath_exp2(float x);
 
 // Trigonometry.
 ZMATHDEF float zmath_sin(float x);
 ZMATHDEF float zmath_cos(float x);
 ZMATHDEF float zmath_tan(float x);
+ZMATHDEF void  zmath_sincos(float x, float* s, float* c);
 ZMATHDEF float zmath_acos(float x);
 ZMATHDEF float zmath_asin(float x);
 ZMATHDEF float zmath_atan(float x);
@@ -100,7 +414,44 @@ ZMATHDEF float zmath_atan2(float y, float x);
 ZMATHDEF float zmath_deg2rad(float deg);
 ZMATHDEF float zmath_rad2deg(float rad);
 
+// Angles in turns: sin_turns(t) is sin(2pi * t). Whole turns are removed
+// from t exactly before it is scaled to radians, so a phase accumulated as
+// time * frequency stays as accurate as t itself, at any uptime. Radian
+// arguments are reduced exactly for |x| < ~4.1e5.
+ZMATHDEF float zmath_sin_turns(float t);
+ZMATHDEF float zmath_cos_turns(float t);
+ZMATHDEF void  zmath_sincos_turns(float t, float* s, float* c);
+
+// Explicit accuracy tiers (see "Accuracy tiers" above).
+ZMATHDEF float zmath_sin_fast(float x);
+ZMATHDEF float zmath_cos_fast(float x);
+ZMATHDEF void  zmath_sincos_fast(float x, float* s, float* c);
+ZMATHDEF float zmath_exp_fast(float x);
+ZMATHDEF float zmath_log_fast(float x);
+ZMATHDEF float zmath_invsqrt_fast(float x);
+ZMATHDEF float zmath_sin_precise(float x);
+ZMATHDEF float zmath_cos_precise(float x);
+ZMATHDEF void  zmath_sincos_precise(float x, float* s, float* c);
+ZMATHDEF float zmath_exp_precise(float x);
+ZMATHDEF float zmath_log_precise(float x);
+ZMATHDEF float zmath_invsqrt_precise(float x);
+
+#ifdef ZMATH_TRIG_LUT
+// Table-driven trigonometry. A phase is a uint32 fraction of a turn (2^32 is
+// one full turn), so an oscillator adding a fixed step per sample wraps for
+// free and never pays for a float range reduction. The fill writes
+// sin of `phase`, `phase + step`, ... and returns the phase after the last.
+ZMATHDEF float    zmath_sin_lut(float x);
+ZMATHDEF float    zmath_cos_lut(float x);
+ZMATHDEF float    zmath_sin_turn(uint32_t phase);
+ZMATHDEF float    zmath_cos_turn(uint32_t phase);
+ZMATHDEF uint32_t zmath_rad2turn(float rad);
+ZMATHDEF uint32_t zmath_sin_turn_fill(uint32_t phase, uint32_t step, float* out, size_t n);
+#endif
+
 // Vector math.
+// norm multiplies by one refined invsqrt of the squared length (no sqrt or
+// division); vectors shorter than ZMATH_EPSILON are returned unchanged.
 ZMATHDEF zvec2 zmath_v2_add(zvec2 a, zvec2 b);
 ZMATHDEF zvec2 zmath_v2_sub(zvec2 a, zvec2 b);
 ZMATHDEF zvec2 zmath_v2_scale(zvec2 v, float s);
@@ -116,577 +467,7323 @@ ZMATHDEF zvec3 zmath_v3_cross(zvec3 a, zvec3 b);
 ZMATHDEF float zmath_v3_len(zvec3 v);
 ZMATHDEF zvec3 zmath_v3_norm(zvec3 v);
 
-// Optional short names.
-#ifdef ZMATH_SHORT_NAMES
-    // Constants.
-#   ifndef PI
-#   define PI          ZMATH_PI
-#   endif
-#   define TAU         ZMATH_TAU
-#   define EPSILON     ZMATH_EPSILON
-#   define SQRT2       ZMATH_SQRT2
+// Vector streams (SoA).
+// Each call processes `count` elements of its first zvec3_soa argument; the
+// other streams must be at least that long. Outputs may alias an input
+// stream exactly; the AoS side of a transpose must not overlap the streams.
+ZMATHDEF void  zmath_v3_soa_add(zvec3_soa a, zvec3_soa b, zvec3_soa out);
+ZMATHDEF void  zmath_v3_soa_sub(zvec3_soa a, zvec3_soa b, zvec3_soa out);
+ZMATHDEF void  zmath_v3_soa_scale(zvec3_soa v, float s, zvec3_soa out);
+ZMATHDEF void  zmath_v3_soa_lerp(zvec3_soa a, zvec3_soa b, float t, zvec3_soa out);
+ZMATHDEF void  zmath_v3_soa_dot(zvec3_soa a, zvec3_soa b, float* out);
+ZMATHDEF void  zmath_v3_soa_cross(zvec3_soa a, zvec3_soa b, zvec3_soa out);
+ZMATHDEF void  zmath_v3_soa_len(zvec3_soa v, float* out);
+ZMATHDEF void  zmath_v3_soa_norm(zvec3_soa v, zvec3_soa out);
+ZMATHDEF void  zmath_v3_aos_to_soa(const zvec3* in, zvec3_soa out);
+ZMATHDEF void  zmath_v3_soa_to_aos(zvec3_soa in, zvec3* out);
 
-    // Types.
-    typedef zvec2       vec2;
-    typedef zvec3       vec3;
+// Matrices.
+// Products compose right to left: mul(a, b) applies b first. A singular
+// matrix inverts to all zeros. inverse_affine expects a bottom row of
+// (0, 0, 0, 1) and skips the general cofactor expansion. transform_point
+// uses w = 1 (no perspective divide), transform_dir uses w = 0.
+ZMATHDEF zmat3 zmath_m3_identity(void);
+ZMATHDEF zmat3 zmath_m3_mul(zmat3 a, zmat3 b);
+ZMATHDEF zmat3 zmath_m3_transpose(zmat3 m);
+ZMATHDEF zmat3 zmath_m3_inverse(zmat3 m);
+ZMATHDEF zvec3 zmath_m3_mul_v3(zmat3 m, zvec3 v);
+ZMATHDEF zmat3 zmath_m3_from_m4(zmat4 m);
 
-    // Logic, we undefine standard macros if they exist.
-#   ifdef isnan
-#   undef isnan
-#   endif
-#   define isnan       zmath_isnan
+ZMATHDEF zmat4 zmath_m4_identity(void);
+ZMATHDEF zmat4 zmath_m4_translation(zvec3 t);
+ZMATHDEF zmat4 zmath_m4_scaling(zvec3 s);
+ZMATHDEF zmat4 zmath_m4_mul(zmat4 a, zmat4 b);
+ZMATHDEF zmat4 zmath_m4_transpose(zmat4 m);
+ZMATHDEF zmat4 zmath_m4_inverse(zmat4 m);
+ZMATHDEF zmat4 zmath_m4_inverse_affine(zmat4 m);
+ZMATHDEF zvec3 zmath_m4_transform_point(zmat4 m, zvec3 p);
+ZMATHDEF zvec3 zmath_m4_transform_dir(zmat4 m, zvec3 v);
 
-#   ifdef isinf
-#   undef isinf
-#   endif
-#   define isinf       zmath_isinf
+// Batch transforms. `out` may alias `in` exactly, but must not partially
+// overlap it. Results match the single-vector calls.
+ZMATHDEF void  zmath_m4_transform_points(const zmat4* m, const zvec3* in, zvec3* out, size_t n);
+ZMATHDEF void  zmath_m4_transform_dirs(const zmat4* m, const zvec3* in, zvec3* out, size_t n);
+ZMATHDEF void  zmath_m4_transform_points_soa(const zmat4* m, zvec3_soa in, zvec3_soa out);
 
-#   define is_near     zmath_is_near
-    
-    // Interpolation.
-#   define step        zmath_step
-#   define smoothstep  zmath_smoothstep
-#   define smootherstep zmath_smootherstep
-#   define lerp        zmath_lerp
-#   define inv_lerp    zmath_inv_lerp
-#   define remap       zmath_remap
-    
-    // Arithmetic.
-#   define abs         zmath_abs
-#   define min         zmath_min
-#   define max         zmath_max
-#   define clamp       zmath_clamp
-#   define sign        zmath_sign
-#   define copysign    zmath_copysign
-    
-    // Rounding.
-#   define floor       zmath_floor
-#   define ceil        zmath_ceil
-#   define round       zmath_round
-#   define fract       zmath_fract
-#   define fmod        zmath_fmod
-#   define mod         zmath_mod
-    
-    // Power.
-#   define sqrt        zmath_sqrt
-#   define invsqrt     zmath_invsqrt
-#   define hypot       zmath_hypot
-#   define log         zmath_log
-#   define log2        zmath_log2
-#   define pow         zmath_pow
-#   define exp         zmath_exp
-    
-    // Trig.
-#   ifdef sin
-#   undef sin
-#   endif
-#   define sin         zmath_sin
+// Quaternions.
+// mul(a, b) applies b first, as with matrices. nlerp and slerp take the
+// shorter arc. slerp is an nlerp with a polynomial-corrected t (no acos or
+// sin), within 8e-4 rad of the exact rotation for any pair of inputs.
+// Normalization is one refined invsqrt multiply, as for vectors.
+ZMATHDEF zquat zmath_q_identity(void);
+ZMATHDEF zquat zmath_q_from_axis_angle(zvec3 axis, float angle);
+ZMATHDEF zquat zmath_q_mul(zquat a, zquat b);
+ZMATHDEF zquat zmath_q_conj(zquat q);
+ZMATHDEF float zmath_q_dot(zquat a, zquat b);
+ZMATHDEF zquat zmath_q_norm(zquat q);
+ZMATHDEF zvec3 zmath_q_rotate(zquat q, zvec3 v);
+ZMATHDEF zquat zmath_q_nlerp(zquat a, zquat b, float t);
+ZMATHDEF zquat zmath_q_slerp(zquat a, zquat b, float t);
+ZMATHDEF zmat4 zmath_q_to_m4(zquat q);
 
-#   ifdef cos
-#   undef cos
-#   endif
-#   define cos         zmath_cos
+// Pose blending over `n` joints. The two-pose blends may write in place
+// over `a` or `b`. blend_poses sums `count` poses weighted by `weights`,
+// each flipped onto the hemisphere of the running sum, then normalizes;
+// `out` may be poses[0].
+ZMATHDEF void  zmath_q_nlerp_array(const zquat* a, const zquat* b, float t, zquat* out, size_t n);
+ZMATHDEF void  zmath_q_slerp_array(const zquat* a, const zquat* b, float t, zquat* out, size_t n);
+ZMATHDEF void  zmath_q_blend_poses(const zquat* const* poses, const float* weights, size_t count,
+                                   zquat* out, size_t n);
 
-#   ifdef tan
-#   undef tan
-#   endif
-#   define tan         zmath_tan
+// Geometry.
+// Plane normals are unit length, so plane_dist is a signed distance, and
+// frustum planes face inward (left, right, bottom, top, near, far).
+// frustum_from_m4 extracts them from a view-projection matrix whose clip
+// depth is -w..w, or 0..w with `zero_to_one`. Ray hits write the entry t,
+// 0 when the origin is inside. The sphere and box frustum tests are
+// conservative: objects near a frustum corner can pass while outside.
+ZMATHDEF zplane zmath_plane_from_point_normal(zvec3 p, zvec3 n);
+ZMATHDEF float  zmath_plane_dist(zplane pl, zvec3 p);
+ZMATHDEF bool   zmath_aabb_contains(zaabb b, zvec3 p);
+ZMATHDEF bool   zmath_aabb_overlap(zaabb a, zaabb b);
+ZMATHDEF bool   zmath_sphere_aabb_overlap(zsphere s, zaabb b);
+ZMATHDEF bool   zmath_ray_aabb(zray r, zaabb b, float* t);
+ZMATHDEF bool   zmath_ray_sphere(zray r, zsphere s, float* t);
+ZMATHDEF void   zmath_frustum_from_m4(zmat4 m, bool zero_to_one, zplane out[6]);
+ZMATHDEF bool   zmath_frustum_sphere(const zplane planes[6], zsphere s);
+ZMATHDEF bool   zmath_frustum_aabb(const zplane planes[6], zaabb b);
 
-#   ifdef asin
-#   undef asin
-#   endif
-#   define asin        zmath_asin
+// Batched tests over SoA objects, written as bitmasks: bit (i % 32) of
+// mask[i / 32] is set when object i passes. `mask` holds (n + 31) / 32
+// words and the unused bits of the last are 0. Box streams are `mins` and
+// `maxs`; n comes from the first stream. mask_compact writes the indices of
+// the set bits to `out`, which needs room for n, and returns their count.
+ZMATHDEF void   zmath_frustum_cull_spheres(const zplane planes[6], zvec3_soa centers, const float* radii,
+                                           uint32_t* mask);
+ZMATHDEF void   zmath_frustum_cull_aabbs(const zplane planes[6], zvec3_soa mins, zvec3_soa maxs, uint32_t* mask);
+ZMATHDEF void   zmath_ray_aabb_soa(zray r, float t_max, zvec3_soa mins, zvec3_soa maxs, uint32_t* mask);
+ZMATHDEF size_t zmath_mask_compact(const uint32_t* mask, size_t n, uint32_t* out);
 
-#   ifdef acos
-#   undef acos
-#   endif
-#   define acos        zmath_acos
+// Batch kernels.
+// Element-wise over `n` floats. `out` may alias an input exactly (in-place),
+// but must not partially overlap it. Results match the scalar functions.
+ZMATHDEF void  zmath_sin_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_cos_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_tan_array(const float* in, float* out, size_t n);
+// `s` and `c` must be distinct; either may be `in`.
+ZMATHDEF void  zmath_sincos_array(const float* in, float* s, float* c, size_t n);
+ZMATHDEF void  zmath_asin_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_acos_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_atan_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_atan2_array(const float* y, const float* x, float* out, size_t n);
+ZMATHDEF void  zmath_exp_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_exp2_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_log_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_log2_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_pow_array(const float* x, const float* y, float* out, size_t n);
+ZMATHDEF void  zmath_sqrt_array(const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_invsqrt_array(const float* in, float* out, size_t n);
 
-#   ifdef atan
-#   undef atan
-#   endif
-#   define atan        zmath_atan
+// Reductions.
+// Each spreads the array over 16 independent accumulators, which the
+// compiler keeps in vector registers, and combines them in a fixed order,
+// so results do not depend on the target. Sums add 1024-element blocks and
+// then combine the block sums pairwise, so rounding error grows with
+// log(n) rather than n. sum_kahan also carries a compensation term per
+// accumulator and is accurate to about one float ulp at any n (it must not
+// be built with -ffast-math, which removes the compensation). min and max
+// skip NaNs and return +inf and -inf for an empty or all-NaN array; argmin
+// and argmax return the first index of the extreme, or 0 when there is
+// none. The bounds of an empty array are the inverted box from +inf to
+// -inf.
+ZMATHDEF float  zmath_sum_array(const float* in, size_t n);
+ZMATHDEF float  zmath_sum_kahan_array(const float* in, size_t n);
+ZMATHDEF float  zmath_sum_sq_array(const float* in, size_t n);
+ZMATHDEF float  zmath_dot_array(const float* a, const float* b, size_t n);
+ZMATHDEF float  zmath_len_array(const float* in, size_t n);
+ZMATHDEF float  zmath_min_array(const float* in, size_t n);
+ZMATHDEF float  zmath_max_array(const float* in, size_t n);
+ZMATHDEF size_t zmath_argmin_array(const float* in, size_t n);
+ZMATHDEF size_t zmath_argmax_array(const float* in, size_t n);
+ZMATHDEF zaabb  zmath_v3_bounds(const zvec3* in, size_t n);
+ZMATHDEF zaabb  zmath_v3_soa_bounds(zvec3_soa v);
 
-#   ifdef atan2
-#   undef atan2
-#   endif
-#   define atan2       zmath_atan2
+// Interpolation batches.
+// The range parameters are shared by the whole batch, so the divisions in
+// inv_lerp, remap and the smoothsteps are hoisted into one reciprocal and
+// each element costs a multiply; results can differ from the scalar calls
+// by an ulp of t. lerp is bit-identical to the scalar call. Clamps are
+// selects, so every loop vectorizes. out may be the same buffer as an
+// input.
+ZMATHDEF void  zmath_lerp_array(const float* a, const float* b, float t, float* out, size_t n);
+ZMATHDEF void  zmath_inv_lerp_array(float a, float b, const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_remap_array(float iMin, float iMax, float oMin, float oMax, const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_clamp_array(float min_val, float max_val, const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_smoothstep_array(float edge0, float edge1, const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_smootherstep_array(float edge0, float edge1, const float* in, float* out, size_t n);
+ZMATHDEF void  zmath_v2_lerp_array(const zvec2* a, const zvec2* b, float t, zvec2* out, size_t n);
+ZMATHDEF void  zmath_v3_lerp_array(const zvec3* a, const zvec3* b, float t, zvec3* out, size_t n);
 
-#   define deg2rad     zmath_deg2rad
-#   define rad2deg     zmath_rad2deg
+// Random numbers.
+// xoshiro128++ (period 2^128 - 1), seeded through splitmix64. jump advances
+// a state by 2^64 draws and long_jump by 2^96; split returns the current
+// state and jumps `r` past it, so successive splits hand out sequences that
+// never overlap. Uniform floats are multiples of 2^-24 in [0, 1). Normals use
+// Box-Muller on zmath_log and zmath_sincos, so they follow ZMATH_ACCURACY.
+ZMATHDEF zrng     zmath_rng_seed(uint64_t seed);
+ZMATHDEF void     zmath_rng_jump(zrng* r);
+ZMATHDEF void     zmath_rng_long_jump(zrng* r);
+ZMATHDEF zrng     zmath_rng_split(zrng* r);
+ZMATHDEF uint32_t zmath_rng_u32(zrng* r);
+ZMATHDEF float    zmath_rng_float(zrng* r);
+ZMATHDEF float    zmath_rng_range(zrng* r, float lo, float hi);
 
-    // Vector 2.
-#   define v2_add      zmath_v2_add
-#   define v2_sub      zmath_v2_sub
-#   define v2_scale    zmath_v2_scale
-#   define v2_dot      zmath_v2_dot
-#   define v2_len      zmath_v2_len
-#   define v2_norm     zmath_v2_norm
+// Fills `n` outputs. Uniform draws match zmath_rng_range call for call.
+ZMATHDEF void     zmath_rng_fill_uniform(zrng* r, float lo, float hi, float* out, size_t n);
+ZMATHDEF void     zmath_rng_fill_normal(zrng* r, float mean, float stddev, float* out, size_t n);
+ZMATHDEF void     zmath_rng_fill_unit_vec3(zrng* r, zvec3* out, size_t n);
 
-    // Vector 3.
-#   define v3_add      zmath_v3_add
-#   define v3_sub      zmath_v3_sub
-#   define v3_scale    zmath_v3_scale
-#   define v3_dot      zmath_v3_dot
-#   define v3_cross    zmath_v3_cross
-#   define v3_len      zmath_v3_len
-#   define v3_norm     zmath_v3_norm
+// Noise.
+// Lattice noise over an integer hash of the cell corners: no permutation
+// table, and each seed gives an unrelated field. value noise lies in
+// [-1, 1]; perlin and simplex are scaled to about [-1, 1]. All are 0 at
+// the cell corners except value noise. Cells come from a branch-free floor,
+// valid for |coordinate| < 2^23.
+#define ZMATH_NOISE_VALUE   0
+#define ZMATH_NOISE_PERLIN  1
+#define ZMATH_NOISE_SIMPLEX 2
+
+ZMATHDEF float zmath_noise_value2(float x, float y, uint32_t seed);
+ZMATHDEF float zmath_noise_value3(float x, float y, float z, uint32_t seed);
+ZMATHDEF float zmath_noise_perlin2(float x, float y, uint32_t seed);
+ZMATHDEF float zmath_noise_perlin3(float x, float y, float z, uint32_t seed);
+ZMATHDEF float zmath_noise_simplex2(float x, float y, uint32_t seed);
+ZMATHDEF float zmath_noise_simplex3(float x, float y, float z, uint32_t seed);
+
+// Batched noise of one ZMATH_NOISE_* kind, equal to the scalar calls. The
+// grid is row-major: out[j * w + i] samples (x0 + i * step, y0 + j * step).
+ZMATHDEF void  zmath_noise2_array(int kind, uint32_t seed, const float* x, const float* y, float* out, size_t n);
+ZMATHDEF void  zmath_noise3_array(int kind, uint32_t seed, zvec3_soa p, float* out);
+ZMATHDEF void  zmath_noise2_grid(int kind, uint32_t seed, float x0, float y0, float step,
+                                 float* out, size_t w, size_t h);
+
+// Packing.
+// Half floats round to nearest even, keep subnormals, overflow to infinity
+// and quiet NaNs like the hardware conversions. Normalized integers clamp
+// to [0, 1] (unorm) or [-1, 1] (snorm), map NaN to 0 and round to nearest
+// even. Unpacking divides, so unpack then pack gives back the integer, and
+// the most negative snorm reads as -1 like its neighbour.
+ZMATHDEF uint16_t zmath_f32_to_f16(float x);
+ZMATHDEF float    zmath_f16_to_f32(uint16_t h);
+ZMATHDEF int16_t  zmath_f32_to_snorm16(float x);
+ZMATHDEF float    zmath_snorm16_to_f32(int16_t v);
+ZMATHDEF uint16_t zmath_f32_to_unorm16(float x);
+ZMATHDEF float    zmath_unorm16_to_f32(uint16_t v);
+ZMATHDEF int8_t   zmath_f32_to_snorm8(float x);
+ZMATHDEF float    zmath_snorm8_to_f32(int8_t v);
+ZMATHDEF uint8_t  zmath_f32_to_unorm8(float x);
+ZMATHDEF float    zmath_unorm8_to_f32(uint8_t v);
+
+// Element-wise over `n` values, equal to the scalar calls. Vectors convert
+// as their floats: pass &v[0].x and 3 * n for a zvec3 array.
+ZMATHDEF void     zmath_f32_to_f16_array(const float* in, uint16_t* out, size_t n);
+ZMATHDEF void     zmath_f16_to_f32_array(const uint16_t* in, float* out, size_t n);
+ZMATHDEF void     zmath_f32_to_snorm16_array(const float* in, int16_t* out, size_t n);
+ZMATHDEF void     zmath_snorm16_to_f32_array(const int16_t* in, float* out, size_t n);
+ZMATHDEF void     zmath_f32_to_unorm16_array(const float* in, uint16_t* out, size_t n);
+ZMATHDEF void     zmath_unorm16_to_f32_array(const uint16_t* in, float* out, size_t n);
+ZMATHDEF void     zmath_f32_to_snorm8_array(const float* in, int8_t* out, size_t n);
+ZMATHDEF void     zmath_snorm8_to_f32_array(const int8_t* in, float* out, size_t n);
+ZMATHDEF void     zmath_f32_to_unorm8_array(const float* in, uint8_t* out, size_t n);
+ZMATHDEF void     zmath_unorm8_to_f32_array(const uint8_t* in, float* out, size_t n);
+
+// Polynomials and curves.
+// c[0] + c[1] x + ... + c[terms - 1] x^(terms - 1). poly evaluates blocks of
+// eight coefficients as Estrin trees (depth 3 instead of 7) joined by Horner
+// steps in x^8, so wide cores overlap the multiply-adds; poly_horner is the
+// plain chain, with one multiply-add per term.
+ZMATHDEF float zmath_poly(const float* c, size_t terms, float x);
+ZMATHDEF float zmath_poly_horner(const float* c, size_t terms, float x);
+ZMATHDEF void  zmath_poly_array(const float* c, size_t terms, const float* in, float* out, size_t n);
+
+// Cubic segments for t in [0, 1], as weighted sums of the four inputs, so
+// t = 0 and t = 1 give the end points exactly. bezier3 runs from p0 to p3
+// with p1 and p2 as handles; hermite from p0 to p1 with tangents m0 and m1;
+// catmull_rom from p1 to p2, with p0 and p3 setting the uniform tangents.
+ZMATHDEF float zmath_bezier3(float p0, float p1, float p2, float p3, float t);
+ZMATHDEF float zmath_hermite(float p0, float m0, float p1, float m1, float t);
+ZMATHDEF float zmath_catmull_rom(float p0, float p1, float p2, float p3, float t);
+ZMATHDEF zvec2 zmath_v2_bezier3(zvec2 p0, zvec2 p1, zvec2 p2, zvec2 p3, float t);
+ZMATHDEF zvec2 zmath_v2_hermite(zvec2 p0, zvec2 m0, zvec2 p1, zvec2 m1, float t);
+ZMATHDEF zvec2 zmath_v2_catmull_rom(zvec2 p0, zvec2 p1, zvec2 p2, zvec2 p3, float t);
+ZMATHDEF zvec3 zmath_v3_bezier3(zvec3 p0, zvec3 p1, zvec3 p2, zvec3 p3, float t);
+ZMATHDEF zvec3 zmath_v3_hermite(zvec3 p0, zvec3 m0, zvec3 p1, zvec3 m1, float t);
+ZMATHDEF zvec3 zmath_v3_catmull_rom(zvec3 p0, zvec3 p1, zvec3 p2, zvec3 p3, float t);
+
+// One segment of a ZMATH_CURVE_* kind sampled at n parameters, equal to the
+// scalar calls. p holds the four inputs in argument order.
+#define ZMATH_CURVE_BEZIER      0
+#define ZMATH_CURVE_HERMITE     1
+#define ZMATH_CURVE_CATMULL_ROM 2
+
+ZMATHDEF void  zmath_curve_array(int kind, const float p[4], const float* t, float* out, size_t n);
+ZMATHDEF void  zmath_v2_curve_array(int kind, const zvec2 p[4], const float* t, zvec2* out, size_t n);
+ZMATHDEF void  zmath_v3_curve_array(int kind, const zvec3 p[4], const float* t, zvec3* out, size_t n);
+
+// FFT.
+// X[k] = sum of x[j] e^(-2 pi i jk / n) over split real and imaginary
+// arrays, in place; the inverse transforms scale by 1 / n. Lengths are
+// powers of two. init fills the caller's table (2 * n floats) and returns
+// false for other lengths. A plan from fft_init serves fft and ifft; one
+// from fft_real_init serves the real transforms, which map n samples to
+// the n / 2 + 1 bins from 0 to n / 2 through one complex transform of
+// n / 2 points. ifft_real uses re and im as scratch, and `in` / `out` must
+// not overlap them. Plans are read-only, so threads can share one.
+ZMATHDEF bool  zmath_fft_init(zfft_plan* plan, size_t n, float* table);
+ZMATHDEF bool  zmath_fft_real_init(zfft_plan* plan, size_t n, float* table);
+ZMATHDEF void  zmath_fft(const zfft_plan* plan, float* re, float* im);
+ZMATHDEF void  zmath_ifft(const zfft_plan* plan, float* re, float* im);
+ZMATHDEF void  zmath_fft_real(const zfft_plan* plan, const float* in, float* re, float* im);
+ZMATHDEF void  zmath_ifft_real(const zfft_plan* plan, float* re, float* im, float* out);
+
+// Angle tables.
+// sincos_table fills s[k], c[k] with the sine and cosine of start + k * step
+// for k < n, the angle taken exactly rather than rounded to float. The
+// values come from a rotation recurrence in double that is renormalized
+// periodically, so a table costs three transcendental evaluations and one
+// complex multiply per entry. Entries are within a float ulp or so while
+// the angles stay below 2^24 in magnitude. sincos_array serves arbitrary
+// angles. v2_rotate_sc rotates v counterclockwise by the angle whose sine
+// and cosine are s and c, such as a table entry.
+ZMATHDEF void  zmath_sincos_table(float start, float step, float* s, float* c, size_t n);
+ZMATHDEF zvec2 zmath_v2_rotate_sc(zvec2 v, float s, float c);
+
+// Denormal control.
+// ftz_begin turns on flush-to-zero and denormals-are-zero for the calling
+// thread and returns the previous state; ftz_end restores it. Pair them
+// around bulk kernels so subnormal inputs and results cost no more than
+// normal ones. Both do nothing on targets without the controls. The
+// compiler may move arithmetic on locals across the calls, so keep the work
+// in function calls or memory accesses between them.
+ZMATHDEF zfp_state zmath_ftz_begin(void);
+ZMATHDEF void      zmath_ftz_end(zfp_state saved);
+
+// Double precision.
+// The _d functions mirror the float ones in double, for coordinates beyond
+// about 1e5 where float spacing reaches centimetres. The kernels are
+// branch-free like the float ones, so the _d_array loops vectorize over f64
+// lanes (x86 needs SSE4.2 for the 64-bit compares). Accuracy does not depend
+// on ZMATH_ACCURACY: sqrt_d, invsqrt_d, exp_d and log_d are within 2 ulp,
+// and sin_d and cos_d within 2 ulp for |x| below 1.6e6, the reach of the
+// exact part of the pi/2 reduction.
+// exp_d and log_d follow the special-value rules of exp and log. sqrt_d and
+// invsqrt_d take normal positive inputs; sqrt_d returns 0 for x <= 0.
+// v3d_to_v3_rel returns v - origin in float, which keeps full float
+// precision near the origin, for camera-relative rendering.
+ZMATHDEF double zmath_sqrt_d(double x);
+ZMATHDEF double zmath_invsqrt_d(double x);
+ZMATHDEF double zmath_sin_d(double x);
+ZMATHDEF double zmath_cos_d(double x);
+ZMATHDEF void   zmath_sincos_d(double x, double* s, double* c);
+ZMATHDEF double zmath_exp_d(double x);
+ZMATHDEF double zmath_log_d(double x);
+
+ZMATHDEF zvec3d zmath_v3d_add(zvec3d a, zvec3d b);
+ZMATHDEF zvec3d zmath_v3d_sub(zvec3d a, zvec3d b);
+ZMATHDEF zvec3d zmath_v3d_scale(zvec3d v, double s);
+ZMATHDEF double zmath_v3d_dot(zvec3d a, zvec3d b);
+ZMATHDEF zvec3d zmath_v3d_cross(zvec3d a, zvec3d b);
+ZMATHDEF double zmath_v3d_len(zvec3d v);
+ZMATHDEF zvec3d zmath_v3d_norm(zvec3d v);
+ZMATHDEF double zmath_v3d_dist(zvec3d a, zvec3d b);
+ZMATHDEF zvec3d zmath_v3d_lerp(zvec3d a, zvec3d b, double t);
+ZMATHDEF zvec3d zmath_v3d_from_v3(zvec3 v);
+ZMATHDEF zvec3  zmath_v3d_to_v3(zvec3d v);
+ZMATHDEF zvec3  zmath_v3d_to_v3_rel(zvec3d v, zvec3d origin);
+
+ZMATHDEF void   zmath_sqrt_d_array(const double* in, double* out, size_t n);
+ZMATHDEF void   zmath_invsqrt_d_array(const double* in, double* out, size_t n);
+ZMATHDEF void   zmath_sin_d_array(const double* in, double* out, size_t n);
+ZMATHDEF void   zmath_cos_d_array(const double* in, double* out, size_t n);
+ZMATHDEF void   zmath_sincos_d_array(const double* in, double* s, double* c, size_t n);
+ZMATHDEF void   zmath_exp_d_array(const double* in, double* out, size_t n);
+ZMATHDEF void   zmath_log_d_array(const double* in, double* out, size_t n);
+
+// Fixed point.
+// Q16.16 arithmetic on int32 for lockstep simulation: every function is
+// integer-only, so results are bit-identical on any compiler and target,
+// with or without FMA. Only fix_from_float and fix_to_float touch floats.
+// add, sub and mul wrap on overflow (mul rounds to nearest); div rounds to
+// nearest and saturates, including division by zero. sin and cos take
+// Q16.16 radians and are within 2^-16 of the true value; atan2 returns
+// radians in [-pi, pi] from a CORDIC, within 2^-16 as well. sqrt and the
+// vector lengths round to nearest; sqrt is 0 for negative input. to_int
+// rounds down.
+#define ZMATH_FIX_ONE      65536
+#define ZMATH_FIX_PI       205887
+#define ZMATH_FIX_HALF_PI  102944
+#define ZMATH_FIX_TAU      411775
+
+ZMATHDEF zfix    zmath_fix_from_int(int32_t i);
+ZMATHDEF int32_t zmath_fix_to_int(zfix a);
+ZMATHDEF zfix    zmath_fix_from_float(float x);
+ZMATHDEF float   zmath_fix_to_float(zfix a);
+ZMATHDEF zfix    zmath_fix_add(zfix a, zfix b);
+ZMATHDEF zfix    zmath_fix_sub(zfix a, zfix b);
+ZMATHDEF zfix    zmath_fix_mul(zfix a, zfix b);
+ZMATHDEF zfix    zmath_fix_div(zfix a, zfix b);
+ZMATHDEF zfix    zmath_fix_lerp(zfix a, zfix b, zfix t);
+ZMATHDEF zfix    zmath_fix_sqrt(zfix a);
+ZMATHDEF zfix    zmath_fix_sin(zfix a);
+ZMATHDEF zfix    zmath_fix_cos(zfix a);
+ZMATHDEF zfix    zmath_fix_atan2(zfix y, zfix x);
+
+ZMATHDEF zvec2fx zmath_v2fx_add(zvec2fx a, zvec2fx b);
+ZMATHDEF zvec2fx zmath_v2fx_sub(zvec2fx a, zvec2fx b);
+ZMATHDEF zvec2fx zmath_v2fx_scale(zvec2fx v, zfix s);
+ZMATHDEF zfix    zmath_v2fx_dot(zvec2fx a, zvec2fx b);
+ZMATHDEF zfix    zmath_v2fx_len(zvec2fx v);
+ZMATHDEF zvec2fx zmath_v2fx_norm(zvec2fx v);
+ZMATHDEF zvec3fx zmath_v3fx_add(zvec3fx a, zvec3fx b);
+ZMATHDEF zvec3fx zmath_v3fx_sub(zvec3fx a, zvec3fx b);
+ZMATHDEF zvec3fx zmath_v3fx_scale(zvec3fx v, zfix s);
+ZMATHDEF zfix    zmath_v3fx_dot(zvec3fx a, zvec3fx b);
+ZMATHDEF zvec3fx zmath_v3fx_cross(zvec3fx a, zvec3fx b);
+ZMATHDEF zfix    zmath_v3fx_len(zvec3fx v);
+ZMATHDEF zvec3fx zmath_v3fx_norm(zvec3fx v);
+
+// Arena.
+// Hands out aligned slices of one caller-supplied block (static, stack or
+// allocated once) with a pointer bump, so per-frame scratch needs no
+// malloc. alloc takes a power-of-two alignment and returns NULL when the
+// block is full; nothing is freed individually. mark and reset rewind to
+// an earlier state, e.g. at the end of a frame; reset(a, 0) empties it.
+// The typed helpers align to ZMATH_ARENA_ALIGN (64 bytes, a cache line
+// and any SIMD width) and pad each float stream to a multiple of it, so
+// native-width blocks never straddle into the next stream. The fft_plan
+// helpers carve the twiddle table and fill it, returning false (and
+// leaving the arena as it was) for a bad length or a full block.
+#ifndef ZMATH_ARENA_ALIGN
+#   define ZMATH_ARENA_ALIGN 64
 #endif
 
-#ifdef __cplusplus
-}
+ZMATHDEF zarena zmath_arena_init(void* block, size_t size);
+ZMATHDEF void*  zmath_arena_alloc(zarena* a, size_t size, size_t align);
+ZMATHDEF size_t zmath_arena_mark(const zarena* a);
+ZMATHDEF void   zmath_arena_reset(zarena* a, size_t mark);
+ZMATHDEF float* zmath_arena_floats(zarena* a, size_t n);
+ZMATHDEF bool   zmath_arena_v3_soa(zarena* a, size_t n, zvec3_soa* out);
+ZMATHDEF zmat3* zmath_arena_m3(zarena* a, size_t n);
+ZMATHDEF zmat4* zmath_arena_m4(zarena* a, size_t n);
+ZMATHDEF bool   zmath_arena_fft_plan(zarena* a, zfft_plan* plan, size_t n);
+ZMATHDEF bool   zmath_arena_fft_real_plan(zarena* a, zfft_plan* plan, size_t n);
+
+// Parallel dispatch (opt-in with ZMATH_PARALLEL).
+// The parallel calls split [0, n) into jobs of `chunk` elements (rounded up
+// to a multiple of 8; 0 means ZMATH_PARALLEL_CHUNK) and pass them to
+// `dispatch`, which must run job(ctx, 0 .. count-1) in any order or on any
+// threads and return once all have finished. A zeroed zmath_parallel runs the
+// jobs on the calling thread. Chunk bounds depend only on n and chunk, not on
+// the thread count, so results are bit-identical to the single-threaded call.
+// Outputs may alias inputs exactly, as with the array kernels.
+#ifdef ZMATH_PARALLEL
+
+#ifndef ZMATH_PARALLEL_CHUNK
+#   define ZMATH_PARALLEL_CHUNK 16384
 #endif
 
-#endif // ZMATH_H
+typedef void (*zmath_job_fn)(void* ctx, size_t job);
+typedef void (*zmath_dispatch_fn)(void* user, zmath_job_fn job, void* ctx, size_t count);
+typedef void (*zmath_range_fn)(void* ctx, size_t begin, size_t end);
+typedef void (*zmath_unary_array_fn)(const float* in, float* out, size_t n);
+typedef void (*zmath_binary_array_fn)(const float* a, const float* b, float* out, size_t n);
 
-#ifdef ZMATH_IMPLEMENTATION
+typedef struct
+{
+    zmath_dispatch_fn dispatch;
+    void* user;
+    size_t chunk;
+} zmath_parallel;
 
-#ifdef __cplusplus
-#   include <cstring>
-#else
-#   include <string.h>
+ZMATHDEF void zmath_parallel_for(const zmath_parallel* p, size_t n, zmath_range_fn body, void* ctx);
+ZMATHDEF void zmath_parallel_unary(const zmath_parallel* p, zmath_unary_array_fn kernel,
+                                   const float* in, float* out, size_t n);
+ZMATHDEF void zmath_parallel_binary(const zmath_parallel* p, zmath_binary_array_fn kernel,
+                                    const float* a, const float* b, float* out, size_t n);
+ZMATHDEF void zmath_parallel_transform_points(const zmath_parallel* p, const zmat4* m,
+                                              const zvec3* in, zvec3* out, size_t n);
+
+// Built-in pthread pool. `threads` counts the caller, which works too during
+// a dispatch; 0 picks the number of online CPUs. Only one thread may dispatch
+// to a pool at a time. MSVC has no pthreads, so there ZMATH_PARALLEL_NO_POOL
+// is the default and `dispatch` must come from your own job system.
+#if defined(_MSC_VER) && !defined(ZMATH_PARALLEL_NO_POOL)
+#   define ZMATH_PARALLEL_NO_POOL
+#endif
+#ifndef ZMATH_PARALLEL_NO_POOL
+typedef struct zmath_pool zmath_pool;
+
+ZMATHDEF zmath_pool*    zmath_pool_create(int threads);
+ZMATHDEF void           zmath_pool_destroy(zmath_pool* pool);
+ZMATHDEF zmath_parallel zmath_pool_parallel(zmath_pool* pool);
 #endif
 
-static inline uint32_t zmath__float_as_uint(float f) 
+#endif // ZMATH_PARALLEL
+
+// Profiling (opt-in with ZMATH_PROFILE).
+// Every batch kernel adds one call and its element count to a per-thread
+// counter; ZMATH_PROFILE_TIMING also adds the cycles spent inside it, read
+// from rdtsc on x86 and cntvct_el0 on AArch64 (other targets count 0). A
+// kernel called from a parallel job counts on the worker thread that ran
+// it. snapshot copies the calling thread's counters and reset clears them.
+// With ZMATH_INLINE or ZMATH_STATIC each translation unit has its own set.
+// Without ZMATH_PROFILE the hooks compile to nothing.
+#ifdef ZMATH_PROFILE
+
+#define ZMATH_PROFILE_LIST(X)                                   \
+    X(SIN_ARRAY, zmath_sin_array)                               \
+    X(COS_ARRAY, zmath_cos_array)                               \
+    X(TAN_ARRAY, zmath_tan_array)                               \
+    X(SINCOS_ARRAY, zmath_sincos_array)                         \
+    X(ASIN_ARRAY, zmath_asin_array)                             \
+    X(ACOS_ARRAY, zmath_acos_array)                             \
+    X(ATAN_ARRAY, zmath_atan_array)                             \
+    X(ATAN2_ARRAY, zmath_atan2_array)                           \
+    X(EXP_ARRAY, zmath_exp_array)                               \
+    X(EXP2_ARRAY, zmath_exp2_array)                             \
+    X(LOG_ARRAY, zmath_log_array)                               \
+    X(LOG2_ARRAY, zmath_log2_array)                             \
+    X(POW_ARRAY, zmath_pow_array)                               \
+    X(SQRT_ARRAY, zmath_sqrt_array)                             \
+    X(INVSQRT_ARRAY, zmath_invsqrt_array)                       \
+    X(SIN_TURN_FILL, zmath_sin_turn_fill)                       \
+    X(SINCOS_TABLE, zmath_sincos_table)                         \
+    X(SUM_ARRAY, zmath_sum_array)                               \
+    X(SUM_KAHAN_ARRAY, zmath_sum_kahan_array)                   \
+    X(SUM_SQ_ARRAY, zmath_sum_sq_array)                         \
+    X(DOT_ARRAY, zmath_dot_array)                               \
+    X(LEN_ARRAY, zmath_len_array)                               \
+    X(MIN_ARRAY, zmath_min_array)                               \
+    X(MAX_ARRAY, zmath_max_array)                               \
+    X(ARGMIN_ARRAY, zmath_argmin_array)                         \
+    X(ARGMAX_ARRAY, zmath_argmax_array)                         \
+    X(V3_BOUNDS, zmath_v3_bounds)                               \
+    X(V3_SOA_BOUNDS, zmath_v3_soa_bounds)                       \
+    X(LERP_ARRAY, zmath_lerp_array)                             \
+    X(INV_LERP_ARRAY, zmath_inv_lerp_array)                     \
+    X(REMAP_ARRAY, zmath_remap_array)                           \
+    X(CLAMP_ARRAY, zmath_clamp_array)                           \
+    X(SMOOTHSTEP_ARRAY, zmath_smoothstep_array)                 \
+    X(SMOOTHERSTEP_ARRAY, zmath_smootherstep_array)             \
+    X(V2_LERP_ARRAY, zmath_v2_lerp_array)                       \
+    X(V3_LERP_ARRAY, zmath_v3_lerp_array)                       \
+    X(V3_SOA_ADD, zmath_v3_soa_add)                             \
+    X(V3_SOA_SUB, zmath_v3_soa_sub)                             \
+    X(V3_SOA_SCALE, zmath_v3_soa_scale)                         \
+    X(V3_SOA_LERP, zmath_v3_soa_lerp)                           \
+    X(V3_SOA_DOT, zmath_v3_soa_dot)                             \
+    X(V3_SOA_CROSS, zmath_v3_soa_cross)                         \
+    X(V3_SOA_LEN, zmath_v3_soa_len)                             \
+    X(V3_SOA_NORM, zmath_v3_soa_norm)                           \
+    X(V3_AOS_TO_SOA, zmath_v3_aos_to_soa)                       \
+    X(V3_SOA_TO_AOS, zmath_v3_soa_to_aos)                       \
+    X(M4_TRANSFORM_POINTS, zmath_m4_transform_points)           \
+    X(M4_TRANSFORM_DIRS, zmath_m4_transform_dirs)               \
+    X(M4_TRANSFORM_POINTS_SOA, zmath_m4_transform_points_soa)   \
+    X(Q_NLERP_ARRAY, zmath_q_nlerp_array)                       \
+    X(Q_SLERP_ARRAY, zmath_q_slerp_array)                       \
+    X(Q_BLEND_POSES, zmath_q_blend_poses)                       \
+    X(FRUSTUM_CULL_SPHERES, zmath_frustum_cull_spheres)         \
+    X(FRUSTUM_CULL_AABBS, zmath_frustum_cull_aabbs)             \
+    X(RAY_AABB_SOA, zmath_ray_aabb_soa)                         \
+    X(MASK_COMPACT, zmath_mask_compact)                         \
+    X(RNG_FILL_UNIFORM, zmath_rng_fill_uniform)                 \
+    X(RNG_FILL_NORMAL, zmath_rng_fill_normal)                   \
+    X(RNG_FILL_UNIT_VEC3, zmath_rng_fill_unit_vec3)             \
+    X(NOISE2_GRID, zmath_noise2_grid)                           \
+    X(NOISE2_ARRAY, zmath_noise2_array)                         \
+    X(NOISE3_ARRAY, zmath_noise3_array)                         \
+    X(F32_TO_F16_ARRAY, zmath_f32_to_f16_array)                 \
+    X(F16_TO_F32_ARRAY, zmath_f16_to_f32_array)                 \
+    X(F32_TO_SNORM16_ARRAY, zmath_f32_to_snorm16_array)         \
+    X(SNORM16_TO_F32_ARRAY, zmath_snorm16_to_f32_array)         \
+    X(F32_TO_UNORM16_ARRAY, zmath_f32_to_unorm16_array)         \
+    X(UNORM16_TO_F32_ARRAY, zmath_unorm16_to_f32_array)         \
+    X(F32_TO_SNORM8_ARRAY, zmath_f32_to_snorm8_array)           \
+    X(SNORM8_TO_F32_ARRAY, zmath_snorm8_to_f32_array)           \
+    X(F32_TO_UNORM8_ARRAY, zmath_f32_to_unorm8_array)           \
+    X(UNORM8_TO_F32_ARRAY, zmath_unorm8_to_f32_array)           \
+    X(POLY_ARRAY, zmath_poly_array)                             \
+    X(CURVE_ARRAY, zmath_curve_array)                           \
+    X(V2_CURVE_ARRAY, zmath_v2_curve_array)                     \
+    X(V3_CURVE_ARRAY, zmath_v3_curve_array)                     \
+    X(FFT, zmath_fft)                                           \
+    X(IFFT, zmath_ifft)                                         \
+    X(FFT_REAL, zmath_fft_real)                                 \
+    X(IFFT_REAL, zmath_ifft_real)                               \
+    X(SQRT_D_ARRAY, zmath_sqrt_d_array)                         \
+    X(INVSQRT_D_ARRAY, zmath_invsqrt_d_array)                   \
+    X(SIN_D_ARRAY, zmath_sin_d_array)                           \
+    X(COS_D_ARRAY, zmath_cos_d_array)                           \
+    X(SINCOS_D_ARRAY, zmath_sincos_d_array)                     \
+    X(EXP_D_ARRAY, zmath_exp_d_array)                           \
+    X(LOG_D_ARRAY, zmath_log_d_array)
+
+// Counter indices: ZMATH_PROF_SIN_ARRAY, ...
+#define ZMATH__PROF_ENUM(id, fn) ZMATH_PROF_##id,
+enum { ZMATH_PROFILE_LIST(ZMATH__PROF_ENUM) ZMATH_PROF_COUNT };
+#undef ZMATH__PROF_ENUM
+
+typedef struct
 {
-    uint32_t u;
-    memcpy(&u, &f, sizeof(float));
-    return u;
+    uint64_t calls;
+    uint64_t elems;
+    uint64_t ticks;
+} zmath_prof_counter;
+
+typedef struct
+{
+    zmath_prof_counter c[ZMATH_PROF_COUNT];
+} zmath_profile;
+
+ZMATHDEF void        zmath_profile_snapshot(zmath_profile* out);
+ZMATHDEF void        zmath_profile_reset(void);
+ZMATHDEF const char* zmath_profile_name(int id);
+
+#endif // ZMATH_PROFILE
+
+// Large-argument reduction (Payne-Hanek).
+// Cody-Waite runs out of exact bits once the turn count passes 2^16. Past
+// that, the mantissa of x = m * 2^e is multiplied by a 96-bit window of the
+// bits of 1/(2pi), starting just below the bits that would only add whole
+// turns. The product leaves the fraction of a turn as a 64-bit fixed-point
+// number. It is integer only, so exact under every float mode, and lives
+// here because the lane kernels fall back to it too.
+static ZMATH_CONSTEXPR const uint32_t zmath__inv_tau_bits[9] =
+{
+    0x00000000u, 0x28BE60DBu, 0x9391054Au, 0x7F09D5F4u, 0x7D4D3770u,
+    0x36D8A566u, 0x4F10E410u, 0x7F9458EAu, 0xF7AEF158u
+};
+
+// 2pi / 2^64: turns a 64-bit fraction of a turn into radians.
+#define ZMATH__TURN_SCALE 3.4061215800865545e-19
+
+// frac(x / 2pi) * 2^64, two's complement. bits is the encoding of x, which
+// must be finite with |x| >= 2^-8; the error is below 2^-63 turns.
+static inline ZMATH_CONSTEXPR uint64_t zmath__turns_frac_k(uint32_t bits)
+{
+    uint64_t m = (bits & 0x007FFFFFu) | 0x00800000u;
+    int g = (int)((bits >> 23) & 0xFF) - 118;
+    int w = g >> 5, sh = g & 31;
+    uint64_t t0 = zmath__inv_tau_bits[w], t1 = zmath__inv_tau_bits[w + 1];
+    uint64_t t2 = zmath__inv_tau_bits[w + 2], t3 = zmath__inv_tau_bits[w + 3];
+    uint64_t hi = (((t0 << 32) | t1) << sh) | ((t2 << sh) >> 32);
+    uint64_t lo = (((t2 << 32) | t3) << sh) >> 32 & 0xFFFFFFFFu;
+    uint64_t f = ((m * (hi >> 32)) << 32) + m * (hi & 0xFFFFFFFFu) + ((m * lo) >> 32);
+    return (bits & 0x80000000u) ? (uint64_t)0 - f : f;
 }
 
-static inline float zmath__uint_as_float(uint32_t u) 
+// x reduced to [-pi, pi] through zmath__turns_frac_k, for |x| >= 2^-8.
+// Infinities and NaN give NaN.
+static ZMATH__COLD ZMATH_CONSTEXPR float zmath__reduce_tau_big_k(float x, uint32_t bits)
 {
-    float f;
-    memcpy(&f, &u, sizeof(uint32_t));
-    return f;
+    if ((bits & 0x7F800000u) == 0x7F800000u)
+    {
+        return x - x;
+    }
+    return (float)((double)(int64_t)zmath__turns_frac_k(bits) * ZMATH__TURN_SCALE);
 }
 
-// Logic and comparison.
+// SIMD lanes (ZMATH_SIMD).
+// zvec4f is a 4-wide float lane on every backend (SSE2/AVX2 __m128, NEON
+// float32x4_t, or a plain struct on the scalar fallback). AVX2 also provides
+// the 8-wide zvec8f. The math kernels reuse the default-tier polynomials lane
+// by lane, so results match the scalar functions (to rounding when the backend
+// fuses multiply-adds). All lane functions are static inline.
+#ifdef ZMATH_SIMD
 
-ZMATHDEF bool zmath_is_near(float a, float b, float tol) 
+#if defined(ZMATH_SIMD_SSE2) || defined(ZMATH_SIMD_AVX2)
+
+typedef __m128  zvec4f;
+typedef __m128i zvec4i;
+
+#define ZMATH__PIN_V4F(v) ZMATH__PIN(v)
+
+static inline zvec4f zmath_v4f_set1(float x)                   { return _mm_set1_ps(x); }
+static inline zvec4f zmath_v4f_load(const float* p)            { return _mm_loadu_ps(p); }
+static inline void   zmath_v4f_store(float* p, zvec4f v)       { _mm_storeu_ps(p, v); }
+static inline zvec4f zmath_v4f_add(zvec4f a, zvec4f b)         { return _mm_add_ps(a, b); }
+static inline zvec4f zmath_v4f_sub(zvec4f a, zvec4f b)         { return _mm_sub_ps(a, b); }
+static inline zvec4f zmath_v4f_mul(zvec4f a, zvec4f b)         { return _mm_mul_ps(a, b); }
+static inline zvec4f zmath_v4f_div(zvec4f a, zvec4f b)         { return _mm_div_ps(a, b); }
+static inline zvec4f zmath_v4f_min(zvec4f a, zvec4f b)         { return _mm_min_ps(a, b); }
+static inline zvec4f zmath_v4f_max(zvec4f a, zvec4f b)         { return _mm_max_ps(a, b); }
+
+// a * b + c, fused when the backend has FMA.
+static inline zvec4f zmath_v4f_madd(zvec4f a, zvec4f b, zvec4f c)
 {
-    return zmath_abs(a - b) <= tol;
+#ifdef ZMATH_SIMD_AVX2
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
 }
 
-ZMATHDEF bool zmath_isnan(float x) 
+static inline zvec4i zmath__v4i_set1(int32_t x)                { return _mm_set1_epi32(x); }
+static inline zvec4i zmath__v4i_add(zvec4i a, zvec4i b)        { return _mm_add_epi32(a, b); }
+static inline zvec4i zmath__v4i_sub(zvec4i a, zvec4i b)        { return _mm_sub_epi32(a, b); }
+static inline zvec4i zmath__v4i_and(zvec4i a, zvec4i b)        { return _mm_and_si128(a, b); }
+static inline zvec4i zmath__v4i_or(zvec4i a, zvec4i b)         { return _mm_or_si128(a, b); }
+static inline zvec4i zmath__v4i_shl(zvec4i a, int n)           { return _mm_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+static inline zvec4i zmath__v4i_shr(zvec4i a, int n)           { return _mm_srl_epi32(a, _mm_cvtsi32_si128(n)); }
+static inline zvec4i zmath__v4f_as_v4i(zvec4f a)               { return _mm_castps_si128(a); }
+static inline zvec4f zmath__v4i_as_v4f(zvec4i a)               { return _mm_castsi128_ps(a); }
+static inline zvec4i zmath__v4f_to_v4i(zvec4f a)               { return _mm_cvttps_epi32(a); }
+static inline zvec4f zmath__v4i_to_v4f(zvec4i a)               { return _mm_cvtepi32_ps(a); }
+static inline zvec4i zmath__v4f_lt(zvec4f a, zvec4f b)         { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+static inline zvec4i zmath__v4f_gt(zvec4f a, zvec4f b)         { return _mm_castps_si128(_mm_cmpgt_ps(a, b)); }
+static inline zvec4i zmath__v4f_le(zvec4f a, zvec4f b)         { return _mm_castps_si128(_mm_cmple_ps(a, b)); }
+static inline void   zmath__v4i_store(int32_t* p, zvec4i v)    { _mm_storeu_si128((__m128i*)p, v); }
+static inline bool   zmath__v4i_any(zvec4i m)                  { return _mm_movemask_ps(_mm_castsi128_ps(m)) != 0; }
+
+static inline zvec4f zmath__v4f_select(zvec4i m, zvec4f a, zvec4f b)
 {
-    uint32_t u = zmath__float_as_uint(x);
-    return (u & 0x7F800000) == 0x7F800000 && (u & 0x007FFFFF) != 0;
+    __m128 mf = _mm_castsi128_ps(m);
+    return _mm_or_ps(_mm_and_ps(mf, a), _mm_andnot_ps(mf, b));
 }
 
-ZMATHDEF bool zmath_isinf(float x) 
+// Deinterleave 4 packed {x,y,z} records (12 floats) into x, y and z lanes.
+static inline void zmath__v4f_load3(const float* p, zvec4f* x, zvec4f* y, zvec4f* z)
 {
-    uint32_t u = zmath__float_as_uint(x);
-    return (u & 0x7FFFFFFF) == 0x7F800000;
+    __m128 a = _mm_loadu_ps(p);     // x0 y0 z0 x1
+    __m128 b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+    __m128 c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+    __m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2));
+    *x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(2, 0, 3, 0));
+    __m128 ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1));
+    bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3));
+    *y = _mm_shuffle_ps(ab, bc, _MM_SHUFFLE(2, 0, 2, 0));
+    ab = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2));
+    __m128 cc = _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 3, 0, 0));
+    *z = _mm_shuffle_ps(ab, cc, _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// Inverse of zmath__v4f_load3.
+static inline void zmath__v4f_store3(float* p, zvec4f x, zvec4f y, zvec4f z)
+{
+    __m128 xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 1, 0));  // x0 x1 y0 y0
+    __m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(0, 1, 0, 0));  // z0 z0 x1 x0
+    _mm_storeu_ps(p, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(0, 1, 0, 1));  // y1 y0 z1 z0
+    xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2));         // x2 x0 y2 y0
+    _mm_storeu_ps(p + 4, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(2, 0, 2, 0)));
+    zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(0, 3, 0, 2));         // z2 z0 x3 x0
+    yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(0, 3, 0, 3));         // y3 y0 z3 z0
+    _mm_storeu_ps(p + 8, _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+#elif defined(ZMATH_SIMD_NEON)
+
+typedef float32x4_t zvec4f;
+typedef int32x4_t   zvec4i;
+
+#define ZMATH__PIN_V4F(v) ZMATH__PIN(v)
+
+static inline zvec4f zmath_v4f_set1(float x)                   { return vdupq_n_f32(x); }
+static inline zvec4f zmath_v4f_load(const float* p)            { return vld1q_f32(p); }
+static inline void   zmath_v4f_store(float* p, zvec4f v)       { vst1q_f32(p, v); }
+static inline zvec4f zmath_v4f_add(zvec4f a, zvec4f b)         { return vaddq_f32(a, b); }
+static inline zvec4f zmath_v4f_sub(zvec4f a, zvec4f b)         { return vsubq_f32(a, b); }
+static inline zvec4f zmath_v4f_mul(zvec4f a, zvec4f b)         { return vmulq_f32(a, b); }
+static inline zvec4f zmath_v4f_min(zvec4f a, zvec4f b)         { return vminq_f32(a, b); }
+static inline zvec4f zmath_v4f_max(zvec4f a, zvec4f b)         { return vmaxq_f32(a, b); }
+
+static inline zvec4f zmath_v4f_div(zvec4f a, zvec4f b)
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vdivq_f32(a, b);
+#else
+    // ARMv7 has no vector divide: reciprocal estimate plus two Newton steps.
+    float32x4_t r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+#endif
+}
+
+// a * b + c, fused on AArch64.
+static inline zvec4f zmath_v4f_madd(zvec4f a, zvec4f b, zvec4f c)
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vfmaq_f32(c, a, b);
+#else
+    return vmlaq_f32(c, a, b);
+#endif
+}
+
+static inline zvec4i zmath__v4i_set1(int32_t x)                { return vdupq_n_s32(x); }
+static inline zvec4i zmath__v4i_add(zvec4i a, zvec4i b)        { return vaddq_s32(a, b); }
+static inline zvec4i zmath__v4i_sub(zvec4i a, zvec4i b)        { return vsubq_s32(a, b); }
+static inline zvec4i zmath__v4i_and(zvec4i a, zvec4i b)        { return vandq_s32(a, b); }
+static inline zvec4i zmath__v4i_or(zvec4i a, zvec4i b)         { return vorrq_s32(a, b); }
+static inline zvec4i zmath__v4f_as_v4i(zvec4f a)               { return vreinterpretq_s32_f32(a); }
+static inline zvec4f zmath__v4i_as_v4f(zvec4i a)               { return vreinterpretq_f32_s32(a); }
+static inline zvec4i zmath__v4f_to_v4i(zvec4f a)               { return vcvtq_s32_f32(a); }
+static inline zvec4f zmath__v4i_to_v4f(zvec4i a)               { return vcvtq_f32_s32(a); }
+static inline zvec4i zmath__v4f_lt(zvec4f a, zvec4f b)         { return vreinterpretq_s32_u32(vcltq_f32(a, b)); }
+static inline zvec4i zmath__v4f_gt(zvec4f a, zvec4f b)         { return vreinterpretq_s32_u32(vcgtq_f32(a, b)); }
+static inline zvec4i zmath__v4f_le(zvec4f a, zvec4f b)         { return vreinterpretq_s32_u32(vcleq_f32(a, b)); }
+static inline void   zmath__v4i_store(int32_t* p, zvec4i v)    { vst1q_s32(p, v); }
+
+// True if any lane of the mask is set. ARMv7 has no across-lanes max.
+static inline bool zmath__v4i_any(zvec4i m)
+{
+    uint32x2_t t = vorr_u32(vget_low_u32(vreinterpretq_u32_s32(m)), vget_high_u32(vreinterpretq_u32_s32(m)));
+    return (vget_lane_u32(t, 0) | vget_lane_u32(t, 1)) != 0;
+}
+
+// Logical shifts; vshlq takes a per-lane count, negative shifts right.
+static inline zvec4i zmath__v4i_shl(zvec4i a, int n)
+{
+    return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(a), vdupq_n_s32(n)));
+}
+
+static inline zvec4i zmath__v4i_shr(zvec4i a, int n)
+{
+    return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(a), vdupq_n_s32(-n)));
+}
+
+static inline zvec4f zmath__v4f_select(zvec4i m, zvec4f a, zvec4f b)
+{
+    return vbslq_f32(vreinterpretq_u32_s32(m), a, b);
+}
+
+static inline void zmath__v4f_load3(const float* p, zvec4f* x, zvec4f* y, zvec4f* z)
+{
+    float32x4x3_t v = vld3q_f32(p);
+    *x = v.val[0];
+    *y = v.val[1];
+    *z = v.val[2];
+}
+
+static inline void zmath__v4f_store3(float* p, zvec4f x, zvec4f y, zvec4f z)
+{
+    float32x4x3_t v;
+    v.val[0] = x;
+    v.val[1] = y;
+    v.val[2] = z;
+    vst3q_f32(p, v);
+}
+
+#else // ZMATH_SIMD_SCALAR
+
+typedef struct { float f[4]; } zvec4f;
+typedef struct { int32_t i[4]; } zvec4i;
+
+#define ZMATH__PIN_V4F(v) ZMATH__PIN_MEM(v)
+
+#define ZMATH__V4F_MAP(expr) zvec4f r; for (int k = 0; k < 4; k++) { r.f[k] = (expr); } return r
+#define ZMATH__V4I_MAP(expr) zvec4i r; for (int k = 0; k < 4; k++) { r.i[k] = (expr); } return r
+
+static inline zvec4f zmath_v4f_set1(float x)                   { ZMATH__V4F_MAP(x); }
+static inline zvec4f zmath_v4f_load(const float* p)            { ZMATH__V4F_MAP(p[k]); }
+static inline void   zmath_v4f_store(float* p, zvec4f v)       { for (int k = 0; k < 4; k++) { p[k] = v.f[k]; } }
+static inline zvec4f zmath_v4f_add(zvec4f a, zvec4f b)         { ZMATH__V4F_MAP(a.f[k] + b.f[k]); }
+static inline zvec4f zmath_v4f_sub(zvec4f a, zvec4f b)         { ZMATH__V4F_MAP(a.f[k] - b.f[k]); }
+static inline zvec4f zmath_v4f_mul(zvec4f a, zvec4f b)         { ZMATH__V4F_MAP(a.f[k] * b.f[k]); }
+static inline zvec4f zmath_v4f_div(zvec4f a, zvec4f b)         { ZMATH__V4F_MAP(a.f[k] / b.f[k]); }
+static inline zvec4f zmath_v4f_min(zvec4f a, zvec4f b)         { ZMATH__V4F_MAP(a.f[k] < b.f[k] ? a.f[k] : b.f[k]); }
+static inline zvec4f zmath_v4f_max(zvec4f a, zvec4f b)         { ZMATH__V4F_MAP(a.f[k] > b.f[k] ? a.f[k] : b.f[k]); }
+static inline zvec4f zmath_v4f_madd(zvec4f a, zvec4f b, zvec4f c) { ZMATH__V4F_MAP(a.f[k] * b.f[k] + c.f[k]); }
+
+static inline zvec4i zmath__v4i_set1(int32_t x)                { ZMATH__V4I_MAP(x); }
+static inline zvec4i zmath__v4i_add(zvec4i a, zvec4i b)        { ZMATH__V4I_MAP((int32_t)((uint32_t)a.i[k] + (uint32_t)b.i[k])); }
+static inline zvec4i zmath__v4i_sub(zvec4i a, zvec4i b)        { ZMATH__V4I_MAP((int32_t)((uint32_t)a.i[k] - (uint32_t)b.i[k])); }
+static inline zvec4i zmath__v4i_and(zvec4i a, zvec4i b)        { ZMATH__V4I_MAP(a.i[k] & b.i[k]); }
+static inline zvec4i zmath__v4i_or(zvec4i a, zvec4i b)         { ZMATH__V4I_MAP(a.i[k] | b.i[k]); }
+static inline zvec4i zmath__v4i_shl(zvec4i a, int n)           { ZMATH__V4I_MAP((int32_t)((uint32_t)a.i[k] << n)); }
+static inline zvec4i zmath__v4i_shr(zvec4i a, int n)           { ZMATH__V4I_MAP((int32_t)((uint32_t)a.i[k] >> n)); }
+static inline zvec4i zmath__v4f_lt(zvec4f a, zvec4f b)         { ZMATH__V4I_MAP(a.f[k] < b.f[k] ? -1 : 0); }
+static inline zvec4i zmath__v4f_gt(zvec4f a, zvec4f b)         { ZMATH__V4I_MAP(a.f[k] > b.f[k] ? -1 : 0); }
+static inline zvec4i zmath__v4f_le(zvec4f a, zvec4f b)         { ZMATH__V4I_MAP(a.f[k] <= b.f[k] ? -1 : 0); }
+static inline void   zmath__v4i_store(int32_t* p, zvec4i v)    { for (int k = 0; k < 4; k++) { p[k] = v.i[k]; } }
+static inline bool   zmath__v4i_any(zvec4i m)                  { return (m.i[0] | m.i[1] | m.i[2] | m.i[3]) != 0; }
+static inline zvec4f zmath__v4i_to_v4f(zvec4i a)               { ZMATH__V4F_MAP((float)a.i[k]); }
+
+static inline zvec4i zmath__v4f_as_v4i(zvec4f a)
+{
+    zvec4i r;
+    memcpy(&r, &a, sizeof(r));
+    return r;
+}
+
+static inline zvec4f zmath__v4i_as_v4f(zvec4i a)
+{
+    zvec4f r;
+    memcpy(&r, &a, sizeof(r));
+    return r;
+}
+
+// Out-of-range lanes give INT32_MIN, like cvttps2dq, instead of UB.
+static inline zvec4i zmath__v4f_to_v4i(zvec4f a)
+{
+    ZMATH__V4I_MAP((a.f[k] > -2147483648.0f && a.f[k] < 2147483648.0f) ? (int32_t)a.f[k] : INT32_MIN);
+}
+
+static inline zvec4f zmath__v4f_select(zvec4i m, zvec4f a, zvec4f b)
+{
+    ZMATH__V4F_MAP(m.i[k] ? a.f[k] : b.f[k]);
+}
+
+static inline void zmath__v4f_load3(const float* p, zvec4f* x, zvec4f* y, zvec4f* z)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        x->f[k] = p[3 * k];
+        y->f[k] = p[3 * k + 1];
+        z->f[k] = p[3 * k + 2];
+    }
+}
+
+static inline void zmath__v4f_store3(float* p, zvec4f x, zvec4f y, zvec4f z)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        p[3 * k] = x.f[k];
+        p[3 * k + 1] = y.f[k];
+        p[3 * k + 2] = z.f[k];
+    }
+}
+
+#undef ZMATH__V4F_MAP
+#undef ZMATH__V4I_MAP
+
+#endif
+
+// 4-wide math kernels.
+
+static inline zvec4f zmath__v4f_abs(zvec4f x)
+{
+    return zmath__v4i_as_v4f(zmath__v4i_and(zmath__v4f_as_v4i(x), zmath__v4i_set1(0x7FFFFFFF)));
+}
+
+// Nearest integer, ties to even, with the same 2^23 trick as zmath__rint_k.
+// Under -ffast-math the barrier keeps (x + m) - m from folding back to x.
+static inline zvec4f zmath__v4f_rint(zvec4f x)
+{
+    zvec4i sign = zmath__v4i_and(zmath__v4f_as_v4i(x), zmath__v4i_set1(INT32_MIN));
+    zvec4f limit = zmath_v4f_set1(ZMATH_NO_FRACT_LIMIT);
+    zvec4f m = zmath__v4i_as_v4f(zmath__v4i_or(zmath__v4f_as_v4i(limit), sign));
+    zvec4f t = zmath_v4f_add(x, m);
+    ZMATH__PIN_V4F(t);
+    zvec4f r = zmath_v4f_sub(t, m);
+    return zmath__v4f_select(zmath__v4f_lt(zmath__v4f_abs(x), limit), r, x);
+}
+
+// Like zmath__rint_int_k: |x| < 2^22 only.
+static inline zvec4i zmath__v4f_rint_int(zvec4f x)
+{
+    zvec4f t = zmath_v4f_add(x, zmath_v4f_set1(ZMATH__RINT_MAGIC));
+    return zmath__v4i_sub(zmath__v4f_as_v4i(t), zmath__v4i_set1(0x4B400000));
+}
+
+static inline zvec4f zmath_v4f_floor(zvec4f x)
+{
+    zvec4f r = zmath__v4f_rint(x);
+    return zmath__v4f_select(zmath__v4f_gt(r, x), zmath_v4f_sub(r, zmath_v4f_set1(1.0f)), r);
+}
+
+// Round half away from zero, like zmath_round.
+static inline zvec4f zmath_v4f_round(zvec4f x)
+{
+    zvec4i sign = zmath__v4i_and(zmath__v4f_as_v4i(x), zmath__v4i_set1(INT32_MIN));
+    zvec4f one = zmath__v4i_as_v4f(zmath__v4i_or(zmath__v4f_as_v4i(zmath_v4f_set1(1.0f)), sign));
+    zvec4f half = zmath_v4f_mul(one, zmath_v4f_set1(0.5f));
+    zvec4f h = zmath_v4f_add(x, half);
+
+    // Truncate h: step back toward zero where rint rounded away from it.
+    zvec4f r = zmath__v4f_rint(h);
+    zvec4f step = zmath__v4f_select(zmath__v4f_gt(zmath__v4f_abs(r), zmath__v4f_abs(h)), one, zmath_v4f_set1(0.0f));
+    r = zmath_v4f_sub(r, step);
+    return zmath__v4f_select(zmath__v4f_lt(zmath__v4f_abs(x), zmath_v4f_set1(ZMATH_NO_FRACT_LIMIT)), r, x);
+}
+
+// Same seed as the scalar kernels: the hardware estimate with
+// ZMATH_USE_HW_RSQRT (refined once on NEON, whose vrsqrte has 8 bits),
+// otherwise 0x5f3759df. The scalar backend always uses the bit trick. Zero
+// lanes keep the bit trick, as in zmath__rsqrt_seed_k.
+static inline zvec4f zmath__v4f_rsqrt_seed(zvec4f x)
+{
+    zvec4i i = zmath__v4f_as_v4i(x);
+    zvec4f t = zmath__v4i_as_v4f(zmath__v4i_sub(zmath__v4i_set1(0x5f3759df), zmath__v4i_shr(i, 1)));
+#if defined(ZMATH__HW_RSQRT_SSE) && (defined(ZMATH_SIMD_SSE2) || defined(ZMATH_SIMD_AVX2))
+    zvec4f y = _mm_rsqrt_ps(x);
+    return zmath__v4f_select(zmath__v4f_le(zmath__v4f_abs(x), zmath_v4f_set1(0.0f)), t, y);
+#elif defined(ZMATH__HW_RSQRT_NEON) && defined(ZMATH_SIMD_NEON)
+    zvec4f y = vrsqrteq_f32(x);
+    y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+    return zmath__v4f_select(zmath__v4f_le(zmath__v4f_abs(x), zmath_v4f_set1(0.0f)), t, y);
+#else
+    return t;
+#endif
+}
+
+static inline zvec4f zmath_v4f_invsqrt(zvec4f x)
+{
+    zvec4f xhalf = zmath_v4f_mul(zmath_v4f_set1(0.5f), x);
+    zvec4f y = zmath__v4f_rsqrt_seed(x);
+    zvec4f yy = zmath_v4f_mul(zmath_v4f_mul(xhalf, y), y);
+    return zmath_v4f_mul(y, zmath_v4f_sub(zmath_v4f_set1(1.5f), yy));
+}
+
+// Lanes at or past ZMATH__TAU_BIG are redone one at a time, like
+// zmath__reduce_tau_k; the check costs one compare while none are.
+static ZMATH__COLD zvec4f zmath__v4f_reduce_tau_big(zvec4f x, zvec4f r, zvec4i big)
+{
+    float xs[4], rs[4];
+    int32_t bits[4], m[4];
+    zmath_v4f_store(xs, x);
+    zmath_v4f_store(rs, r);
+    zmath__v4i_store(bits, zmath__v4f_as_v4i(x));
+    zmath__v4i_store(m, big);
+    for (int k = 0; k < 4; k++)
+    {
+        if (m[k])
+        {
+            rs[k] = zmath__reduce_tau_big_k(xs[k], (uint32_t)bits[k]);
+        }
+    }
+    r = zmath_v4f_load(rs);
+    return r;
+}
+
+static inline zvec4f zmath__v4f_reduce_tau(zvec4f x)
+{
+    zvec4f q = zmath__v4f_rint(zmath_v4f_mul(x, zmath_v4f_set1(1.0f / ZMATH_TAU)));
+    zvec4f r = zmath_v4f_sub(x, zmath_v4f_mul(q, zmath_v4f_set1(ZMATH__TAU_P1)));
+    ZMATH__PIN_V4F(r);
+    r = zmath_v4f_sub(r, zmath_v4f_mul(q, zmath_v4f_set1(ZMATH__TAU_P2)));
+    ZMATH__PIN_V4F(r);
+    r = zmath_v4f_sub(r, zmath_v4f_mul(q, zmath_v4f_set1(ZMATH__TAU_P3)));
+    zvec4i big = zmath__v4f_le(zmath_v4f_set1(ZMATH__TAU_BIG), zmath__v4f_abs(x));
+    if (zmath__v4i_any(big))
+    {
+        r = zmath__v4f_reduce_tau_big(x, r, big);
+    }
+    return r;
+}
+
+static inline zvec4f zmath__v4f_fold_half_pi(zvec4f x)
+{
+    zvec4f hp = zmath_v4f_set1(ZMATH_HALF_PI);
+    zvec4f nhp = zmath_v4f_set1(-ZMATH_HALF_PI);
+    x = zmath__v4f_select(zmath__v4f_gt(x, hp), zmath_v4f_sub(zmath_v4f_set1(ZMATH_PI), x), x);
+    return zmath__v4f_select(zmath__v4f_lt(x, nhp), zmath_v4f_sub(zmath_v4f_set1(-ZMATH_PI), x), x);
+}
+
+static inline zvec4f zmath__v4f_sin_poly(zvec4f x)
+{
+    zvec4f x2 = zmath_v4f_mul(x, x);
+    zvec4f p = zmath_v4f_madd(x2, zmath_v4f_set1(ZMATH_SIN_C3), zmath_v4f_set1(ZMATH_SIN_C2));
+    p = zmath_v4f_madd(x2, p, zmath_v4f_set1(ZMATH_SIN_C1));
+    p = zmath_v4f_madd(x2, p, zmath_v4f_set1(ZMATH_SIN_C0));
+    p = zmath_v4f_madd(x2, p, zmath_v4f_set1(1.0f));
+    return zmath_v4f_mul(x, p);
+}
+
+static inline zvec4f zmath_v4f_sin(zvec4f x)
+{
+    return zmath__v4f_sin_poly(zmath__v4f_fold_half_pi(zmath__v4f_reduce_tau(x)));
+}
+
+// cos(r) = sin(pi/2 - |r|) on the reduced argument, like zmath_cos.
+static inline zvec4f zmath_v4f_cos(zvec4f x)
+{
+    zvec4f r = zmath__v4f_abs(zmath__v4f_reduce_tau(x));
+    return zmath__v4f_sin_poly(zmath_v4f_sub(zmath_v4f_set1(ZMATH_HALF_PI), r));
+}
+
+static inline void zmath_v4f_sincos(zvec4f x, zvec4f* s, zvec4f* c)
+{
+    zvec4f r = zmath__v4f_reduce_tau(x);
+    *s = zmath__v4f_sin_poly(zmath__v4f_fold_half_pi(r));
+    *c = zmath__v4f_sin_poly(zmath_v4f_sub(zmath_v4f_set1(ZMATH_HALF_PI), zmath__v4f_abs(r)));
+}
+
+static inline zvec4f zmath_v4f_atan(zvec4f x)
+{
+    zvec4i sign = zmath__v4i_and(zmath__v4f_as_v4i(x), zmath__v4i_set1(INT32_MIN));
+    x = zmath__v4f_abs(x);
+    zvec4i complement = zmath__v4f_gt(x, zmath_v4f_set1(1.0f));
+    x = zmath__v4f_select(complement, zmath_v4f_div(zmath_v4f_set1(1.0f), x), x);
+
+    zvec4f x2 = zmath_v4f_mul(x, x);
+    zvec4f p = zmath_v4f_madd(x2, zmath_v4f_set1(ZMATH_ATAN_C5), zmath_v4f_set1(ZMATH_ATAN_C4));
+    p = zmath_v4f_madd(x2, p, zmath_v4f_set1(ZMATH_ATAN_C3));
+    p = zmath_v4f_madd(x2, p, zmath_v4f_set1(ZMATH_ATAN_C2));
+    p = zmath_v4f_madd(x2, p, zmath_v4f_set1(ZMATH_ATAN_C1));
+    p = zmath_v4f_madd(x2, p, zmath_v4f_set1(ZMATH_ATAN_C0));
+    zvec4f y = zmath_v4f_mul(x, p);
+    y = zmath__v4f_select(complement, zmath_v4f_sub(zmath_v4f_set1(ZMATH_HALF_PI), y), y);
+    return zmath__v4i_as_v4f(zmath__v4i_or(zmath__v4f_as_v4i(y), sign));
+}
+
+static inline zvec4f zmath_v4f_exp(zvec4f x)
+{
+    zvec4f px = zmath_v4f_mul(x, zmath_v4f_set1(1.44269504088f));
+    zvec4i k = zmath__v4f_rint_int(px);
+    zvec4f r = zmath_v4f_mul(zmath_v4f_sub(px, zmath__v4i_to_v4f(k)), zmath_v4f_set1(0.69314718056f));
+    zvec4f r2 = zmath_v4f_mul(r, r);
+    zvec4f f = zmath_v4f_madd(r2, zmath_v4f_set1(0.5f), zmath_v4f_add(zmath_v4f_set1(1.0f), r));
+    f = zmath_v4f_madd(zmath_v4f_mul(r, r2), zmath_v4f_set1(0.16666666f), f);
+    zvec4i bits = zmath__v4i_add(zmath__v4f_as_v4i(f), zmath__v4i_shl(k, 23));
+    zvec4f res = zmath__v4i_as_v4f(bits);
+#ifndef ZMATH_FAST_MATH
+    zvec4f lo = zmath_v4f_set1(ZMATH__EXP_LO), hi = zmath_v4f_set1(ZMATH__EXP_HI);
+    res = zmath__v4f_select(zmath__v4f_lt(x, lo), zmath_v4f_set1(0.0f), res);
+    res = zmath__v4f_select(zmath__v4f_lt(x, hi), res, zmath_v4f_mul(x, zmath_v4f_set1(ZMATH_INFINITY)));
+#endif
+    return res;
+}
+
+static inline zvec4f zmath_v4f_log(zvec4f x)
+{
+#ifndef ZMATH_FAST_MATH
+    zvec4i sub = zmath__v4f_lt(x, zmath_v4f_set1(ZMATH__FLT_MIN));
+    zvec4i ix = zmath__v4f_as_v4i(zmath__v4f_select(sub, zmath_v4f_mul(x, zmath_v4f_set1(8388608.0f)), x));
+    zvec4f bias = zmath__v4f_select(sub, zmath_v4f_set1(-23.0f), zmath_v4f_set1(0.0f));
+#else
+    zvec4i ix = zmath__v4f_as_v4i(x);
+    zvec4f bias = zmath_v4f_set1(0.0f);
+#endif
+    zvec4i e = zmath__v4i_and(zmath__v4i_shr(ix, 23), zmath__v4i_set1(0xFF));
+    zvec4f exponent = zmath_v4f_add(zmath__v4i_to_v4f(zmath__v4i_sub(e, zmath__v4i_set1(127))), bias);
+    ix = zmath__v4i_or(zmath__v4i_and(ix, zmath__v4i_set1(0x007FFFFF)), zmath__v4i_set1(0x3F800000));
+    zvec4f m = zmath__v4i_as_v4f(ix);
+
+    zvec4f one = zmath_v4f_set1(1.0f);
+    zvec4f z = zmath_v4f_div(zmath_v4f_sub(m, one), zmath_v4f_add(m, one));
+    zvec4f z2 = zmath_v4f_mul(z, z);
+    zvec4f p = zmath_v4f_madd(z2, zmath_v4f_set1(0.28571428f), zmath_v4f_set1(0.4f));
+    p = zmath_v4f_madd(z2, p, zmath_v4f_set1(0.66666666f));
+    p = zmath_v4f_madd(z2, p, zmath_v4f_set1(2.0f));
+    zvec4f r = zmath_v4f_madd(exponent, zmath_v4f_set1(ZMATH_LN2), zmath_v4f_mul(z, p));
+#ifndef ZMATH_FAST_MATH
+    r = zmath__v4f_select(zmath__v4f_lt(x, zmath_v4f_set1(ZMATH_INFINITY)), r, x);
+#endif
+    return zmath__v4f_select(zmath__v4f_le(x, zmath_v4f_set1(0.0f)), zmath_v4f_set1(-ZMATH_INFINITY), r);
+}
+
+#ifdef ZMATH_SIMD_AVX2
+
+typedef __m256  zvec8f;
+typedef __m256i zvec8i;
+
+#define ZMATH__PIN_V8F(v) ZMATH__PIN(v)
+
+static inline zvec8f zmath_v8f_set1(float x)                   { return _mm256_set1_ps(x); }
+static inline zvec8f zmath_v8f_load(const float* p)            { return _mm256_loadu_ps(p); }
+static inline void   zmath_v8f_store(float* p, zvec8f v)       { _mm256_storeu_ps(p, v); }
+static inline zvec8f zmath_v8f_add(zvec8f a, zvec8f b)         { return _mm256_add_ps(a, b); }
+static inline zvec8f zmath_v8f_sub(zvec8f a, zvec8f b)         { return _mm256_sub_ps(a, b); }
+static inline zvec8f zmath_v8f_mul(zvec8f a, zvec8f b)         { return _mm256_mul_ps(a, b); }
+static inline zvec8f zmath_v8f_div(zvec8f a, zvec8f b)         { return _mm256_div_ps(a, b); }
+static inline zvec8f zmath_v8f_min(zvec8f a, zvec8f b)         { return _mm256_min_ps(a, b); }
+static inline zvec8f zmath_v8f_max(zvec8f a, zvec8f b)         { return _mm256_max_ps(a, b); }
+static inline zvec8f zmath_v8f_madd(zvec8f a, zvec8f b, zvec8f c) { return _mm256_fmadd_ps(a, b, c); }
+
+static inline zvec8i zmath__v8i_set1(int32_t x)                { return _mm256_set1_epi32(x); }
+static inline zvec8i zmath__v8i_add(zvec8i a, zvec8i b)        { return _mm256_add_epi32(a, b); }
+static inline zvec8i zmath__v8i_sub(zvec8i a, zvec8i b)        { return _mm256_sub_epi32(a, b); }
+static inline zvec8i zmath__v8i_and(zvec8i a, zvec8i b)        { return _mm256_and_si256(a, b); }
+static inline zvec8i zmath__v8i_or(zvec8i a, zvec8i b)         { return _mm256_or_si256(a, b); }
+static inline zvec8i zmath__v8i_shl(zvec8i a, int n)           { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+static inline zvec8i zmath__v8i_shr(zvec8i a, int n)           { return _mm256_srl_epi32(a, _mm_cvtsi32_si128(n)); }
+static inline zvec8i zmath__v8f_as_v8i(zvec8f a)               { return _mm256_castps_si256(a); }
+static inline zvec8f zmath__v8i_as_v8f(zvec8i a)               { return _mm256_castsi256_ps(a); }
+static inline zvec8i zmath__v8f_to_v8i(zvec8f a)               { return _mm256_cvttps_epi32(a); }
+static inline zvec8f zmath__v8i_to_v8f(zvec8i a)               { return _mm256_cvtepi32_ps(a); }
+static inline zvec8i zmath__v8f_lt(zvec8f a, zvec8f b)         { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+static inline zvec8i zmath__v8f_gt(zvec8f a, zvec8f b)         { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+static inline zvec8i zmath__v8f_le(zvec8f a, zvec8f b)         { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LE_OQ)); }
+static inline void   zmath__v8i_store(int32_t* p, zvec8i v)    { _mm256_storeu_si256((__m256i*)p, v); }
+static inline bool   zmath__v8i_any(zvec8i m)                  { return _mm256_movemask_ps(_mm256_castsi256_ps(m)) != 0; }
+
+static inline zvec8f zmath__v8f_select(zvec8i m, zvec8f a, zvec8f b)
+{
+    return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(m));
+}
+
+// 8-wide math kernels. Same sequences as the 4-wide ones above.
+
+static inline zvec8f zmath__v8f_abs(zvec8f x)
+{
+    return zmath__v8i_as_v8f(zmath__v8i_and(zmath__v8f_as_v8i(x), zmath__v8i_set1(0x7FFFFFFF)));
+}
+
+static inline zvec8f zmath__v8f_rint(zvec8f x)
+{
+    zvec8i sign = zmath__v8i_and(zmath__v8f_as_v8i(x), zmath__v8i_set1(INT32_MIN));
+    zvec8f limit = zmath_v8f_set1(ZMATH_NO_FRACT_LIMIT);
+    zvec8f m = zmath__v8i_as_v8f(zmath__v8i_or(zmath__v8f_as_v8i(limit), sign));
+    zvec8f t = zmath_v8f_add(x, m);
+    ZMATH__PIN_V8F(t);
+    zvec8f r = zmath_v8f_sub(t, m);
+    return zmath__v8f_select(zmath__v8f_lt(zmath__v8f_abs(x), limit), r, x);
+}
+
+static inline zvec8i zmath__v8f_rint_int(zvec8f x)
+{
+    zvec8f t = zmath_v8f_add(x, zmath_v8f_set1(ZMATH__RINT_MAGIC));
+    return zmath__v8i_sub(zmath__v8f_as_v8i(t), zmath__v8i_set1(0x4B400000));
+}
+
+static inline zvec8f zmath_v8f_floor(zvec8f x)
+{
+    zvec8f r = zmath__v8f_rint(x);
+    return zmath__v8f_select(zmath__v8f_gt(r, x), zmath_v8f_sub(r, zmath_v8f_set1(1.0f)), r);
+}
+
+static inline zvec8f zmath_v8f_round(zvec8f x)
+{
+    zvec8i sign = zmath__v8i_and(zmath__v8f_as_v8i(x), zmath__v8i_set1(INT32_MIN));
+    zvec8f one = zmath__v8i_as_v8f(zmath__v8i_or(zmath__v8f_as_v8i(zmath_v8f_set1(1.0f)), sign));
+    zvec8f half = zmath_v8f_mul(one, zmath_v8f_set1(0.5f));
+    zvec8f h = zmath_v8f_add(x, half);
+
+    // Truncate h: step back toward zero where rint rounded away from it.
+    zvec8f r = zmath__v8f_rint(h);
+    zvec8f step = zmath__v8f_select(zmath__v8f_gt(zmath__v8f_abs(r), zmath__v8f_abs(h)), one, zmath_v8f_set1(0.0f));
+    r = zmath_v8f_sub(r, step);
+    return zmath__v8f_select(zmath__v8f_lt(zmath__v8f_abs(x), zmath_v8f_set1(ZMATH_NO_FRACT_LIMIT)), r, x);
+}
+
+static inline zvec8f zmath__v8f_rsqrt_seed(zvec8f x)
+{
+    zvec8i i = zmath__v8f_as_v8i(x);
+    zvec8f t = zmath__v8i_as_v8f(zmath__v8i_sub(zmath__v8i_set1(0x5f3759df), zmath__v8i_shr(i, 1)));
+#ifdef ZMATH__HW_RSQRT_SSE
+    zvec8f y = _mm256_rsqrt_ps(x);
+    return zmath__v8f_select(zmath__v8f_le(zmath__v8f_abs(x), zmath_v8f_set1(0.0f)), t, y);
+#else
+    return t;
+#endif
+}
+
+static inline zvec8f zmath_v8f_invsqrt(zvec8f x)
+{
+    zvec8f xhalf = zmath_v8f_mul(zmath_v8f_set1(0.5f), x);
+    zvec8f y = zmath__v8f_rsqrt_seed(x);
+    zvec8f yy = zmath_v8f_mul(zmath_v8f_mul(xhalf, y), y);
+    return zmath_v8f_mul(y, zmath_v8f_sub(zmath_v8f_set1(1.5f), yy));
+}
+
+static ZMATH__COLD zvec8f zmath__v8f_reduce_tau_big(zvec8f x, zvec8f r, zvec8i big)
+{
+    float xs[8], rs[8];
+    int32_t bits[8], m[8];
+    zmath_v8f_store(xs, x);
+    zmath_v8f_store(rs, r);
+    zmath__v8i_store(bits, zmath__v8f_as_v8i(x));
+    zmath__v8i_store(m, big);
+    for (int k = 0; k < 8; k++)
+    {
+        if (m[k])
+        {
+            rs[k] = zmath__reduce_tau_big_k(xs[k], (uint32_t)bits[k]);
+        }
+    }
+    r = zmath_v8f_load(rs);
+    return r;
+}
+
+static inline zvec8f zmath__v8f_reduce_tau(zvec8f x)
+{
+    zvec8f q = zmath__v8f_rint(zmath_v8f_mul(x, zmath_v8f_set1(1.0f / ZMATH_TAU)));
+    zvec8f r = zmath_v8f_sub(x, zmath_v8f_mul(q, zmath_v8f_set1(ZMATH__TAU_P1)));
+    ZMATH__PIN_V8F(r);
+    r = zmath_v8f_sub(r, zmath_v8f_mul(q, zmath_v8f_set1(ZMATH__TAU_P2)));
+    ZMATH__PIN_V8F(r);
+    r = zmath_v8f_sub(r, zmath_v8f_mul(q, zmath_v8f_set1(ZMATH__TAU_P3)));
+    zvec8i big = zmath__v8f_le(zmath_v8f_set1(ZMATH__TAU_BIG), zmath__v8f_abs(x));
+    if (zmath__v8i_any(big))
+    {
+        r = zmath__v8f_reduce_tau_big(x, r, big);
+    }
+    return r;
+}
+
+static inline zvec8f zmath__v8f_fold_half_pi(zvec8f x)
+{
+    zvec8f hp = zmath_v8f_set1(ZMATH_HALF_PI);
+    zvec8f nhp = zmath_v8f_set1(-ZMATH_HALF_PI);
+    x = zmath__v8f_select(zmath__v8f_gt(x, hp), zmath_v8f_sub(zmath_v8f_set1(ZMATH_PI), x), x);
+    return zmath__v8f_select(zmath__v8f_lt(x, nhp), zmath_v8f_sub(zmath_v8f_set1(-ZMATH_PI), x), x);
+}
+
+static inline zvec8f zmath__v8f_sin_poly(zvec8f x)
+{
+    zvec8f x2 = zmath_v8f_mul(x, x);
+    zvec8f p = zmath_v8f_madd(x2, zmath_v8f_set1(ZMATH_SIN_C3), zmath_v8f_set1(ZMATH_SIN_C2));
+    p = zmath_v8f_madd(x2, p, zmath_v8f_set1(ZMATH_SIN_C1));
+    p = zmath_v8f_madd(x2, p, zmath_v8f_set1(ZMATH_SIN_C0));
+    p = zmath_v8f_madd(x2, p, zmath_v8f_set1(1.0f));
+    return zmath_v8f_mul(x, p);
+}
+
+static inline zvec8f zmath_v8f_sin(zvec8f x)
+{
+    return zmath__v8f_sin_poly(zmath__v8f_fold_half_pi(zmath__v8f_reduce_tau(x)));
+}
+
+static inline zvec8f zmath_v8f_cos(zvec8f x)
+{
+    zvec8f r = zmath__v8f_abs(zmath__v8f_reduce_tau(x));
+    return zmath__v8f_sin_poly(zmath_v8f_sub(zmath_v8f_set1(ZMATH_HALF_PI), r));
+}
+
+static inline void zmath_v8f_sincos(zvec8f x, zvec8f* s, zvec8f* c)
+{
+    zvec8f r = zmath__v8f_reduce_tau(x);
+    *s = zmath__v8f_sin_poly(zmath__v8f_fold_half_pi(r));
+    *c = zmath__v8f_sin_poly(zmath_v8f_sub(zmath_v8f_set1(ZMATH_HALF_PI), zmath__v8f_abs(r)));
+}
+
+static inline zvec8f zmath_v8f_atan(zvec8f x)
+{
+    zvec8i sign = zmath__v8i_and(zmath__v8f_as_v8i(x), zmath__v8i_set1(INT32_MIN));
+    x = zmath__v8f_abs(x);
+    zvec8i complement = zmath__v8f_gt(x, zmath_v8f_set1(1.0f));
+    x = zmath__v8f_select(complement, zmath_v8f_div(zmath_v8f_set1(1.0f), x), x);
+
+    zvec8f x2 = zmath_v8f_mul(x, x);
+    zvec8f p = zmath_v8f_madd(x2, zmath_v8f_set1(ZMATH_ATAN_C5), zmath_v8f_set1(ZMATH_ATAN_C4));
+    p = zmath_v8f_madd(x2, p, zmath_v8f_set1(ZMATH_ATAN_C3));
+    p = zmath_v8f_madd(x2, p, zmath_v8f_set1(ZMATH_ATAN_C2));
+    p = zmath_v8f_madd(x2, p, zmath_v8f_set1(ZMATH_ATAN_C1));
+    p = zmath_v8f_madd(x2, p, zmath_v8f_set1(ZMATH_ATAN_C0));
+    zvec8f y = zmath_v8f_mul(x, p);
+    y = zmath__v8f_select(complement, zmath_v8f_sub(zmath_v8f_set1(ZMATH_HALF_PI), y), y);
+    return zmath__v8i_as_v8f(zmath__v8i_or(zmath__v8f_as_v8i(y), sign));
+}
+
+static inline zvec8f zmath_v8f_exp(zvec8f x)
+{
+    zvec8f px = zmath_v8f_mul(x, zmath_v8f_set1(1.44269504088f));
+    zvec8i k = zmath__v8f_rint_int(px);
+    zvec8f r = zmath_v8f_mul(zmath_v8f_sub(px, zmath__v8i_to_v8f(k)), zmath_v8f_set1(0.69314718056f));
+    zvec8f r2 = zmath_v8f_mul(r, r);
+    zvec8f f = zmath_v8f_madd(r2, zmath_v8f_set1(0.5f), zmath_v8f_add(zmath_v8f_set1(1.0f), r));
+    f = zmath_v8f_madd(zmath_v8f_mul(r, r2), zmath_v8f_set1(0.16666666f), f);
+    zvec8i bits = zmath__v8i_add(zmath__v8f_as_v8i(f), zmath__v8i_shl(k, 23));
+    zvec8f res = zmath__v8i_as_v8f(bits);
+#ifndef ZMATH_FAST_MATH
+    zvec8f lo = zmath_v8f_set1(ZMATH__EXP_LO), hi = zmath_v8f_set1(ZMATH__EXP_HI);
+    res = zmath__v8f_select(zmath__v8f_lt(x, lo), zmath_v8f_set1(0.0f), res);
+    res = zmath__v8f_select(zmath__v8f_lt(x, hi), res, zmath_v8f_mul(x, zmath_v8f_set1(ZMATH_INFINITY)));
+#endif
+    return res;
+}
+
+static inline zvec8f zmath_v8f_log(zvec8f x)
+{
+#ifndef ZMATH_FAST_MATH
+    zvec8i sub = zmath__v8f_lt(x, zmath_v8f_set1(ZMATH__FLT_MIN));
+    zvec8i ix = zmath__v8f_as_v8i(zmath__v8f_select(sub, zmath_v8f_mul(x, zmath_v8f_set1(8388608.0f)), x));
+    zvec8f bias = zmath__v8f_select(sub, zmath_v8f_set1(-23.0f), zmath_v8f_set1(0.0f));
+#else
+    zvec8i ix = zmath__v8f_as_v8i(x);
+    zvec8f bias = zmath_v8f_set1(0.0f);
+#endif
+    zvec8i e = zmath__v8i_and(zmath__v8i_shr(ix, 23), zmath__v8i_set1(0xFF));
+    zvec8f exponent = zmath_v8f_add(zmath__v8i_to_v8f(zmath__v8i_sub(e, zmath__v8i_set1(127))), bias);
+    ix = zmath__v8i_or(zmath__v8i_and(ix, zmath__v8i_set1(0x007FFFFF)), zmath__v8i_set1(0x3F800000));
+    zvec8f m = zmath__v8i_as_v8f(ix);
+
+    zvec8f one = zmath_v8f_set1(1.0f);
+    zvec8f z = zmath_v8f_div(zmath_v8f_sub(m, one), zmath_v8f_add(m, one));
+    zvec8f z2 = zmath_v8f_mul(z, z);
+    zvec8f p = zmath_v8f_madd(z2, zmath_v8f_set1(0.28571428f), zmath_v8f_set1(0.4f));
+    p = zmath_v8f_madd(z2, p, zmath_v8f_set1(0.66666666f));
+    p = zmath_v8f_madd(z2, p, zmath_v8f_set1(2.0f));
+    zvec8f r = zmath_v8f_madd(exponent, zmath_v8f_set1(ZMATH_LN2), zmath_v8f_mul(z, p));
+#ifndef ZMATH_FAST_MATH
+    r = zmath__v8f_select(zmath__v8f_lt(x, zmath_v8f_set1(ZMATH_INFINITY)), r, x);
+#endif
+    return zmath__v8f_select(zmath__v8f_le(x, zmath_v8f_set1(0.0f)), zmath_v8f_set1(-ZMATH_INFINITY), r);
+}
+
+#endif // ZMATH_SIMD_AVX2
+
+#endif // ZMATH_SIMD
+
+// Optional short names.
+#ifdef ZMATH_SHORT_NAMES
+    // Constants.
+#   ifndef PI
+#   define PI          ZMATH_PI
+#   endif
+#   define TAU         ZMATH_TAU
+#   define EPSILON     ZMATH_EPSILON
+#   define SQRT2       ZMATH_SQRT2
+
+    // Types.
+    typedef zvec2       vec2;
+    typedef zvec3       vec3;
+    typedef zvec3d      vec3d;
+    typedef zfix        fix;
+    typedef zvec2fx     vec2fx;
+    typedef zvec3fx     vec3fx;
+    typedef zvec3_soa   vec3_soa;
+    typedef zmat3       mat3;
+    typedef zmat4       mat4;
+    typedef zquat       quat;
+    typedef zrng        rng;
+    typedef zaabb       aabb;
+    typedef zsphere     sphere;
+    typedef zray        ray;
+    typedef zplane      plane;
+    typedef zfft_plan   fft_plan;
+    typedef zarena      arena;
+    typedef zfp_state   fp_state;
+
+    // Logic, we undefine standard macros if they exist.
+#   ifdef isnan
+#   undef isnan
+#   endif
+#   define isnan       zmath_isnan
+
+#   ifdef isinf
+#   undef isinf
+#   endif
+#   define isinf       zmath_isinf
+
+#   define is_near     zmath_is_near
+    
+    // Interpolation.
+#   define step        zmath_step
+#   define smoothstep  zmath_smoothstep
+#   define smootherstep zmath_smootherstep
+#   define lerp        zmath_lerp
+#   define inv_lerp    zmath_inv_lerp
+#   define remap       zmath_remap
+    
+    // Arithmetic.
+#   define abs         zmath_abs
+#   define min         zmath_min
+#   define max         zmath_max
+#   define clamp       zmath_clamp
+#   define sign        zmath_sign
+#   define copysign    zmath_copysign
+    
+    // Rounding.
+#   define floor       zmath_floor
+#   define ceil        zmath_ceil
+#   define round       zmath_round
+#   define fract       zmath_fract
+#   define fmod        zmath_fmod
+#   define mod         zmath_mod
+    
+    // Power.
+#   define sqrt        zmath_sqrt
+#   define invsqrt     zmath_invsqrt
+#   define rsqrt_n     zmath_rsqrt_n
+#   define rcp         zmath_rcp
+#   define hypot       zmath_hypot
+#   define log         zmath_log
+#   define log2        zmath_log2
+#   define pow         zmath_pow
+#   define exp         zmath_exp
+#   define exp2        zmath_exp2
+    
+    // Trig.
+#   ifdef sin
+#   undef sin
+#   endif
+#   define sin         zmath_sin
+
+#   ifdef cos
+#   undef cos
+#   endif
+#   define cos         zmath_cos
+
+#   ifdef tan
+#   undef tan
+#   endif
+#   define tan         zmath_tan
+
+#   ifdef asin
+#   undef asin
+#   endif
+#   define asin        zmath_asin
+
+#   ifdef acos
+#   undef acos
+#   endif
+#   define acos        zmath_acos
+
+#   ifdef atan
+#   undef atan
+#   endif
+#   define atan        zmath_atan
+
+#   ifdef atan2
+#   undef atan2
+#   endif
+#   define atan2       zmath_atan2
+
+#   define sincos      zmath_sincos
+
+#   define deg2rad     zmath_deg2rad
+#   define rad2deg     zmath_rad2deg
+#   define sin_turns   zmath_sin_turns
+#   define cos_turns   zmath_cos_turns
+#   define sincos_turns zmath_sincos_turns
+
+    // Accuracy tiers.
+#   define sin_fast    zmath_sin_fast
+#   define cos_fast    zmath_cos_fast
+#   define sincos_fast zmath_sincos_fast
+#   define exp_fast    zmath_exp_fast
+#   define log_fast    zmath_log_fast
+#   define invsqrt_fast zmath_invsqrt_fast
+#   define sin_precise zmath_sin_precise
+#   define cos_precise zmath_cos_precise
+#   define sincos_precise zmath_sincos_precise
+#   define exp_precise zmath_exp_precise
+#   define log_precise zmath_log_precise
+#   define invsqrt_precise zmath_invsqrt_precise
+
+#   ifdef ZMATH_TRIG_LUT
+    // Table-driven trigonometry.
+#   define sin_lut     zmath_sin_lut
+#   define cos_lut     zmath_cos_lut
+#   define sin_turn    zmath_sin_turn
+#   define cos_turn    zmath_cos_turn
+#   define rad2turn    zmath_rad2turn
+#   define sin_turn_fill zmath_sin_turn_fill
+#   endif
+
+    // Vector 2.
+#   define v2_add      zmath_v2_add
+#   define v2_sub      zmath_v2_sub
+#   define v2_scale    zmath_v2_scale
+#   define v2_dot      zmath_v2_dot
+#   define v2_len      zmath_v2_len
+#   define v2_norm     zmath_v2_norm
+
+    // Vector 3.
+#   define v3_add      zmath_v3_add
+#   define v3_sub      zmath_v3_sub
+#   define v3_scale    zmath_v3_scale
+#   define v3_dot      zmath_v3_dot
+#   define v3_cross    zmath_v3_cross
+#   define v3_len      zmath_v3_len
+#   define v3_norm     zmath_v3_norm
+
+    // Vector 3 streams.
+#   define v3_soa_add   zmath_v3_soa_add
+#   define v3_soa_sub   zmath_v3_soa_sub
+#   define v3_soa_scale zmath_v3_soa_scale
+#   define v3_soa_lerp zmath_v3_soa_lerp
+#   define v3_soa_dot   zmath_v3_soa_dot
+#   define v3_soa_cross zmath_v3_soa_cross
+#   define v3_soa_len   zmath_v3_soa_len
+#   define v3_soa_norm  zmath_v3_soa_norm
+#   define v3_aos_to_soa zmath_v3_aos_to_soa
+#   define v3_soa_to_aos zmath_v3_soa_to_aos
+
+    // Matrices.
+#   define m3_identity  zmath_m3_identity
+#   define m3_mul       zmath_m3_mul
+#   define m3_transpose zmath_m3_transpose
+#   define m3_inverse   zmath_m3_inverse
+#   define m3_mul_v3    zmath_m3_mul_v3
+#   define m3_from_m4   zmath_m3_from_m4
+#   define m4_identity  zmath_m4_identity
+#   define m4_translation zmath_m4_translation
+#   define m4_scaling   zmath_m4_scaling
+#   define m4_mul       zmath_m4_mul
+#   define m4_transpose zmath_m4_transpose
+#   define m4_inverse   zmath_m4_inverse
+#   define m4_inverse_affine zmath_m4_inverse_affine
+#   define m4_transform_point zmath_m4_transform_point
+#   define m4_transform_dir zmath_m4_transform_dir
+#   define m4_transform_points zmath_m4_transform_points
+#   define m4_transform_dirs zmath_m4_transform_dirs
+#   define m4_transform_points_soa zmath_m4_transform_points_soa
+
+    // Quaternions.
+#   define q_identity  zmath_q_identity
+#   define q_from_axis_angle zmath_q_from_axis_angle
+#   define q_mul       zmath_q_mul
+#   define q_conj      zmath_q_conj
+#   define q_dot       zmath_q_dot
+#   define q_norm      zmath_q_norm
+#   define q_rotate    zmath_q_rotate
+#   define q_nlerp     zmath_q_nlerp
+#   define q_slerp     zmath_q_slerp
+#   define q_to_m4     zmath_q_to_m4
+#   define q_nlerp_array zmath_q_nlerp_array
+#   define q_slerp_array zmath_q_slerp_array
+#   define q_blend_poses zmath_q_blend_poses
+
+    // Geometry.
+#   define plane_from_point_normal zmath_plane_from_point_normal
+#   define plane_dist  zmath_plane_dist
+#   define aabb_contains zmath_aabb_contains
+#   define aabb_overlap zmath_aabb_overlap
+#   define sphere_aabb_overlap zmath_sphere_aabb_overlap
+#   define ray_aabb    zmath_ray_aabb
+#   define ray_sphere  zmath_ray_sphere
+#   define frustum_from_m4 zmath_frustum_from_m4
+#   define frustum_sphere zmath_frustum_sphere
+#   define frustum_aabb zmath_frustum_aabb
+#   define frustum_cull_spheres zmath_frustum_cull_spheres
+#   define frustum_cull_aabbs zmath_frustum_cull_aabbs
+#   define ray_aabb_soa zmath_ray_aabb_soa
+#   define mask_compact zmath_mask_compact
+
+    // Batch kernels.
+#   define sin_array   zmath_sin_array
+#   define cos_array   zmath_cos_array
+#   define tan_array   zmath_tan_array
+#   define sincos_array zmath_sincos_array
+#   define asin_array  zmath_asin_array
+#   define acos_array  zmath_acos_array
+#   define atan_array  zmath_atan_array
+#   define atan2_array zmath_atan2_array
+#   define exp_array   zmath_exp_array
+#   define exp2_array  zmath_exp2_array
+#   define log_array   zmath_log_array
+#   define log2_array  zmath_log2_array
+#   define pow_array   zmath_pow_array
+#   define sqrt_array  zmath_sqrt_array
+#   define invsqrt_array zmath_invsqrt_array
+
+    // Reductions.
+#   define sum_array   zmath_sum_array
+#   define sum_kahan_array zmath_sum_kahan_array
+#   define sum_sq_array zmath_sum_sq_array
+#   define dot_array   zmath_dot_array
+#   define len_array   zmath_len_array
+#   define min_array   zmath_min_array
+#   define max_array   zmath_max_array
+#   define argmin_array zmath_argmin_array
+#   define argmax_array zmath_argmax_array
+#   define v3_bounds   zmath_v3_bounds
+#   define v3_soa_bounds zmath_v3_soa_bounds
+
+    // Interpolation batches.
+#   define lerp_array  zmath_lerp_array
+#   define inv_lerp_array zmath_inv_lerp_array
+#   define remap_array zmath_remap_array
+#   define clamp_array zmath_clamp_array
+#   define smoothstep_array zmath_smoothstep_array
+#   define smootherstep_array zmath_smootherstep_array
+#   define v2_lerp_array zmath_v2_lerp_array
+#   define v3_lerp_array zmath_v3_lerp_array
+
+    // Random numbers.
+#   define rng_seed    zmath_rng_seed
+#   define rng_jump    zmath_rng_jump
+#   define rng_long_jump zmath_rng_long_jump
+#   define rng_split   zmath_rng_split
+#   define rng_u32     zmath_rng_u32
+#   define rng_float   zmath_rng_float
+#   define rng_range   zmath_rng_range
+#   define rng_fill_uniform zmath_rng_fill_uniform
+#   define rng_fill_normal zmath_rng_fill_normal
+#   define rng_fill_unit_vec3 zmath_rng_fill_unit_vec3
+#   define noise_value2  zmath_noise_value2
+#   define noise_value3  zmath_noise_value3
+#   define noise_perlin2 zmath_noise_perlin2
+#   define noise_perlin3 zmath_noise_perlin3
+#   define noise_simplex2 zmath_noise_simplex2
+#   define noise_simplex3 zmath_noise_simplex3
+#   define noise2_array  zmath_noise2_array
+#   define noise3_array  zmath_noise3_array
+#   define noise2_grid   zmath_noise2_grid
+
+    // Packing.
+#   define f32_to_f16    zmath_f32_to_f16
+#   define f16_to_f32    zmath_f16_to_f32
+#   define f32_to_snorm16 zmath_f32_to_snorm16
+#   define snorm16_to_f32 zmath_snorm16_to_f32
+#   define f32_to_unorm16 zmath_f32_to_unorm16
+#   define unorm16_to_f32 zmath_unorm16_to_f32
+#   define f32_to_snorm8 zmath_f32_to_snorm8
+#   define snorm8_to_f32 zmath_snorm8_to_f32
+#   define f32_to_unorm8 zmath_f32_to_unorm8
+#   define unorm8_to_f32 zmath_unorm8_to_f32
+#   define f32_to_f16_array zmath_f32_to_f16_array
+#   define f16_to_f32_array zmath_f16_to_f32_array
+#   define f32_to_snorm16_array zmath_f32_to_snorm16_array
+#   define snorm16_to_f32_array zmath_snorm16_to_f32_array
+#   define f32_to_unorm16_array zmath_f32_to_unorm16_array
+#   define unorm16_to_f32_array zmath_unorm16_to_f32_array
+#   define f32_to_snorm8_array zmath_f32_to_snorm8_array
+#   define snorm8_to_f32_array zmath_snorm8_to_f32_array
+#   define f32_to_unorm8_array zmath_f32_to_unorm8_array
+#   define unorm8_to_f32_array zmath_unorm8_to_f32_array
+
+    // Polynomials and curves.
+#   define poly        zmath_poly
+#   define poly_horner zmath_poly_horner
+#   define poly_array  zmath_poly_array
+#   define bezier3     zmath_bezier3
+#   define hermite     zmath_hermite
+#   define catmull_rom zmath_catmull_rom
+#   define v2_bezier3  zmath_v2_bezier3
+#   define v2_hermite  zmath_v2_hermite
+#   define v2_catmull_rom zmath_v2_catmull_rom
+#   define v3_bezier3  zmath_v3_bezier3
+#   define v3_hermite  zmath_v3_hermite
+#   define v3_catmull_rom zmath_v3_catmull_rom
+#   define curve_array zmath_curve_array
+#   define v2_curve_array zmath_v2_curve_array
+#   define v3_curve_array zmath_v3_curve_array
+
+    // FFT.
+#   define fft_init    zmath_fft_init
+#   define fft_real_init zmath_fft_real_init
+#   define fft         zmath_fft
+#   define ifft        zmath_ifft
+#   define fft_real    zmath_fft_real
+#   define ifft_real   zmath_ifft_real
+
+    // Angle tables.
+#   define sincos_table zmath_sincos_table
+#   define v2_rotate_sc zmath_v2_rotate_sc
+
+    // Denormal control.
+#   define ftz_begin   zmath_ftz_begin
+#   define ftz_end     zmath_ftz_end
+
+    // Double precision.
+#   define sqrt_d      zmath_sqrt_d
+#   define invsqrt_d   zmath_invsqrt_d
+#   define sin_d       zmath_sin_d
+#   define cos_d       zmath_cos_d
+#   define sincos_d    zmath_sincos_d
+#   define exp_d       zmath_exp_d
+#   define log_d       zmath_log_d
+#   define v3d_add     zmath_v3d_add
+#   define v3d_sub     zmath_v3d_sub
+#   define v3d_scale   zmath_v3d_scale
+#   define v3d_dot     zmath_v3d_dot
+#   define v3d_cross   zmath_v3d_cross
+#   define v3d_len     zmath_v3d_len
+#   define v3d_norm    zmath_v3d_norm
+#   define v3d_dist    zmath_v3d_dist
+#   define v3d_lerp    zmath_v3d_lerp
+#   define v3d_from_v3 zmath_v3d_from_v3
+#   define v3d_to_v3   zmath_v3d_to_v3
+#   define v3d_to_v3_rel zmath_v3d_to_v3_rel
+#   define sqrt_d_array zmath_sqrt_d_array
+#   define invsqrt_d_array zmath_invsqrt_d_array
+#   define sin_d_array zmath_sin_d_array
+#   define cos_d_array zmath_cos_d_array
+#   define sincos_d_array zmath_sincos_d_array
+#   define exp_d_array zmath_exp_d_array
+#   define log_d_array zmath_log_d_array
+
+    // Fixed point.
+#   define fix_from_int zmath_fix_from_int
+#   define fix_to_int  zmath_fix_to_int
+#   define fix_from_float zmath_fix_from_float
+#   define fix_to_float zmath_fix_to_float
+#   define fix_add     zmath_fix_add
+#   define fix_sub     zmath_fix_sub
+#   define fix_mul     zmath_fix_mul
+#   define fix_div     zmath_fix_div
+#   define fix_lerp    zmath_fix_lerp
+#   define fix_sqrt    zmath_fix_sqrt
+#   define fix_sin     zmath_fix_sin
+#   define fix_cos     zmath_fix_cos
+#   define fix_atan2   zmath_fix_atan2
+#   define v2fx_add    zmath_v2fx_add
+#   define v2fx_sub    zmath_v2fx_sub
+#   define v2fx_scale  zmath_v2fx_scale
+#   define v2fx_dot    zmath_v2fx_dot
+#   define v2fx_len    zmath_v2fx_len
+#   define v2fx_norm   zmath_v2fx_norm
+#   define v3fx_add    zmath_v3fx_add
+#   define v3fx_sub    zmath_v3fx_sub
+#   define v3fx_scale  zmath_v3fx_scale
+#   define v3fx_dot    zmath_v3fx_dot
+#   define v3fx_cross  zmath_v3fx_cross
+#   define v3fx_len    zmath_v3fx_len
+#   define v3fx_norm   zmath_v3fx_norm
+
+    // Arena.
+#   define arena_init  zmath_arena_init
+#   define arena_alloc zmath_arena_alloc
+#   define arena_mark  zmath_arena_mark
+#   define arena_reset zmath_arena_reset
+#   define arena_floats zmath_arena_floats
+#   define arena_v3_soa zmath_arena_v3_soa
+#   define arena_m3    zmath_arena_m3
+#   define arena_m4    zmath_arena_m4
+#   define arena_fft_plan zmath_arena_fft_plan
+#   define arena_fft_real_plan zmath_arena_fft_real_plan
+
+    // Parallel dispatch.
+#   ifdef ZMATH_PARALLEL
+#   define parallel_for zmath_parallel_for
+#   define parallel_unary zmath_parallel_unary
+#   define parallel_binary zmath_parallel_binary
+#   define parallel_transform_points zmath_parallel_transform_points
+#   ifndef ZMATH_PARALLEL_NO_POOL
+#   define pool_create zmath_pool_create
+#   define pool_destroy zmath_pool_destroy
+#   define pool_parallel zmath_pool_parallel
+#   endif
+#   endif
+
+    // Profiling.
+#   ifdef ZMATH_PROFILE
+#   define profile_snapshot zmath_profile_snapshot
+#   define profile_reset zmath_profile_reset
+#   define profile_name zmath_profile_name
+#   endif
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+// C++ expression layer (opt-in with ZMATH_CPP, C++11 or later).
+// zm::vec<2> / zm::vec<3> derive from zvec2 / zvec3 and add no members, so
+// they pass straight to the C API and arrays of either can be reinterpreted.
+// Operators build expression trees that are evaluated lane by lane on
+// assignment: `r = a*s + (b - c)` is one fused pass, and over zm::vec3_soa
+// streams one loop per component, with no zvec3 temporaries in between.
+// Only element-wise operators are lazy (+, -, unary -, * and / by a float),
+// which is what makes it safe for the target to appear on the right-hand
+// side. dot, cross, length and normalize evaluate eagerly through the C
+// functions. Expressions refer to their vector operands, so do not keep
+// one (e.g. in an `auto`) past the vectors it was built from.
+#if defined(ZMATH_CPP) && defined(__cplusplus) && __cplusplus >= 201103L
+
+namespace zm
+{
+    // Base of every vector expression: N lanes, optionally a stream.
+    template <class E, int N>
+    struct expr
+    {
+        const E& self() const { return *static_cast<const E*>(this); }
+    };
+
+    namespace detail
+    {
+        template <int N> struct c_vec;
+        template <> struct c_vec<2> { typedef zvec2 type; };
+        template <> struct c_vec<3> { typedef zvec3 type; };
+
+        // Named access to lane I of a zvec2 / zvec3 / zvec3_soa.
+        template <int I> struct lane;
+        template <> struct lane<0>
+        {
+            template <class T> static auto get(const T& v) -> decltype(v.x) { return v.x; }
+            template <class T> static auto ref(T& v) -> decltype((v.x)) { return v.x; }
+        };
+        template <> struct lane<1>
+        {
+            template <class T> static auto get(const T& v) -> decltype(v.y) { return v.y; }
+            template <class T> static auto ref(T& v) -> decltype((v.y)) { return v.y; }
+        };
+        template <> struct lane<2>
+        {
+            template <class T> static auto get(const T& v) -> decltype(v.z) { return v.z; }
+            template <class T> static auto ref(T& v) -> decltype((v.z)) { return v.z; }
+        };
+
+        struct add { static float apply(float a, float b) { return a + b; } };
+        struct sub { static float apply(float a, float b) { return a - b; } };
+        struct mul { static float apply(float a, float b) { return a * b; } };
+        struct div { static float apply(float a, float b) { return a / b; } };
+
+        // A float broadcast to every lane.
+        struct scalar
+        {
+            typedef scalar held;
+            enum { stream = 0 };
+            float s;
+            explicit scalar(float v) : s(v) {}
+            template <int I> float lane_at(size_t) const { return s; }
+        };
+
+        // Evaluates lanes I..N-1 of an expression into a vector or streams.
+        template <int I, int N>
+        struct assign
+        {
+            template <class V, class E>
+            static void to_vec(V& v, const E& e)
+            {
+                lane<I>::ref(v) = e.template lane_at<I>(0);
+                assign<I + 1, N>::to_vec(v, e);
+            }
+
+            template <class E>
+            static void to_soa(float* const* out, const E& e, size_t n)
+            {
+                float* d = out[I];
+                for (size_t i = 0; i < n; i++)
+                {
+                    d[i] = e.template lane_at<I>(i);
+                }
+                assign<I + 1, N>::to_soa(out, e, n);
+            }
+        };
+
+        template <int N>
+        struct assign<N, N>
+        {
+            template <class V, class E> static void to_vec(V&, const E&) {}
+            template <class E> static void to_soa(float* const*, const E&, size_t) {}
+        };
+    }
+
+    // Element-wise nodes. Inner nodes are held by value, vectors by reference.
+    template <class Op, class L, class R, int N>
+    struct binary : expr<binary<Op, L, R, N>, N>
+    {
+        typedef binary held;
+        enum { stream = L::stream || R::stream };
+        typename L::held l;
+        typename R::held r;
+
+        binary(const L& a, const R& b) : l(a), r(b) {}
+
+        template <int I> float lane_at(size_t i) const
+        {
+            return Op::apply(l.template lane_at<I>(i), r.template lane_at<I>(i));
+        }
+    };
+
+    template <class E, int N>
+    struct negate : expr<negate<E, N>, N>
+    {
+        typedef negate held;
+        enum { stream = E::stream };
+        typename E::held e;
+
+        explicit negate(const E& v) : e(v) {}
+
+        template <int I> float lane_at(size_t i) const { return -e.template lane_at<I>(i); }
+    };
+
+    // Operators.
+    template <class L, class R, int N>
+    inline binary<detail::add, L, R, N> operator+(const expr<L, N>& a, const expr<R, N>& b)
+    {
+        return binary<detail::add, L, R, N>(a.self(), b.self());
+    }
+
+    template <class L, class R, int N>
+    inline binary<detail::sub, L, R, N> operator-(const expr<L, N>& a, const expr<R, N>& b)
+    {
+        return binary<detail::sub, L, R, N>(a.self(), b.self());
+    }
+
+    template <class E, int N>
+    inline negate<E, N> operator-(const expr<E, N>& a)
+    {
+        return negate<E, N>(a.self());
+    }
+
+    template <class L, int N>
+    inline binary<detail::mul, L, detail::scalar, N> operator*(const expr<L, N>& a, float s)
+    {
+        return binary<detail::mul, L, detail::scalar, N>(a.self(), detail::scalar(s));
+    }
+
+    template <class R, int N>
+    inline binary<detail::mul, detail::scalar, R, N> operator*(float s, const expr<R, N>& b)
+    {
+        return binary<detail::mul, detail::scalar, R, N>(detail::scalar(s), b.self());
+    }
+
+    template <class L, int N>
+    inline binary<detail::div, L, detail::scalar, N> operator/(const expr<L, N>& a, float s)
+    {
+        return binary<detail::div, L, detail::scalar, N>(a.self(), detail::scalar(s));
+    }
+
+    template <int N>
+    struct vec : detail::c_vec<N>::type, expr<vec<N>, N>
+    {
+        typedef typename detail::c_vec<N>::type base;
+        typedef const vec& held;
+        enum { stream = 0 };
+
+        vec() : base() {}
+        vec(const base& v) : base(v) {}
+        vec(float x, float y)
+        {
+            static_assert(N == 2, "zm::vec: wrong number of components");
+            detail::lane<0>::ref(*this) = x;
+            detail::lane<1>::ref(*this) = y;
+        }
+        vec(float x, float y, float z)
+        {
+            static_assert(N == 3, "zm::vec: wrong number of components");
+            detail::lane<0>::ref(*this) = x;
+            detail::lane<1>::ref(*this) = y;
+            detail::lane<2>::ref(*this) = z;
+        }
+        template <class E> vec(const expr<E, N>& e) : base() { *this = e; }
+
+        template <class E> vec& operator=(const expr<E, N>& e)
+        {
+            static_assert(!E::stream, "zm::vec: assign a stream expression to a zm::vec3_soa");
+            detail::assign<0, N>::to_vec(*this, e.self());
+            return *this;
+        }
+
+        template <class E> vec& operator+=(const expr<E, N>& e) { return *this = *this + e; }
+        template <class E> vec& operator-=(const expr<E, N>& e) { return *this = *this - e; }
+        vec& operator*=(float s) { return *this = *this * s; }
+        vec& operator/=(float s) { return *this = *this / s; }
+
+        template <int I> float lane_at(size_t) const { return detail::lane<I>::get(*this); }
+    };
+
+    typedef vec<2> vec2;
+    typedef vec<3> vec3;
+
+    // View over three float streams. Assigning an expression (or another
+    // view) writes `count` elements through the pointers; other streams in
+    // the expression must be at least that long, and zm::vec operands are
+    // broadcast to every element.
+    struct vec3_soa : zvec3_soa, expr<vec3_soa, 3>
+    {
+        typedef const vec3_soa& held;
+        enum { stream = 1 };
+
+        vec3_soa(const zvec3_soa& s) : zvec3_soa(s) {}
+        vec3_soa(float* xs, float* ys, float* zs, size_t n)
+        {
+            x = xs;
+            y = ys;
+            z = zs;
+            count = n;
+        }
+        vec3_soa(const vec3_soa&) = default;
+
+        vec3_soa& operator=(const vec3_soa& s) { return *this = s * 1.0f; }
+        template <class E> vec3_soa& operator=(const expr<E, 3>& e)
+        {
+            float* out[3] = { x, y, z };
+            detail::assign<0, 3>::to_soa(out, e.self(), count);
+            return *this;
+        }
+
+        template <class E> vec3_soa& operator+=(const expr<E, 3>& e) { return *this = *this + e; }
+        template <class E> vec3_soa& operator-=(const expr<E, 3>& e) { return *this = *this - e; }
+        vec3_soa& operator*=(float s) { return *this = *this * s; }
+        vec3_soa& operator/=(float s) { return *this = *this / s; }
+
+        template <int I> float lane_at(size_t i) const { return detail::lane<I>::get(*this)[i]; }
+    };
+
+    static_assert(sizeof(vec2) == sizeof(zvec2) && sizeof(vec3) == sizeof(zvec3),
+                  "zm::vec must match the layout of the C vectors");
+
+    // Eager functions on single vectors, forwarded to the C API.
+    template <class L, class R>
+    inline float dot(const expr<L, 2>& a, const expr<R, 2>& b) { return zmath_v2_dot(vec2(a), vec2(b)); }
+    template <class L, class R>
+    inline float dot(const expr<L, 3>& a, const expr<R, 3>& b) { return zmath_v3_dot(vec3(a), vec3(b)); }
+    template <class L, class R>
+    inline vec3 cross(const expr<L, 3>& a, const expr<R, 3>& b) { return zmath_v3_cross(vec3(a), vec3(b)); }
+    template <class E>
+    inline float length(const expr<E, 2>& v) { return zmath_v2_len(vec2(v)); }
+    template <class E>
+    inline float length(const expr<E, 3>& v) { return zmath_v3_len(vec3(v)); }
+    template <class E>
+    inline vec2 normalize(const expr<E, 2>& v) { return zmath_v2_norm(vec2(v)); }
+    template <class E>
+    inline vec3 normalize(const expr<E, 3>& v) { return zmath_v3_norm(vec3(v)); }
+}
+
+#endif // ZMATH_CPP
+
+#endif // ZMATH_H
+
+#if defined(ZMATH_IMPLEMENTATION) && !defined(ZMATH__IMPLEMENTED)
+#define ZMATH__IMPLEMENTED
+
+#ifdef __cplusplus
+#   include <cstring>
+#else
+#   include <string.h>
+#endif
+
+// Guards lane code in functions that may be constant-evaluated.
+#if ZMATH_HAS_CONSTEXPR
+#   define ZMATH__RUNTIME (!__builtin_is_constant_evaluated())
+#else
+#   define ZMATH__RUNTIME 1
+#endif
+
+// ZMATH__PIN for kernels that may be constant-evaluated, where asm is not
+// allowed.
+#define ZMATH__PIN_K(v) do { if (ZMATH__RUNTIME) { ZMATH__PIN(v); } } while (0)
+
+// Profiling hooks. ZMATH__PROF_BEGIN opens a kernel's body and
+// ZMATH__PROF_END goes before each of its returns. Neither runs during
+// constant evaluation.
+#ifdef ZMATH_PROFILE
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#   define ZMATH__TLS thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#   define ZMATH__TLS _Thread_local
+#elif defined(_MSC_VER)
+#   define ZMATH__TLS __declspec(thread)
+#else
+#   define ZMATH__TLS __thread
+#endif
+
+#ifdef ZMATH_PROFILE_TIMING
+#   if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#       include <intrin.h>
+#       define ZMATH__PROF_TICKS() ((uint64_t)__rdtsc())
+#   elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#       define ZMATH__PROF_TICKS() ((uint64_t)__builtin_ia32_rdtsc())
+#   elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+static inline uint64_t zmath__prof_cntvct(void)
+{
+    uint64_t t;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+}
+#       define ZMATH__PROF_TICKS() zmath__prof_cntvct()
+#   endif
+#endif
+#ifndef ZMATH__PROF_TICKS
+#   define ZMATH__PROF_TICKS() ((uint64_t)0)
+#endif
+
+static ZMATH__TLS zmath_profile zmath__prof_data;
+
+static inline uint64_t zmath__prof_enter(int id, size_t n)
+{
+    zmath__prof_data.c[id].calls++;
+    zmath__prof_data.c[id].elems += n;
+    return ZMATH__PROF_TICKS();
+}
+
+static inline void zmath__prof_leave(int id, uint64_t t0)
+{
+    zmath__prof_data.c[id].ticks += ZMATH__PROF_TICKS() - t0;
+}
+
+#   define ZMATH__PROF_BEGIN(id, n) \
+        uint64_t zmath__prof_t0 = ZMATH__RUNTIME ? zmath__prof_enter(ZMATH_PROF_##id, (size_t)(n)) : 0
+#   define ZMATH__PROF_END(id) \
+        do { if (ZMATH__RUNTIME) { zmath__prof_leave(ZMATH_PROF_##id, zmath__prof_t0); } } while (0)
+
+ZMATHDEF void zmath_profile_snapshot(zmath_profile* out)
+{
+    *out = zmath__prof_data;
+}
+
+ZMATHDEF void zmath_profile_reset(void)
+{
+    memset(&zmath__prof_data, 0, sizeof(zmath__prof_data));
+}
+
+#define ZMATH__PROF_NAME(id, fn) #fn,
+static const char* const zmath__prof_names[] = { ZMATH_PROFILE_LIST(ZMATH__PROF_NAME) };
+#undef ZMATH__PROF_NAME
+
+ZMATHDEF const char* zmath_profile_name(int id)
+{
+    return (id >= 0 && id < ZMATH_PROF_COUNT) ? zmath__prof_names[id] : "";
+}
+
+#else
+#   define ZMATH__PROF_BEGIN(id, n) ((void)0)
+#   define ZMATH__PROF_END(id) ((void)0)
+#endif // ZMATH_PROFILE
+
+static inline ZMATH_CONSTEXPR uint32_t zmath__float_as_uint(float f) 
+{
+#if ZMATH_HAS_CONSTEXPR
+    return __builtin_bit_cast(uint32_t, f);
+#else
+    uint32_t u;
+    memcpy(&u, &f, sizeof(float));
+    return u;
+#endif
+}
+
+static inline ZMATH_CONSTEXPR float zmath__uint_as_float(uint32_t u) 
+{
+#if ZMATH_HAS_CONSTEXPR
+    return __builtin_bit_cast(float, u);
+#else
+    float f;
+    memcpy(&f, &u, sizeof(uint32_t));
+    return f;
+#endif
+}
+
+static inline ZMATH_CONSTEXPR uint64_t zmath__double_as_u64(double d)
+{
+#if ZMATH_HAS_CONSTEXPR
+    return __builtin_bit_cast(uint64_t, d);
+#else
+    uint64_t u;
+    memcpy(&u, &d, sizeof(double));
+    return u;
+#endif
+}
+
+static inline ZMATH_CONSTEXPR double zmath__u64_as_double(uint64_t u)
+{
+#if ZMATH_HAS_CONSTEXPR
+    return __builtin_bit_cast(double, u);
+#else
+    double d;
+    memcpy(&d, &u, sizeof(uint64_t));
+    return d;
+#endif
+}
+
+// Branch-free kernels.
+// The scalar functions and the *_array loops share these, so both give
+// identical results. Both sides of every conditional are computed and merged
+// with a bitwise select; a plain `?:` over float arithmetic keeps a branch
+// under the default -ftrapping-math and blocks auto-vectorization.
+
+// Kernels picked by ZMATH_ACCURACY for the unsuffixed functions.
+#if ZMATH_ACCURACY == ZMATH_ACCURACY_FAST
+#   define ZMATH__SIN_K     zmath__sin_fast_k
+#   define ZMATH__COS_K     zmath__cos_fast_k
+#   define ZMATH__SIN_R_K   zmath__sin_fast_r_k
+#   define ZMATH__COS_R_K   zmath__cos_fast_r_k
+#   define ZMATH__SINCOS_K  zmath__sincos_fast_k
+#   define ZMATH__EXP_K     zmath__exp_fast_k
+#   define ZMATH__LOG_K     zmath__log_fast_k
+#   define ZMATH__INVSQRT_K zmath__invsqrt_fast_k
+#   define ZMATH__EXP2_K    zmath__exp2_fast_k
+#   define ZMATH__LOG2_K    zmath__log2_fast_k
+#   define ZMATH__POW_K     zmath__pow_fast_k
+#elif ZMATH_ACCURACY == ZMATH_ACCURACY_PRECISE
+#   define ZMATH__SIN_K     zmath__sin_precise_k
+#   define ZMATH__COS_K     zmath__cos_precise_k
+#   define ZMATH__SINCOS_K  zmath__sincos_precise_k
+#   define ZMATH__EXP_K     zmath__exp_precise_k
+#   define ZMATH__LOG_K     zmath__log_precise_k
+#   define ZMATH__INVSQRT_K zmath__invsqrt_precise_k
+#   define ZMATH__EXP2_K    zmath__exp2_k
+#   define ZMATH__LOG2_K    zmath__log2_k
+#   define ZMATH__POW_K     zmath__pow_k
+#else
+#   define ZMATH__SIN_K     zmath__sin_k
+#   define ZMATH__COS_K     zmath__cos_k
+#   define ZMATH__SIN_R_K   zmath__sin_r_k
+#   define ZMATH__COS_R_K   zmath__cos_r_k
+#   define ZMATH__SINCOS_K  zmath__sincos_k
+#   define ZMATH__EXP_K     zmath__exp_k
+#   define ZMATH__LOG_K     zmath__log_k
+#   define ZMATH__INVSQRT_K zmath__invsqrt_k
+#   define ZMATH__EXP2_K    zmath__exp2_k
+#   define ZMATH__LOG2_K    zmath__log2_k
+#   define ZMATH__POW_K     zmath__pow_k
+#endif
+
+// ln(2) split for exp argument reduction; n * LN2_HI is exact for |n| < 2^15.
+#define ZMATH__LN2_HI  0.693359375f
+#define ZMATH__LN2_LO -2.12194440e-4f
+
+static inline ZMATH_CONSTEXPR float zmath__select_k(bool c, float a, float b)
+{
+    uint32_t m = (uint32_t)0 - (uint32_t)c;
+    return zmath__uint_as_float((zmath__float_as_uint(a) & m) | (zmath__float_as_uint(b) & ~m));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__abs_k(float x)
+{
+    return zmath__uint_as_float(zmath__float_as_uint(x) & 0x7FFFFFFF);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__copysign_k(float x, float y)
+{
+    uint32_t ix = zmath__float_as_uint(x) & 0x7FFFFFFF;
+    return zmath__uint_as_float(ix | (zmath__float_as_uint(y) & 0x80000000));
+}
+
+// Rounding core.
+// Adding 2^23 (with the sign of x) pushes every fractional bit out of the
+// mantissa, so (x + m) - m is x rounded to the nearest integer, ties to even.
+// No float <-> int conversion and no branch. Floats at or past 2^23 are
+// already integral and pass through. Integer results of zero are +0.0.
+// The trick needs the sum rounded to float. -ffast-math folds (x + m) - m
+// back to x, and x87 (FLT_EVAL_METHOD 2) keeps the sum in extended
+// precision, so both truncate through int32 instead and step away from
+// zero past the half, or at the half onto an even integer.
+#if defined(__FAST_MATH__) || (defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ != 0)
+#   define ZMATH__RINT_CAST
+#endif
+
+static inline ZMATH_CONSTEXPR float zmath__rint_k(float x)
+{
+    bool small = zmath__abs_k(x) < ZMATH_NO_FRACT_LIMIT;
+#ifdef ZMATH__RINT_CAST
+    float h = zmath__select_k(small, x, 0.0f);
+    int32_t i = (int32_t)h;
+    float f = zmath__abs_k(h - (float)i);
+    i += (f > 0.5f || (f == 0.5f && (i & 1))) ? ((h < 0.0f) ? -1 : 1) : 0;
+    float r = (float)i;
+#else
+    float m = zmath__copysign_k(ZMATH_NO_FRACT_LIMIT, x);
+    float r = (x + m) - m;
+#endif
+    return zmath__select_k(small, r, x);
+}
+
+// Nearest integer (ties to even) as an int32, for |x| < 2^22 only. Read from
+// the bits of x + ZMATH__RINT_MAGIC instead of converted.
+static inline ZMATH_CONSTEXPR int32_t zmath__rint_int_k(float x)
+{
+#ifdef ZMATH__RINT_CAST
+    return (int32_t)zmath__rint_k(x);
+#else
+    return (int32_t)(zmath__float_as_uint(x + ZMATH__RINT_MAGIC) - 0x4B400000u);
+#endif
+}
+
+static inline ZMATH_CONSTEXPR float zmath__floor_k(float x)
+{
+    float r = zmath__rint_k(x);
+    return zmath__select_k(r > x, r - 1.0f, r);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__ceil_k(float x)
+{
+    float r = zmath__rint_k(x);
+    return zmath__select_k(r < x, r + 1.0f, r);
+}
+
+// Steps back toward zero wherever rint rounded away from it.
+static inline ZMATH_CONSTEXPR float zmath__trunc_k(float x)
+{
+    float r = zmath__rint_k(x);
+    bool away = zmath__abs_k(r) > zmath__abs_k(x);
+    return r - zmath__copysign_k(zmath__select_k(away, 1.0f, 0.0f), x);
+}
+
+// Round half away from zero.
+static inline ZMATH_CONSTEXPR float zmath__round_k(float x)
+{
+    bool small = zmath__abs_k(x) < ZMATH_NO_FRACT_LIMIT;
+    float r = zmath__trunc_k(x + zmath__copysign_k(0.5f, x));
+    return zmath__select_k(small, r, x);
+}
+
+// Reciprocal square root seed: 0x5f3759df (3.4e-2 rel), or with
+// ZMATH_USE_HW_RSQRT the hardware estimate (3.7e-4 rel on x86; NEON's 8-bit
+// vrsqrte gets one vrsqrts step). Constant evaluation keeps the bit trick.
+// The estimate of zero is inf, which the Newton steps and x * invsqrt(x)
+// turn into NaN, so zero keeps the bit trick's large finite seed.
+static inline ZMATH_CONSTEXPR float zmath__rsqrt_seed_k(float x)
+{
+    float t = zmath__uint_as_float(0x5f3759df - (zmath__float_as_uint(x) >> 1));
+#if defined(ZMATH__HW_RSQRT_SSE)
+    if (ZMATH__RUNTIME)
+    {
+        float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+        return zmath__select_k(x == 0.0f, t, y);
+    }
+#elif defined(ZMATH__HW_RSQRT_NEON)
+    if (ZMATH__RUNTIME)
+    {
+        float32x2_t v = vdup_n_f32(x);
+        float32x2_t y = vrsqrte_f32(v);
+        y = vmul_f32(y, vrsqrts_f32(vmul_f32(v, y), y));
+        return zmath__select_k(x == 0.0f, t, vget_lane_f32(y, 0));
+    }
+#endif
+    return t;
+}
+
+// Seed plus `iterations` Newton steps; each one roughly squares the error.
+static inline ZMATH_CONSTEXPR float zmath__rsqrt_n_k(float x, int iterations)
+{
+    float xhalf = 0.5f * x;
+    float y = zmath__rsqrt_seed_k(x);
+    for (int i = 0; i < iterations; i++)
+    {
+        y = y * (1.5f - xhalf * y * y);
+    }
+    return y;
+}
+
+// Seed only: a magic constant tuned for zero Newton steps, or the hardware
+// estimate as is.
+static inline ZMATH_CONSTEXPR float zmath__invsqrt_fast_k(float x)
+{
+#if defined(ZMATH__HW_RSQRT_SSE) || defined(ZMATH__HW_RSQRT_NEON)
+    return zmath__rsqrt_seed_k(x);
+#else
+    uint32_t i = 0x5f37642f - (zmath__float_as_uint(x) >> 1);
+    return zmath__uint_as_float(i);
+#endif
+}
+
+static inline ZMATH_CONSTEXPR float zmath__invsqrt_k(float x)
+{
+    return zmath__rsqrt_n_k(x, 1);
+}
+
+// Three steps from the bit trick; the hardware seed converges in two.
+static inline ZMATH_CONSTEXPR float zmath__invsqrt_precise_k(float x)
+{
+#if defined(ZMATH__HW_RSQRT_SSE) || defined(ZMATH__HW_RSQRT_NEON)
+    return zmath__rsqrt_n_k(x, 2);
+#else
+    return zmath__rsqrt_n_k(x, 3);
+#endif
+}
+
+// Shared by every normalize: within 5e-6 of unit length, at the fast tier
+// too, since a unit vector is only worth one multiply if it is unit. The
+// precise tier uses its own invsqrt.
+static inline ZMATH_CONSTEXPR float zmath__rsqrt_norm_k(float d)
+{
+#if ZMATH_ACCURACY == ZMATH_ACCURACY_PRECISE
+    return zmath__invsqrt_precise_k(d);
+#elif defined(ZMATH__HW_RSQRT_SSE) || defined(ZMATH__HW_RSQRT_NEON)
+    return zmath__rsqrt_n_k(d, 1);
+#else
+    return zmath__rsqrt_n_k(d, 2);
+#endif
+}
+
+// On ARM the hardware reciprocal estimate plus two Newton steps (vrecpe has
+// 8 bits) replaces the division. On x86 divss already matches rcpss plus its
+// Newton step, is exact and vectorizes, so rcp stays a division there.
+static inline ZMATH_CONSTEXPR float zmath__rcp_k(float x)
+{
+#ifdef ZMATH__HW_RSQRT_NEON
+    if (ZMATH__RUNTIME)
+    {
+        float32x2_t v = vdup_n_f32(x);
+        float32x2_t y = vrecpe_f32(v);
+        y = vmul_f32(y, vrecps_f32(v, y));
+        y = vmul_f32(y, vrecps_f32(v, y));
+        return vget_lane_f32(y, 0);
+    }
+#endif
+    return 1.0f / x;
+}
+
+static inline ZMATH_CONSTEXPR float zmath__sqrt_k(float x)
+{
+    float guess = x * ZMATH__INVSQRT_K(x);
+    float r = 0.5f * (guess + x / guess);
+    return zmath__select_k(x <= 0.0f, 0.0f, r);
+}
+
+// Special-value guards, compiled out under ZMATH_FAST_MATH.
+// exp_out replaces the results for x below lo with 0, and for x from hi up
+// or NaN with x * inf, which is inf or NaN; the exponent add may have
+// wrapped there. log_in scales subnormals by 2^23 into the normal range and
+// returns the exponent correction; log_out maps inf and NaN to themselves.
+static inline ZMATH_CONSTEXPR float zmath__exp_out_k(float x, float r, float lo, float hi)
+{
+#ifdef ZMATH_FAST_MATH
+    (void)x;
+    (void)lo;
+    (void)hi;
+    return r;
+#else
+    r = zmath__select_k(x < lo, 0.0f, r);
+    return zmath__select_k(!(x < hi), x * ZMATH_INFINITY, r);
+#endif
+}
+
+static inline ZMATH_CONSTEXPR float zmath__log_in_k(float* x)
+{
+#ifdef ZMATH_FAST_MATH
+    (void)x;
+    return 0.0f;
+#else
+    bool sub = *x < ZMATH__FLT_MIN;
+    *x = zmath__select_k(sub, *x * 8388608.0f, *x);
+    return zmath__select_k(sub, -23.0f, 0.0f);
+#endif
+}
+
+static inline ZMATH_CONSTEXPR float zmath__log_out_k(float x, float r)
+{
+#ifdef ZMATH_FAST_MATH
+    (void)x;
+    return r;
+#else
+    return zmath__select_k(!(x < ZMATH_INFINITY), x, r);
+#endif
+}
+
+// log2(1 + m) ~ m * (C0 + m * (C1 + m * C2)) on [0, 1), scaled by ln(2).
+static inline ZMATH_CONSTEXPR float zmath__log_fast_k(float x)
+{
+    float v = x;
+    float bias = zmath__log_in_k(&v);
+    uint32_t ix = zmath__float_as_uint(v);
+    int exponent = ((int)((ix >> 23) & 0xFF)) - 127;
+    float m = zmath__uint_as_float((ix & 0x007FFFFF) | 0x3F800000) - 1.0f;
+    float l2 = m * (1.422478300f + m * (-0.5779254771f + m * 0.1554471769f));
+    float r = (((float)exponent + bias) + l2) * ZMATH_LN2;
+    r = zmath__log_out_k(x, r);
+    return zmath__select_k(x <= 0.0f, -ZMATH_INFINITY, r);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__log_k(float x)
+{
+    float v = x;
+    float bias = zmath__log_in_k(&v);
+    uint32_t ix = zmath__float_as_uint(v);
+    int exponent = ((int)((ix >> 23) & 0xFF)) - 127;
+    ix = (ix & 0x007FFFFF) | 0x3F800000;
+    float m = zmath__uint_as_float(ix);
+    float z = (m - 1.0f) / (m + 1.0f);
+    float z2 = z * z;
+    float y = z * (2.0f + z2 * (0.66666666f + z2 * (0.4f + z2 * 0.28571428f)));
+    float r = ((float)exponent + bias) * ZMATH_LN2 + y;
+    r = zmath__log_out_k(x, r);
+    return zmath__select_k(x <= 0.0f, -ZMATH_INFINITY, r);
+}
+
+// Mantissa centred on [sqrt(1/2), sqrt(2)) so s = (m - 1) / (m + 1) stays
+// below 0.172 and log(m) = 2s + s^3 * P(s^2) keeps full precision near 1.
+static inline ZMATH_CONSTEXPR float zmath__log_precise_k(float x)
+{
+    float v = x;
+    float bias = zmath__log_in_k(&v);
+    uint32_t ix = zmath__float_as_uint(v) + (0x3F800000 - 0x3F3504F3);
+    int exponent = (int)(ix >> 23) - 127;
+    float m = zmath__uint_as_float((ix & 0x007FFFFF) + 0x3F3504F3);
+    float s = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+    float t = s2 * (0.6666666660f + s2 * (0.4000010489f + s2 * (0.2855130225f +
+              s2 * 0.2333646465f)));
+    float e = (float)exponent + bias;
+    float r = e * ZMATH__LN2_HI + (e * ZMATH__LN2_LO + (2.0f * s + s * t));
+    r = zmath__log_out_k(x, r);
+    return zmath__select_k(x <= 0.0f, -ZMATH_INFINITY, r);
+}
+
+// 2^f ~ C0 + f * (C1 + f * C2) on [-0.5, 0.5].
+static inline ZMATH_CONSTEXPR float zmath__exp_fast_k(float x)
+{
+    float px = x * 1.44269504088f;
+    int32_t k = zmath__rint_int_k(px);
+    float f = px - (float)k;
+    float p = 1.000443142f + f * (0.7034480059f + f * 0.2384289358f);
+    uint32_t bits = zmath__float_as_uint(p);
+    bits += ((uint32_t)k << 23);
+    return zmath__exp_out_k(x, zmath__uint_as_float(bits), ZMATH__EXP_LO, ZMATH__EXP_HI);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__exp_k(float x)
+{
+    float px = x * 1.44269504088f;
+    int32_t k = zmath__rint_int_k(px);
+    float r = (px - (float)k) * 0.69314718056f;
+    float r2 = r * r;
+    float f = 1.0f + r + (r2 * 0.5f) + (r * r2 * 0.16666666f);
+    uint32_t bits = zmath__float_as_uint(f);
+    bits += ((uint32_t)k << 23);
+    return zmath__exp_out_k(x, zmath__uint_as_float(bits), ZMATH__EXP_LO, ZMATH__EXP_HI);
+}
+
+// Reduces with a two-part ln(2) so r = x - n * ln(2) keeps its low bits,
+// then e^r ~ 1 + r + r^2 * P(r) on [-ln(2)/2, ln(2)/2].
+static inline ZMATH_CONSTEXPR float zmath__exp_precise_k(float x)
+{
+    int32_t k = zmath__rint_int_k(x * 1.44269504088f);
+    float n = (float)k;
+    float r = x - n * ZMATH__LN2_HI;
+    ZMATH__PIN_K(r);
+    r = r - n * ZMATH__LN2_LO;
+    float p = 0.4999999345f + r * (0.1666652069f + r * (0.04166838736f +
+              r * (0.008368709823f + r * 0.001381461319f)));
+    float f = 1.0f + r + r * r * p;
+    uint32_t bits = zmath__float_as_uint(f);
+    bits += ((uint32_t)k << 23);
+    return zmath__exp_out_k(x, zmath__uint_as_float(bits), ZMATH__EXP_LO, ZMATH__EXP_HI);
+}
+
+// Exponential and logarithm tables.
+// 2^x = 2^k * 2^(i/32) * 2^r with |r| <= 1/64, so a cubic in r is enough.
+// log2(x) = k + log2(c) + log2(1 + r) with r = (m - c) / c, for the nearest
+// of 32 centres c of the mantissa m in [0.6875, 1.375). The two centres next
+// to 1 are exactly 1, so results near zero keep their relative precision.
+// Each m - c is exact (same binade), and the sums are carried as hi + lo with
+// Fast2Sum, which has no products for FMA contraction to change.
+static ZMATH_CONSTEXPR const float zmath__exp2_table[32] =
+{
+    1.0f, 1.0218972f, 1.0442737f, 1.0671405f,
+    1.0905077f, 1.1143868f, 1.1387886f, 1.1637249f,
+    1.1892071f, 1.2152474f, 1.2418578f, 1.269051f,
+    1.2968396f, 1.3252367f, 1.3542556f, 1.38391f,
+    1.4142135f, 1.4451808f, 1.4768262f, 1.5091645f,
+    1.5422108f, 1.5759809f, 1.6104903f, 1.6457555f,
+    1.6817929f, 1.7186193f, 1.7562522f, 1.7947091f,
+    1.8340081f, 1.8741677f, 1.9152066f, 1.9571441f,
+};
+
+// Centre, 1 / centre, and log2(centre) as hi + lo.
+typedef struct { float c, invc, log2c, log2c_lo; } zmath__log_entry;
+
+static ZMATH_CONSTEXPR const zmath__log_entry zmath__log_table[32] =
+{
+    { 0.6953125f, 1.4382023f, -0.52426654f, -2.802942e-08f },
+    { 0.7109375f, 1.4065934f, -0.49220535f, -8.210193e-09f },
+    { 0.7265625f, 1.3763441f, -0.46084118f, -9.997926e-09f },
+    { 0.7421875f, 1.3473685f, -0.4301444f, 7.735474e-09f },
+    { 0.7578125f, 1.3195876f, -0.40008715f, -9.861746e-09f },
+    { 0.7734375f, 1.2929293f, -0.37064338f, -2.6163132e-09f },
+    { 0.7890625f, 1.2673267f, -0.34178853f, 1.3101526e-08f },
+    { 0.8046875f, 1.2427185f, -0.31349948f, 7.669135e-09f },
+    { 0.8203125f, 1.2190477f, -0.28575447f, -1.0316589e-08f },
+    { 0.8359375f, 1.1962616f, -0.258533f, -1.2652809e-08f },
+    { 0.8515625f, 1.1743119f, -0.23181568f, 5.6383995e-09f },
+    { 0.8671875f, 1.1531532f, -0.20558414f, 4.981927e-09f },
+    { 0.8828125f, 1.1327434f, -0.17982104f, 6.621807e-09f },
+    { 0.8984375f, 1.1130434f, -0.15450995f, -2.351714e-09f },
+    { 0.9140625f, 1.0940171f, -0.12963527f, -6.006348e-09f },
+    { 0.9296875f, 1.0756303f, -0.10518224f, 1.2310888e-09f },
+    { 0.9453125f, 1.0578512f, -0.08113676f, 3.7045023e-10f },
+    { 0.9609375f, 1.0406504f, -0.057485495f, 1.0189895e-10f },
+    { 0.9765625f, 1.024f, -0.034215715f, -5.5543653e-10f },
+    { 1.0f, 1.0f, 0.0f, 0.0f },
+    { 1.0f, 1.0f, 0.0f, 0.0f },
+    { 1.046875f, 0.95522386f, 0.06608919f, -8.492547e-11f },
+    { 1.078125f, 0.92753625f, 0.10852446f, 1.5795268e-10f },
+    { 1.109375f, 0.90140843f, 0.14974712f, 1.1508383e-09f },
+    { 1.140625f, 0.8767123f, 0.18982457f, -7.365062e-09f },
+    { 1.171875f, 0.85333335f, 0.22881868f, 5.6795204e-09f },
+    { 1.203125f, 0.83116883f, 0.26678655f, -4.820159e-09f },
+    { 1.234375f, 0.8101266f, 0.30378073f, 1.3638071e-08f },
+    { 1.265625f, 0.79012346f, 0.33985f, -5.6030767e-09f },
+    { 1.296875f, 0.7710843f, 0.37503943f, 2.8744058e-09f },
+    { 1.328125f, 0.7529412f, 0.40939093f, 9.776618e-09f },
+    { 1.359375f, 0.7356322f, 0.44294348f, 1.2257648e-08f },
+};
+
+// 2^(hi + lo) for a small correction `lo`. Flushes below 2^-126 to zero and
+// saturates to infinity from 2^128; a NaN `hi` comes back unless
+// ZMATH_FAST_MATH is defined.
+static inline ZMATH_CONSTEXPR float zmath__exp2_table_k(float hi, float lo)
+{
+    int32_t n = zmath__rint_int_k(hi * 32.0f);
+    float r = (hi - (float)n * 0.03125f) + lo;
+    uint32_t i = (uint32_t)n & 31u;
+    float t = zmath__exp2_table[i];
+    float p = r * (0.6931472f + r * (0.2402265f + r * 0.05550411f));
+    uint32_t bits = zmath__float_as_uint(t + t * p) + (((uint32_t)n - i) << 18);
+    float res = zmath__select_k(hi < -126.0f, 0.0f, zmath__uint_as_float(bits));
+    res = zmath__select_k(hi >= 128.0f, ZMATH_INFINITY, res);
+#ifndef ZMATH_FAST_MATH
+    res = zmath__select_k(hi != hi, hi, res);
+#endif
+    return res;
+}
+
+// log2(x) as hi + *lo, for positive x (normal x under ZMATH_FAST_MATH).
+static inline ZMATH_CONSTEXPR float zmath__log2_table_k(float x, float* lo)
+{
+    float bias = zmath__log_in_k(&x);
+    uint32_t ix = zmath__float_as_uint(x) + (0x3F800000u - 0x3F300000u);
+    const zmath__log_entry* e = &zmath__log_table[(ix >> 18) & 31u];
+    float k = (float)((int32_t)(ix >> 23) - 127) + bias;
+    float m = zmath__uint_as_float((ix & 0x007FFFFFu) + 0x3F300000u);
+    float r = (m - e->c) * e->invc;
+    float p = r * 1.442695f + r * r * (-0.7213475f + r * (0.48089835f +
+              r * (-0.36067376f + r * 0.28853902f)));
+    float s = k + e->log2c;
+    float q = p + (((k - s) + e->log2c) + e->log2c_lo);
+    float hi = s + q;
+    *lo = q - (hi - s);
+    return hi;
+}
+
+// 2^f ~ C0 + f * (C1 + f * C2) on [-0.5, 0.5], as in zmath__exp_fast_k.
+static inline ZMATH_CONSTEXPR float zmath__exp2_fast_k(float x)
+{
+    int32_t k = zmath__rint_int_k(x);
+    float f = x - (float)k;
+    float p = 1.000443142f + f * (0.7034480059f + f * 0.2384289358f);
+    float r = zmath__uint_as_float(zmath__float_as_uint(p) + ((uint32_t)k << 23));
+    return zmath__exp_out_k(x, r, -126.0f, 128.0f);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__exp2_k(float x)
+{
+    return zmath__exp2_table_k(x, 0.0f);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__log2_fast_k(float x)
+{
+    return zmath__log_fast_k(x) * 1.44269504088f;
+}
+
+static inline ZMATH_CONSTEXPR float zmath__log2_k(float x)
+{
+    float lo = 0.0f;
+    float hi = zmath__log_out_k(x, zmath__log2_table_k(x, &lo));
+    return zmath__select_k(x <= 0.0f, -ZMATH_INFINITY, hi);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__pow_fast_k(float x, float y)
+{
+    float r = zmath__exp_fast_k(y * zmath__log_fast_k(x));
+    r = zmath__select_k(y == 0.0f, 1.0f, r);
+    return zmath__select_k(x <= 0.0f, 0.0f, r);
+}
+
+// 2^(y * log2(x)) with the product formed almost exactly: y and the high
+// part of log2(x) are split into 12-bit halves (by masking, so the split is
+// immune to contraction), whose products are exact.
+static inline ZMATH_CONSTEXPR float zmath__pow_k(float x, float y)
+{
+    float lo = 0.0f;
+    float hi = zmath__log_out_k(x, zmath__log2_table_k(x, &lo));
+    float yh = zmath__uint_as_float(zmath__float_as_uint(y) & 0xFFFFF000u);
+    float yl = y - yh;
+    float hh = zmath__uint_as_float(zmath__float_as_uint(hi) & 0xFFFFF000u);
+    float hl = hi - hh;
+    float th = y * hi;
+    float tl = ((((yh * hh - th) + yh * hl) + yl * hh) + yl * hl) + y * lo;
+    float r = zmath__exp2_table_k(th, tl);
+    r = zmath__select_k(y == 0.0f, 1.0f, r);
+    return zmath__select_k(x <= 0.0f, 0.0f, r);
+}
+
+// Removes the nearest multiple of 2pi, leaving x in [-pi, pi]. For
+// |x| < pi, q is 0 and x passes through exactly. Branch-free, but only for
+// |x| < ZMATH__TAU_BIG.
+static inline ZMATH_CONSTEXPR float zmath__reduce_tau_cw_k(float x)
+{
+    float q = zmath__rint_k(x * (1.0f / ZMATH_TAU));
+    float r = x - q * ZMATH__TAU_P1;
+    ZMATH__PIN_K(r);
+    r = r - q * ZMATH__TAU_P2;
+    ZMATH__PIN_K(r);
+    return r - q * ZMATH__TAU_P3;
+}
+
+// Any x: large arguments, infinities and NaN branch off to
+// zmath__reduce_tau_big_k.
+static inline ZMATH_CONSTEXPR float zmath__reduce_tau_k(float x)
+{
+    if (!(zmath__abs_k(x) < ZMATH__TAU_BIG))
+    {
+        return zmath__reduce_tau_big_k(x, zmath__float_as_uint(x));
+    }
+    return zmath__reduce_tau_cw_k(x);
+}
+
+// The fraction t - rint(t) is exact, so only the scaling to [-pi, pi]
+// rounds.
+static inline ZMATH_CONSTEXPR float zmath__turns_k(float t)
+{
+    return (t - zmath__rint_k(t)) * ZMATH_TAU;
+}
+
+// Folds [-pi, pi] into [-pi/2, pi/2] with sin unchanged. At most one fires.
+static inline ZMATH_CONSTEXPR float zmath__fold_half_pi_k(float x)
+{
+    x = zmath__select_k(x > ZMATH_HALF_PI, ZMATH_PI - x, x);
+    return zmath__select_k(x < -ZMATH_HALF_PI, -ZMATH_PI - x, x);
+}
+
+// Odd polynomials on [-pi/2, pi/2]. On the reduced argument r,
+// cos(r) = sin(pi/2 - |r|), so cosine needs no fold and shares the sine one.
+static inline ZMATH_CONSTEXPR float zmath__sin_fast_poly_k(float x)
+{
+    float x2 = x * x;
+    return x * (0.9998918213f + x2 * (-0.1659601165f + x2 * 0.007602903343f));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__sin_poly_k(float x)
+{
+    float x2 = x * x;
+    return x * (1.0f + x2 * (ZMATH_SIN_C0 + x2 * (ZMATH_SIN_C1 +
+               x2 * (ZMATH_SIN_C2 + x2 * ZMATH_SIN_C3))));
+}
+
+// The _r kernels take the reduced argument r in [-pi, pi]; the *_array loops
+// feed them zmath__reduce_tau_cw_k directly where no argument is large.
+static inline ZMATH_CONSTEXPR float zmath__sin_fast_r_k(float r)
+{
+    return zmath__sin_fast_poly_k(zmath__fold_half_pi_k(r));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__cos_fast_r_k(float r)
+{
+    return zmath__sin_fast_poly_k(ZMATH_HALF_PI - zmath__abs_k(r));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__sin_r_k(float r)
+{
+    return zmath__sin_poly_k(zmath__fold_half_pi_k(r));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__cos_r_k(float r)
+{
+    return zmath__sin_poly_k(ZMATH_HALF_PI - zmath__abs_k(r));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__sin_fast_k(float x)
+{
+    return zmath__sin_fast_r_k(zmath__reduce_tau_k(x));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__cos_fast_k(float x)
+{
+    return zmath__cos_fast_r_k(zmath__reduce_tau_k(x));
+}
+
+static inline ZMATH_CONSTEXPR void zmath__sincos_fast_k(float x, float* s, float* c)
+{
+    float r = zmath__reduce_tau_k(x);
+    *s = zmath__sin_fast_r_k(r);
+    *c = zmath__cos_fast_r_k(r);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__sin_k(float x)
+{
+    return zmath__sin_r_k(zmath__reduce_tau_k(x));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__cos_k(float x)
+{
+    return zmath__cos_r_k(zmath__reduce_tau_k(x));
+}
+
+static inline ZMATH_CONSTEXPR void zmath__sincos_k(float x, float* s, float* c)
+{
+    float r = zmath__reduce_tau_k(x);
+    *s = zmath__sin_r_k(r);
+    *c = zmath__cos_r_k(r);
+}
+
+// Reduction to r in [-pi/4, pi/4] and quadrant q, then both the sine and
+// cosine polynomials of r. Odd quadrants swap them; the sign comes from bit 1
+// of q for sine and of q + 1 (a quarter turn ahead) for cosine. Past pi/4 the
+// reduction is Payne-Hanek at every magnitude: it rounds the turn fraction to
+// the nearest quarter, and only the conversion of what is left to float
+// rounds, so r keeps full relative precision next to the zeros of sin and
+// cos. Infinities and NaN give NaN.
+static inline ZMATH_CONSTEXPR void zmath__sincos_precise_k(float x, float* s, float* c)
+{
+    uint32_t bits = zmath__float_as_uint(x);
+    uint32_t q = 0;
+    float r = x;
+    if (!(zmath__abs_k(x) <= ZMATH_PI * 0.25f))
+    {
+        uint64_t f = zmath__turns_frac_k(bits);
+        uint64_t k = (f + ((uint64_t)1 << 61)) >> 62;
+        r = (float)((double)(int64_t)(f - (k << 62)) * ZMATH__TURN_SCALE);
+        q = (uint32_t)k;
+        if ((bits & 0x7F800000u) == 0x7F800000u)
+        {
+            r = x - x;
+        }
+    }
+
+    float r2 = r * r;
+    float ps = r + r * r2 * (-0.1666665461f + r2 * (0.008332160762f +
+               r2 * -0.0001951528319f));
+    float pc = 1.0f - 0.5f * r2 + r2 * r2 * (0.04166664568f +
+               r2 * (-0.001388731625f + r2 * 0.00002443315706f));
+    bool swap = (q & 1) != 0;
+    float sv = zmath__select_k(swap, pc, ps);
+    float cv = zmath__select_k(swap, ps, pc);
+    *s = zmath__select_k((q & 2) != 0, -sv, sv);
+    *c = zmath__select_k(((q + 1) & 2) != 0, -cv, cv);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__sin_precise_k(float x)
+{
+    float s, c;
+    zmath__sincos_precise_k(x, &s, &c);
+    return s;
+}
+
+static inline ZMATH_CONSTEXPR float zmath__cos_precise_k(float x)
+{
+    float s, c;
+    zmath__sincos_precise_k(x, &s, &c);
+    return c;
+}
+
+static inline ZMATH_CONSTEXPR float zmath__tan_k(float x)
+{
+    float s, c;
+    ZMATH__SINCOS_K(x, &s, &c);
+    return zmath__select_k(zmath__abs_k(c) < 1e-5f, 0.0f, s / c);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__atan_k(float x)
+{
+    bool negative = (x < 0.0f);
+    float sign = zmath__select_k(negative, -1.0f, 1.0f);
+    x = zmath__select_k(negative, -x, x);
+    bool complement = (x > 1.0f);
+    x = zmath__select_k(complement, 1.0f / x, x);
+    float x2 = x * x;
+    float y = x * (ZMATH_ATAN_C0 + x2 * (ZMATH_ATAN_C1 + x2 * (ZMATH_ATAN_C2 +
+              x2 * (ZMATH_ATAN_C3 + x2 * (ZMATH_ATAN_C4 + x2 * ZMATH_ATAN_C5)))));
+    y = zmath__select_k(complement, ZMATH_HALF_PI - y, y);
+    return sign * y;
+}
+
+static inline ZMATH_CONSTEXPR float zmath__atan2_k(float y, float x)
+{
+    // y / x is evaluated even when x == 0; that lane is replaced below.
+    float res = zmath__atan_k(y / x);
+    float half_turn = zmath__select_k(y >= 0.0f, ZMATH_PI, -ZMATH_PI);
+    res += zmath__select_k(x < 0.0f, half_turn, 0.0f);
+    float axis = zmath__select_k(y < 0.0f, -ZMATH_HALF_PI, 0.0f);
+    axis = zmath__select_k(y > 0.0f, ZMATH_HALF_PI, axis);
+    return zmath__select_k(x == 0.0f, axis, res);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__asin_k(float x)
+{
+    x = zmath__select_k(x < -1.0f, -1.0f, x);
+    x = zmath__select_k(x > 1.0f, 1.0f, x);
+    return zmath__atan_k(x / zmath__sqrt_k(1.0f - x * x));
+}
+
+static inline ZMATH_CONSTEXPR float zmath__acos_k(float x)
+{
+    return ZMATH_HALF_PI - zmath__asin_k(x);
+}
+
+#ifdef ZMATH_TRIG_LUT
+
+// Sine table.
+// sin(j * (pi/2) / Q) for j in [0, Q], Q = 2^(ZMATH_TRIG_LUT_BITS - 2), with
+// the endpoint so linear interpolation never reads past the end. Entries are
+// a degree-13 Taylor series evaluated in double as constant expressions
+// (truncation error below 7e-10), so the compiler builds the table and there
+// is no runtime init. Indices are spelled as hex literals by token pasting.
+#define ZMATH__LUT_QUARTER (1u << (ZMATH_TRIG_LUT_BITS - 2))
+#define ZMATH__LUT_SHIFT   (32 - ZMATH_TRIG_LUT_BITS)
+
+#define ZMATH__LUT_A(j)  ((double)(j) * (1.57079632679489661923 / ZMATH__LUT_QUARTER))
+#define ZMATH__LUT_A2(j) (ZMATH__LUT_A(j) * ZMATH__LUT_A(j))
+#define ZMATH__LUT_E(j)  (float)(ZMATH__LUT_A(j) * (1.0 + ZMATH__LUT_A2(j) *      \
+    (-1.0 / 6.0 + ZMATH__LUT_A2(j) * (1.0 / 120.0 + ZMATH__LUT_A2(j) *            \
+    (-1.0 / 5040.0 + ZMATH__LUT_A2(j) * (1.0 / 362880.0 + ZMATH__LUT_A2(j) *      \
+    (-1.0 / 39916800.0 + ZMATH__LUT_A2(j) * (1.0 / 6227020800.0)))))))),
+
+#define ZMATH__LUT_X1(p)    ZMATH__LUT_E(p)
+#define ZMATH__LUT_X16(p)                                                       \
+    ZMATH__LUT_X1(p##0) ZMATH__LUT_X1(p##1) ZMATH__LUT_X1(p##2) ZMATH__LUT_X1(p##3) \
+    ZMATH__LUT_X1(p##4) ZMATH__LUT_X1(p##5) ZMATH__LUT_X1(p##6) ZMATH__LUT_X1(p##7) \
+    ZMATH__LUT_X1(p##8) ZMATH__LUT_X1(p##9) ZMATH__LUT_X1(p##A) ZMATH__LUT_X1(p##B) \
+    ZMATH__LUT_X1(p##C) ZMATH__LUT_X1(p##D) ZMATH__LUT_X1(p##E) ZMATH__LUT_X1(p##F)
+#define ZMATH__LUT_X256(p)                                                      \
+    ZMATH__LUT_X16(p##0) ZMATH__LUT_X16(p##1) ZMATH__LUT_X16(p##2) ZMATH__LUT_X16(p##3) \
+    ZMATH__LUT_X16(p##4) ZMATH__LUT_X16(p##5) ZMATH__LUT_X16(p##6) ZMATH__LUT_X16(p##7) \
+    ZMATH__LUT_X16(p##8) ZMATH__LUT_X16(p##9) ZMATH__LUT_X16(p##A) ZMATH__LUT_X16(p##B) \
+    ZMATH__LUT_X16(p##C) ZMATH__LUT_X16(p##D) ZMATH__LUT_X16(p##E) ZMATH__LUT_X16(p##F)
+#define ZMATH__LUT_X4096(p)                                                     \
+    ZMATH__LUT_X256(p##0) ZMATH__LUT_X256(p##1) ZMATH__LUT_X256(p##2) ZMATH__LUT_X256(p##3) \
+    ZMATH__LUT_X256(p##4) ZMATH__LUT_X256(p##5) ZMATH__LUT_X256(p##6) ZMATH__LUT_X256(p##7) \
+    ZMATH__LUT_X256(p##8) ZMATH__LUT_X256(p##9) ZMATH__LUT_X256(p##A) ZMATH__LUT_X256(p##B) \
+    ZMATH__LUT_X256(p##C) ZMATH__LUT_X256(p##D) ZMATH__LUT_X256(p##E) ZMATH__LUT_X256(p##F)
+
+// Leading hex digit, for quarter sizes that are not a power of 16.
+#define ZMATH__LUT_T2(X)  X(0x0) X(0x1)
+#define ZMATH__LUT_T4(X)  ZMATH__LUT_T2(X) X(0x2) X(0x3)
+#define ZMATH__LUT_T8(X)  ZMATH__LUT_T4(X) X(0x4) X(0x5) X(0x6) X(0x7)
+#define ZMATH__LUT_T16(X) ZMATH__LUT_T8(X) X(0x8) X(0x9) X(0xA) X(0xB) \
+                          X(0xC) X(0xD) X(0xE) X(0xF)
+
+#if   ZMATH_TRIG_LUT_BITS == 4
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T4(ZMATH__LUT_X1)
+#elif ZMATH_TRIG_LUT_BITS == 5
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T8(ZMATH__LUT_X1)
+#elif ZMATH_TRIG_LUT_BITS == 6
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T16(ZMATH__LUT_X1)
+#elif ZMATH_TRIG_LUT_BITS == 7
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T2(ZMATH__LUT_X16)
+#elif ZMATH_TRIG_LUT_BITS == 8
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T4(ZMATH__LUT_X16)
+#elif ZMATH_TRIG_LUT_BITS == 9
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T8(ZMATH__LUT_X16)
+#elif ZMATH_TRIG_LUT_BITS == 10
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T16(ZMATH__LUT_X16)
+#elif ZMATH_TRIG_LUT_BITS == 11
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T2(ZMATH__LUT_X256)
+#elif ZMATH_TRIG_LUT_BITS == 12
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T4(ZMATH__LUT_X256)
+#elif ZMATH_TRIG_LUT_BITS == 13
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T8(ZMATH__LUT_X256)
+#elif ZMATH_TRIG_LUT_BITS == 14
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T16(ZMATH__LUT_X256)
+#elif ZMATH_TRIG_LUT_BITS == 15
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T2(ZMATH__LUT_X4096)
+#else
+#   define ZMATH__LUT_ROWS ZMATH__LUT_T4(ZMATH__LUT_X4096)
+#endif
+
+static ZMATH_CONSTEXPR const float zmath__sin_table[ZMATH__LUT_QUARTER + 1] = { ZMATH__LUT_ROWS 1.0f };
+
+// Phase to quarter-wave entry: the top two table-index bits are the
+// quadrant. Odd quadrants read the quarter wave backwards (the neighbour
+// entry one step on is then j - 1, never past either end), the second half
+// negates.
+static inline ZMATH_CONSTEXPR float zmath__sin_turn_k(uint32_t phase)
+{
+#if ZMATH_TRIG_LUT_INTERP == ZMATH_TRIG_LUT_NEAREST
+    phase += 1u << (ZMATH__LUT_SHIFT - 1);
+#endif
+    uint32_t i = phase >> ZMATH__LUT_SHIFT;
+    uint32_t q = i >> (ZMATH_TRIG_LUT_BITS - 2);
+    uint32_t back = 0u - (q & 1u);
+    uint32_t j = i & (ZMATH__LUT_QUARTER - 1u);
+    j ^= back & (j ^ (ZMATH__LUT_QUARTER - j));
+    float r = zmath__sin_table[j];
+#if ZMATH_TRIG_LUT_INTERP != ZMATH_TRIG_LUT_NEAREST
+    int32_t low = (int32_t)(phase & ((1u << ZMATH__LUT_SHIFT) - 1u));
+    float t = (float)low * (1.0f / (float)(1u << ZMATH__LUT_SHIFT));
+    r += (zmath__sin_table[j + 1u + (back << 1)] - r) * t;
+#endif
+    uint32_t sign = (q & 2u) << 30;
+    return zmath__uint_as_float(zmath__float_as_uint(r) ^ sign);
+}
+
+// The turn fraction of the reduced angle lies in [-0.5, 0.5]; it is scaled
+// by 2^31 and doubled so the int32 conversion cannot overflow at +-pi.
+static inline ZMATH_CONSTEXPR uint32_t zmath__rad2turn_k(float x)
+{
+    float t = zmath__reduce_tau_k(x) * (1.0f / ZMATH_TAU);
+    return (uint32_t)(int32_t)(t * 2147483648.0f) << 1;
+}
+
+#endif // ZMATH_TRIG_LUT
+
+// Logic and comparison.
+
+ZMATHDEF bool zmath_is_near(float a, float b, float tol) 
+{
+    return zmath_abs(a - b) <= tol;
+}
+
+ZMATHDEF bool zmath_isnan(float x) 
+{
+    uint32_t u = zmath__float_as_uint(x);
+    return (u & 0x7F800000) == 0x7F800000 && (u & 0x007FFFFF) != 0;
+}
+
+ZMATHDEF bool zmath_isinf(float x) 
+{
+    uint32_t u = zmath__float_as_uint(x);
+    return (u & 0x7FFFFFFF) == 0x7F800000;
+}
+
+// Interpolation.
+
+ZMATHDEF float zmath_step(float edge, float x) 
+{
+    return (x < edge) ? 0.0f : 1.0f;
+}
+
+ZMATHDEF float zmath_smoothstep(float edge0, float edge1, float x) 
+{
+    float t = zmath_clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f); 
+    return t * t * (3.0f - 2.0f * t);
+}
+
+ZMATHDEF float zmath_smootherstep(float edge0, float edge1, float x) 
+{
+    float t = zmath_clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+ZMATHDEF float zmath_lerp(float a, float b, float t) 
+{
+    return (1.0f - t) * a + t * b;
+}
+
+ZMATHDEF float zmath_inv_lerp(float a, float b, float v) 
+{
+    return (v - a) / (b - a);
+}
+
+ZMATHDEF float zmath_remap(float iMin, float iMax, float oMin, float oMax, float v) 
+{
+    float t = zmath_inv_lerp(iMin, iMax, v);
+    return zmath_lerp(oMin, oMax, t);
+}
+
+// Basic arithmetic.
+
+ZMATHDEF float zmath_abs(float x) 
+{
+
+    uint32_t u = zmath__float_as_uint(x);
+    u &= 0x7FFFFFFF;
+    return zmath__uint_as_float(u);
+}
+
+ZMATHDEF float zmath_min(float a, float b) 
+{
+    return (a < b) ? a : b;
+}
+
+ZMATHDEF float zmath_max(float a, float b) 
+{
+    return (a > b) ? a : b;
+}
+
+// Two selects rather than branches; NaN passes through as before.
+ZMATHDEF float zmath_clamp(float x, float min_val, float max_val) 
+{
+    x = (x < min_val) ? min_val : x;
+    return (x > max_val) ? max_val : x;
+}
+
+ZMATHDEF float zmath_sign(float x) 
+{
+    if (x > 0.0f) 
+    {
+        return 1.0f;
+    }
+    if (x < 0.0f) 
+    {
+        return -1.0f;
+    }
+    return 0.0f;
+}
+
+ZMATHDEF float zmath_copysign(float x, float y) 
+{
+    uint32_t ix = zmath__float_as_uint(x);
+    uint32_t iy = zmath__float_as_uint(y);
+    ix = (ix & 0x7FFFFFFF) | (iy & 0x80000000);
+    return zmath__uint_as_float(ix);
+}
+
+// Rounding.
+
+ZMATHDEF float zmath_floor(float x) 
+{
+    return zmath__floor_k(x);
+}
+
+ZMATHDEF float zmath_ceil(float x) 
+{
+    return zmath__ceil_k(x);
+}
+
+ZMATHDEF float zmath_round(float x) 
+{
+    return zmath__round_k(x);
+}
+
+ZMATHDEF float zmath_fract(float x) 
+{
+    return x - zmath__floor_k(x); 
+}
+
+ZMATHDEF float zmath_fmod(float x, float y) 
+{ 
+    if (zmath_abs(y) < ZMATH_EPSILON) 
+    {
+        return 0.0f;
+    }
+    return x - y * zmath__trunc_k(x / y); 
+}
+
+ZMATHDEF float zmath_mod(float x, float y) 
+{ 
+    if (zmath_abs(y) < ZMATH_EPSILON)
+    {
+        return 0.0f;
+    }
+    return x - y * zmath__floor_k(x / y); 
+}
+
+// Power and roots.
+
+ZMATHDEF float zmath_invsqrt(float x)
+{
+    return ZMATH__INVSQRT_K(x);
+}
+
+ZMATHDEF float zmath_sqrt(float x)
+{
+    return zmath__sqrt_k(x);
+}
+
+ZMATHDEF float zmath_rsqrt_n(float x, int iterations)
+{
+    return zmath__rsqrt_n_k(x, iterations);
+}
+
+ZMATHDEF float zmath_rcp(float x)
+{
+    return zmath__rcp_k(x);
+}
+
+ZMATHDEF float zmath_hypot(float x, float y)
+{
+    x = zmath_abs(x);
+    y = zmath_abs(y);
+    float min_val = zmath_min(x, y);
+    float max_val = zmath_max(x, y);
+    if (max_val == 0.0f)
+    {
+        return 0.0f;
+    }
+    float r = min_val / max_val;
+    return max_val * zmath_sqrt(1.0f + r * r);
+}
+
+ZMATHDEF float zmath_log(float x)
+{
+    return ZMATH__LOG_K(x);
+}
+
+ZMATHDEF float zmath_log2(float x)
+{
+    return ZMATH__LOG2_K(x);
+}
+
+ZMATHDEF float zmath_exp(float x)
+{
+    return ZMATH__EXP_K(x);
+}
+
+ZMATHDEF float zmath_exp2(float x)
+{
+    return ZMATH__EXP2_K(x);
+}
+
+ZMATHDEF float zmath_pow(float x, float y)
+{
+    return ZMATH__POW_K(x, y);
+}
+
+// Trigonometry.
+
+ZMATHDEF float zmath_sin(float x)
+{
+    return ZMATH__SIN_K(x);
+}
+
+ZMATHDEF float zmath_cos(float x)
+{
+    return ZMATH__COS_K(x);
+}
+
+ZMATHDEF float zmath_tan(float x)
+{
+    return zmath__tan_k(x);
+}
+
+ZMATHDEF void zmath_sincos(float x, float* s, float* c)
+{
+    ZMATH__SINCOS_K(x, s, c);
+}
+
+ZMATHDEF float zmath_sin_turns(float t)
+{
+    return ZMATH__SIN_K(zmath__turns_k(t));
+}
+
+ZMATHDEF float zmath_cos_turns(float t)
+{
+    return ZMATH__COS_K(zmath__turns_k(t));
+}
+
+ZMATHDEF void zmath_sincos_turns(float t, float* s, float* c)
+{
+    ZMATH__SINCOS_K(zmath__turns_k(t), s, c);
+}
+
+ZMATHDEF float zmath_atan(float x)
+{
+    return zmath__atan_k(x);
+}
+
+ZMATHDEF float zmath_atan2(float y, float x)
+{
+    return zmath__atan2_k(y, x);
+}
+
+ZMATHDEF float zmath_asin(float x)
+{
+    return zmath__asin_k(x);
+}
+
+ZMATHDEF float zmath_acos(float x)
+{
+    return zmath__acos_k(x);
+}
+
+ZMATHDEF float zmath_deg2rad(float deg) 
+{ 
+    return deg * (ZMATH_PI / 180.0f); 
+}
+
+ZMATHDEF float zmath_rad2deg(float rad) 
+{ 
+    return rad * (180.0f / ZMATH_PI); 
+}
+
+// Accuracy tiers.
+
+ZMATHDEF float zmath_sin_fast(float x)
+{
+    return zmath__sin_fast_k(x);
+}
+
+ZMATHDEF float zmath_cos_fast(float x)
+{
+    return zmath__cos_fast_k(x);
+}
+
+ZMATHDEF void zmath_sincos_fast(float x, float* s, float* c)
+{
+    zmath__sincos_fast_k(x, s, c);
+}
+
+ZMATHDEF float zmath_exp_fast(float x)
+{
+    return zmath__exp_fast_k(x);
+}
+
+ZMATHDEF float zmath_log_fast(float x)
+{
+    return zmath__log_fast_k(x);
+}
+
+ZMATHDEF float zmath_invsqrt_fast(float x)
+{
+    return zmath__invsqrt_fast_k(x);
+}
+
+ZMATHDEF float zmath_sin_precise(float x)
+{
+    return zmath__sin_precise_k(x);
+}
+
+ZMATHDEF float zmath_cos_precise(float x)
+{
+    return zmath__cos_precise_k(x);
+}
+
+ZMATHDEF void zmath_sincos_precise(float x, float* s, float* c)
+{
+    zmath__sincos_precise_k(x, s, c);
+}
+
+ZMATHDEF float zmath_exp_precise(float x)
+{
+    return zmath__exp_precise_k(x);
+}
+
+ZMATHDEF float zmath_log_precise(float x)
+{
+    return zmath__log_precise_k(x);
+}
+
+ZMATHDEF float zmath_invsqrt_precise(float x)
+{
+    return zmath__invsqrt_precise_k(x);
+}
+
+#ifdef ZMATH_TRIG_LUT
+
+// Table-driven trigonometry.
+
+ZMATHDEF float zmath_sin_lut(float x)
+{
+    return zmath__sin_turn_k(zmath__rad2turn_k(x));
+}
+
+ZMATHDEF float zmath_cos_lut(float x)
+{
+    return zmath__sin_turn_k(zmath__rad2turn_k(x) + 0x40000000u);
+}
+
+ZMATHDEF float zmath_sin_turn(uint32_t phase)
+{
+    return zmath__sin_turn_k(phase);
+}
+
+ZMATHDEF float zmath_cos_turn(uint32_t phase)
+{
+    return zmath__sin_turn_k(phase + 0x40000000u);
+}
+
+ZMATHDEF uint32_t zmath_rad2turn(float rad)
+{
+    return zmath__rad2turn_k(rad);
+}
+
+ZMATHDEF uint32_t zmath_sin_turn_fill(uint32_t phase, uint32_t step, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(SIN_TURN_FILL, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = zmath__sin_turn_k(phase);
+        phase += step;
+    }
+    ZMATH__PROF_END(SIN_TURN_FILL);
+    return phase;
+}
+
+#endif // ZMATH_TRIG_LUT
+
+// Vector math.
+
+ZMATHDEF zvec2 zmath_v2_add(zvec2 a, zvec2 b) 
+{ 
+    zvec2 r = {a.x+b.x, a.y+b.y}; 
+    return r; 
+}
+
+ZMATHDEF zvec2 zmath_v2_sub(zvec2 a, zvec2 b) 
+{
+    zvec2 r = {a.x-b.x, a.y-b.y}; 
+    return r; 
+}
+
+ZMATHDEF zvec2 zmath_v2_scale(zvec2 v, float s) 
+{ 
+    zvec2 r = {v.x*s, v.y*s}; 
+    return r; 
+}
+
+ZMATHDEF float zmath_v2_dot(zvec2 a, zvec2 b) 
+{ 
+    return a.x*b.x + a.y*b.y; 
+}
+
+ZMATHDEF float zmath_v2_len(zvec2 v) 
+{ 
+    return zmath_sqrt(zmath_v2_dot(v, v)); 
+}
+
+ZMATHDEF zvec2 zmath_v2_norm(zvec2 v) 
+{ 
+    float d = zmath_v2_dot(v, v);
+    return (d > ZMATH_EPSILON * ZMATH_EPSILON) ? zmath_v2_scale(v, zmath__rsqrt_norm_k(d)) : v;
+}
+
+ZMATHDEF zvec3 zmath_v3_add(zvec3 a, zvec3 b) 
+{ 
+    zvec3 r = {a.x+b.x, a.y+b.y, a.z+b.z}; 
+    return r; 
+}
+
+ZMATHDEF zvec3 zmath_v3_sub(zvec3 a, zvec3 b) 
+{ 
+    zvec3 r = {a.x-b.x, a.y-b.y, a.z-b.z}; 
+    return r; 
+}
+
+ZMATHDEF zvec3 zmath_v3_scale(zvec3 v, float s) 
+{ 
+    zvec3 r = {v.x*s, v.y*s, v.z*s}; 
+    return r; 
+}
+
+ZMATHDEF float zmath_v3_dot(zvec3 a, zvec3 b) 
+{ 
+    return a.x*b.x + a.y*b.y + a.z*b.z; 
+}
+
+ZMATHDEF zvec3 zmath_v3_cross(zvec3 a, zvec3 b) 
+{
+    zvec3 r = { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x };
+    return r;
+}
+
+ZMATHDEF float zmath_v3_len(zvec3 v) 
+{ 
+    return zmath_sqrt(zmath_v3_dot(v, v)); 
+}
+
+ZMATHDEF zvec3 zmath_v3_norm(zvec3 v) 
+{
+    float d = zmath_v3_dot(v, v);
+    return (d > ZMATH_EPSILON * ZMATH_EPSILON) ? zmath_v3_scale(v, zmath__rsqrt_norm_k(d)) : v;
+}
+
+// Batch kernels.
+
+#define ZMATH__UNARY_ARRAY(name, id, kernel)                        \
+    ZMATHDEF void name(const float* in, float* out, size_t n)       \
+    {                                                               \
+        ZMATH__PROF_BEGIN(id, n);                                   \
+        for (size_t i = 0; i < n; i++)                              \
+        {                                                           \
+            out[i] = kernel(in[i]);                                 \
+        }                                                           \
+        ZMATH__PROF_END(id);                                        \
+    }
+
+// With ZMATH_SIMD, kernels that have a lane version run full native-width
+// blocks through it and finish the tail with the scalar kernel.
+#ifdef ZMATH_SIMD
+#   ifdef ZMATH_SIMD_AVX2
+#       define ZMATH__LANE(op) zmath_v8f_##op
+#   else
+#       define ZMATH__LANE(op) zmath_v4f_##op
+#   endif
+#   define ZMATH__LANE_ARRAY(name, id, kernel, lane)                    \
+    ZMATHDEF void name(const float* in, float* out, size_t n)           \
+    {                                                                   \
+        ZMATH__PROF_BEGIN(id, n);                                       \
+        size_t i = 0;                                                   \
+        for (; ZMATH__RUNTIME && i + ZMATH_SIMD_WIDTH <= n; i += ZMATH_SIMD_WIDTH) \
+        {                                                               \
+            ZMATH__LANE(store)(out + i, lane(ZMATH__LANE(load)(in + i))); \
+        }                                                               \
+        for (; i < n; i++)                                              \
+        {                                                               \
+            out[i] = kernel(in[i]);                                     \
+        }                                                               \
+        ZMATH__PROF_END(id);                                            \
+    }
+#else
+#   define ZMATH__LANE_ARRAY(name, id, kernel, lane) ZMATH__UNARY_ARRAY(name, id, kernel)
+#endif
+
+// The lanes implement the default tier only; other tiers stay scalar.
+#if ZMATH_ACCURACY == ZMATH_ACCURACY_DEFAULT
+#   define ZMATH__TIER_ARRAY(name, id, kernel, lane) ZMATH__LANE_ARRAY(name, id, kernel, lane)
+#else
+#   define ZMATH__TIER_ARRAY(name, id, kernel, lane) ZMATH__UNARY_ARRAY(name, id, kernel)
+#endif
+
+// Without lanes, sine and cosine go block by block: a block with no argument
+// at or past ZMATH__TAU_BIG runs the branch-free Cody-Waite kernel, which
+// vectorizes, and any other block the full one. The precise tier has no
+// branch-free kernel and stays element by element.
+#define ZMATH__TAU_BLOCK 256
+
+static inline ZMATH_CONSTEXPR bool zmath__tau_big_any_k(const float* in, size_t n)
+{
+    int32_t big = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        big |= !(zmath__abs_k(in[i]) < ZMATH__TAU_BIG);
+    }
+    return big != 0;
+}
+
+#define ZMATH__TAU_ARRAY(name, id, kernel, rkernel)                         \
+    ZMATHDEF void name(const float* in, float* out, size_t n)               \
+    {                                                                       \
+        ZMATH__PROF_BEGIN(id, n);                                           \
+        for (size_t i = 0; i < n; i += ZMATH__TAU_BLOCK)                    \
+        {                                                                   \
+            size_t end = (n - i < ZMATH__TAU_BLOCK) ? n : i + ZMATH__TAU_BLOCK; \
+            if (zmath__tau_big_any_k(in + i, end - i))                      \
+            {                                                               \
+                for (size_t j = i; j < end; j++)                            \
+                {                                                           \
+                    out[j] = kernel(in[j]);                                 \
+                }                                                           \
+            }                                                               \
+            else                                                            \
+            {                                                               \
+                for (size_t j = i; j < end; j++)                            \
+                {                                                           \
+                    out[j] = rkernel(zmath__reduce_tau_cw_k(in[j]));        \
+                }                                                           \
+            }                                                               \
+        }                                                                   \
+        ZMATH__PROF_END(id);                                                \
+    }
+
+#if defined(ZMATH_SIMD) && ZMATH_ACCURACY == ZMATH_ACCURACY_DEFAULT
+ZMATH__LANE_ARRAY(zmath_sin_array, SIN_ARRAY, ZMATH__SIN_K, ZMATH__LANE(sin))
+ZMATH__LANE_ARRAY(zmath_cos_array, COS_ARRAY, ZMATH__COS_K, ZMATH__LANE(cos))
+#elif ZMATH_ACCURACY == ZMATH_ACCURACY_PRECISE
+ZMATH__UNARY_ARRAY(zmath_sin_array, SIN_ARRAY, ZMATH__SIN_K)
+ZMATH__UNARY_ARRAY(zmath_cos_array, COS_ARRAY, ZMATH__COS_K)
+#else
+ZMATH__TAU_ARRAY(zmath_sin_array, SIN_ARRAY, ZMATH__SIN_K, ZMATH__SIN_R_K)
+ZMATH__TAU_ARRAY(zmath_cos_array, COS_ARRAY, ZMATH__COS_K, ZMATH__COS_R_K)
+#endif
+ZMATH__UNARY_ARRAY(zmath_tan_array, TAN_ARRAY, zmath__tan_k)
+ZMATH__UNARY_ARRAY(zmath_asin_array, ASIN_ARRAY, zmath__asin_k)
+ZMATH__UNARY_ARRAY(zmath_acos_array, ACOS_ARRAY, zmath__acos_k)
+ZMATH__LANE_ARRAY(zmath_atan_array, ATAN_ARRAY, zmath__atan_k, ZMATH__LANE(atan))
+ZMATH__TIER_ARRAY(zmath_exp_array, EXP_ARRAY, ZMATH__EXP_K, ZMATH__LANE(exp))
+ZMATH__UNARY_ARRAY(zmath_exp2_array, EXP2_ARRAY, ZMATH__EXP2_K)
+ZMATH__TIER_ARRAY(zmath_log_array, LOG_ARRAY, ZMATH__LOG_K, ZMATH__LANE(log))
+ZMATH__UNARY_ARRAY(zmath_log2_array, LOG2_ARRAY, ZMATH__LOG2_K)
+ZMATH__UNARY_ARRAY(zmath_sqrt_array, SQRT_ARRAY, zmath__sqrt_k)
+ZMATH__TIER_ARRAY(zmath_invsqrt_array, INVSQRT_ARRAY, ZMATH__INVSQRT_K, ZMATH__LANE(invsqrt))
+
+// One range reduction per element feeds both outputs.
+ZMATHDEF void zmath_sincos_array(const float* in, float* s, float* c, size_t n)
+{
+    ZMATH__PROF_BEGIN(SINCOS_ARRAY, n);
+    size_t i = 0;
+#if defined(ZMATH_SIMD) && ZMATH_ACCURACY == ZMATH_ACCURACY_DEFAULT
+#   ifdef ZMATH_SIMD_AVX2
+    zvec8f vs, vc;
+#   else
+    zvec4f vs, vc;
+#   endif
+    for (; ZMATH__RUNTIME && i + ZMATH_SIMD_WIDTH <= n; i += ZMATH_SIMD_WIDTH)
+    {
+        ZMATH__LANE(sincos)(ZMATH__LANE(load)(in + i), &vs, &vc);
+        ZMATH__LANE(store)(s + i, vs);
+        ZMATH__LANE(store)(c + i, vc);
+    }
+#endif
+#if ZMATH_ACCURACY == ZMATH_ACCURACY_PRECISE
+    for (; i < n; i++)
+    {
+        float x = in[i];
+        ZMATH__SINCOS_K(x, &s[i], &c[i]);
+    }
+#else
+    for (; i < n; i += ZMATH__TAU_BLOCK)
+    {
+        size_t end = (n - i < ZMATH__TAU_BLOCK) ? n : i + ZMATH__TAU_BLOCK;
+        if (zmath__tau_big_any_k(in + i, end - i))
+        {
+            for (size_t j = i; j < end; j++)
+            {
+                float x = in[j];
+                ZMATH__SINCOS_K(x, &s[j], &c[j]);
+            }
+        }
+        else
+        {
+            for (size_t j = i; j < end; j++)
+            {
+                float r = zmath__reduce_tau_cw_k(in[j]);
+                s[j] = ZMATH__SIN_R_K(r);
+                c[j] = ZMATH__COS_R_K(r);
+            }
+        }
+    }
+#endif
+    ZMATH__PROF_END(SINCOS_ARRAY);
+}
+
+ZMATHDEF void zmath_atan2_array(const float* y, const float* x, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(ATAN2_ARRAY, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = zmath__atan2_k(y[i], x[i]);
+    }
+    ZMATH__PROF_END(ATAN2_ARRAY);
+}
+
+ZMATHDEF void zmath_pow_array(const float* x, const float* y, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(POW_ARRAY, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = ZMATH__POW_K(x[i], y[i]);
+    }
+    ZMATH__PROF_END(POW_ARRAY);
+}
+
+// Reductions.
+// The inner loops update 16 accumulators element-wise, which vectorizes
+// without reassociating any float sum.
+#define ZMATH__RED_LANES 16
+#define ZMATH__RED_BLOCK 1024
+
+// Folds the lanes as a balanced tree.
+static inline ZMATH_CONSTEXPR float zmath__red_fold_k(float* acc)
+{
+    for (int w = ZMATH__RED_LANES / 2; w > 0; w /= 2)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            acc[j] += acc[j + w];
+        }
+    }
+    return acc[0];
+}
+
+// Sum of one block of up to ZMATH__RED_BLOCK terms: in[i], or in[i] * b[i]
+// when b is given.
+static inline ZMATH_CONSTEXPR float zmath__red_block_k(const float* in, const float* b, size_t n)
+{
+    float acc[ZMATH__RED_LANES] = { 0.0f };
+    size_t i = 0;
+    if (b)
+    {
+        for (; i + ZMATH__RED_LANES <= n; i += ZMATH__RED_LANES)
+        {
+            for (int j = 0; j < ZMATH__RED_LANES; j++)
+            {
+                acc[j] += in[i + j] * b[i + j];
+            }
+        }
+        for (; i < n; i++)
+        {
+            acc[i % ZMATH__RED_LANES] += in[i] * b[i];
+        }
+    }
+    else
+    {
+        for (; i + ZMATH__RED_LANES <= n; i += ZMATH__RED_LANES)
+        {
+            for (int j = 0; j < ZMATH__RED_LANES; j++)
+            {
+                acc[j] += in[i + j];
+            }
+        }
+        for (; i < n; i++)
+        {
+            acc[i % ZMATH__RED_LANES] += in[i];
+        }
+    }
+    return zmath__red_fold_k(acc);
+}
+
+// Block sums are merged like a binary counter: after block k, the stack
+// holds one partial sum per set bit of k + 1, each over a power-of-two run
+// of blocks, which gives the pairwise tree without recursion.
+static inline ZMATH_CONSTEXPR float zmath__red_sum_k(const float* in, const float* b, size_t n)
+{
+    float stack[64] = { 0.0f };
+    int top = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += ZMATH__RED_BLOCK)
+    {
+        size_t m = n - i < ZMATH__RED_BLOCK ? n - i : ZMATH__RED_BLOCK;
+        float s = zmath__red_block_k(in + i, b ? b + i : b, m);
+        for (size_t k = count; k & 1u; k >>= 1)
+        {
+            s = stack[--top] + s;
+        }
+        stack[top++] = s;
+        count++;
+    }
+    float total = 0.0f;
+    while (top > 0)
+    {
+        total = stack[--top] + total;
+    }
+    return total;
+}
+
+ZMATHDEF float zmath_sum_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(SUM_ARRAY, n);
+    float r = zmath__red_sum_k(in, NULL, n);
+    ZMATH__PROF_END(SUM_ARRAY);
+    return r;
+}
+
+ZMATHDEF float zmath_sum_sq_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(SUM_SQ_ARRAY, n);
+    float r = zmath__red_sum_k(in, in, n);
+    ZMATH__PROF_END(SUM_SQ_ARRAY);
+    return r;
+}
+
+ZMATHDEF float zmath_dot_array(const float* a, const float* b, size_t n)
+{
+    ZMATH__PROF_BEGIN(DOT_ARRAY, n);
+    float r = zmath__red_sum_k(a, b, n);
+    ZMATH__PROF_END(DOT_ARRAY);
+    return r;
+}
+
+ZMATHDEF float zmath_len_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(LEN_ARRAY, n);
+    float r = zmath_sqrt(zmath__red_sum_k(in, in, n));
+    ZMATH__PROF_END(LEN_ARRAY);
+    return r;
+}
+
+// Kahan summation in each lane, then over the lane sums and their
+// compensations.
+ZMATHDEF float zmath_sum_kahan_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(SUM_KAHAN_ARRAY, n);
+    float s[ZMATH__RED_LANES] = { 0.0f }, c[ZMATH__RED_LANES] = { 0.0f };
+    size_t i = 0;
+    for (; i + ZMATH__RED_LANES <= n; i += ZMATH__RED_LANES)
+    {
+        for (int j = 0; j < ZMATH__RED_LANES; j++)
+        {
+            float y = in[i + j] - c[j];
+            float t = s[j] + y;
+            c[j] = (t - s[j]) - y;
+            s[j] = t;
+        }
+    }
+    for (size_t j = 0; j < n - i; j++)
+    {
+        float y = in[i + j] - c[j];
+        float t = s[j] + y;
+        c[j] = (t - s[j]) - y;
+        s[j] = t;
+    }
+    float total = 0.0f, comp = 0.0f;
+    for (int j = 0; j < 2 * ZMATH__RED_LANES; j++)
+    {
+        float y = (j < ZMATH__RED_LANES ? s[j] : -c[j - ZMATH__RED_LANES]) - comp;
+        float t = total + y;
+        comp = (t - total) - y;
+        total = t;
+    }
+    ZMATH__PROF_END(SUM_KAHAN_ARRAY);
+    return total;
+}
+
+// x < m ? x : m maps onto the hardware min, and NaN never replaces m.
+static inline ZMATH_CONSTEXPR float zmath__red_min_k(const float* in, size_t n)
+{
+    float acc[ZMATH__RED_LANES];
+    for (int j = 0; j < ZMATH__RED_LANES; j++)
+    {
+        acc[j] = ZMATH_INFINITY;
+    }
+    size_t i = 0;
+    for (; i + ZMATH__RED_LANES <= n; i += ZMATH__RED_LANES)
+    {
+        for (int j = 0; j < ZMATH__RED_LANES; j++)
+        {
+            acc[j] = in[i + j] < acc[j] ? in[i + j] : acc[j];
+        }
+    }
+    for (; i < n; i++)
+    {
+        acc[0] = in[i] < acc[0] ? in[i] : acc[0];
+    }
+    float m = acc[0];
+    for (int j = 1; j < ZMATH__RED_LANES; j++)
+    {
+        m = acc[j] < m ? acc[j] : m;
+    }
+    return m;
+}
+
+static inline ZMATH_CONSTEXPR float zmath__red_max_k(const float* in, size_t n)
+{
+    float acc[ZMATH__RED_LANES];
+    for (int j = 0; j < ZMATH__RED_LANES; j++)
+    {
+        acc[j] = -ZMATH_INFINITY;
+    }
+    size_t i = 0;
+    for (; i + ZMATH__RED_LANES <= n; i += ZMATH__RED_LANES)
+    {
+        for (int j = 0; j < ZMATH__RED_LANES; j++)
+        {
+            acc[j] = in[i + j] > acc[j] ? in[i + j] : acc[j];
+        }
+    }
+    for (; i < n; i++)
+    {
+        acc[0] = in[i] > acc[0] ? in[i] : acc[0];
+    }
+    float m = acc[0];
+    for (int j = 1; j < ZMATH__RED_LANES; j++)
+    {
+        m = acc[j] > m ? acc[j] : m;
+    }
+    return m;
+}
+
+ZMATHDEF float zmath_min_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(MIN_ARRAY, n);
+    float r = zmath__red_min_k(in, n);
+    ZMATH__PROF_END(MIN_ARRAY);
+    return r;
+}
+
+ZMATHDEF float zmath_max_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(MAX_ARRAY, n);
+    float r = zmath__red_max_k(in, n);
+    ZMATH__PROF_END(MAX_ARRAY);
+    return r;
+}
+
+// Each lane keeps its best value and a uint32 index relative to the start
+// of a chunk of at most 2^31 elements, so the lanes stay 32 bits wide. A
+// later lane or chunk only wins on a strictly better value or, on a tie, a
+// smaller index.
+static inline ZMATH_CONSTEXPR size_t zmath__red_arg_k(const float* in, size_t n, float sign)
+{
+    float best = ZMATH_INFINITY;
+    size_t best_i = 0;
+    for (size_t base = 0; base < n; base += (size_t)1 << 31)
+    {
+        size_t m = n - base;
+        m = m < ((size_t)1 << 31) ? m : ((size_t)1 << 31);
+        const float* p = in + base;
+        float v[ZMATH__RED_LANES];
+        uint32_t idx[ZMATH__RED_LANES] = { 0 };
+        for (int j = 0; j < ZMATH__RED_LANES; j++)
+        {
+            v[j] = ZMATH_INFINITY;
+        }
+        size_t i = 0;
+        for (; i + ZMATH__RED_LANES <= m; i += ZMATH__RED_LANES)
+        {
+            for (int j = 0; j < ZMATH__RED_LANES; j++)
+            {
+                float x = p[i + j] * sign;
+                bool lt = x < v[j];
+                v[j] = lt ? x : v[j];
+                idx[j] = lt ? (uint32_t)(i + j) : idx[j];
+            }
+        }
+        for (; i < m; i++)
+        {
+            float x = p[i] * sign;
+            size_t j = i % ZMATH__RED_LANES;
+            bool lt = x < v[j];
+            v[j] = lt ? x : v[j];
+            idx[j] = lt ? (uint32_t)i : idx[j];
+        }
+        for (int j = 0; j < ZMATH__RED_LANES; j++)
+        {
+            size_t k = base + idx[j];
+            if (v[j] < best || (v[j] == best && v[j] != ZMATH_INFINITY && k < best_i))
+            {
+                best = v[j];
+                best_i = k;
+            }
+        }
+    }
+    return best_i;
+}
+
+ZMATHDEF size_t zmath_argmin_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(ARGMIN_ARRAY, n);
+    size_t r = zmath__red_arg_k(in, n, 1.0f);
+    ZMATH__PROF_END(ARGMIN_ARRAY);
+    return r;
+}
+
+ZMATHDEF size_t zmath_argmax_array(const float* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(ARGMAX_ARRAY, n);
+    size_t r = zmath__red_arg_k(in, n, -1.0f);
+    ZMATH__PROF_END(ARGMAX_ARRAY);
+    return r;
+}
+
+// Lane arrays per component, so each run of ZMATH__RED_LANES points
+// reduces as three independent vector loops over in[i + j].x, .y and .z.
+ZMATHDEF zaabb zmath_v3_bounds(const zvec3* in, size_t n)
+{
+    ZMATH__PROF_BEGIN(V3_BOUNDS, n);
+    float lx[ZMATH__RED_LANES], ly[ZMATH__RED_LANES], lz[ZMATH__RED_LANES];
+    float hx[ZMATH__RED_LANES], hy[ZMATH__RED_LANES], hz[ZMATH__RED_LANES];
+    for (int j = 0; j < ZMATH__RED_LANES; j++)
+    {
+        lx[j] = ly[j] = lz[j] = ZMATH_INFINITY;
+        hx[j] = hy[j] = hz[j] = -ZMATH_INFINITY;
+    }
+    size_t i = 0;
+    for (; i + ZMATH__RED_LANES <= n; i += ZMATH__RED_LANES)
+    {
+        for (int j = 0; j < ZMATH__RED_LANES; j++)
+        {
+            zvec3 v = in[i + j];
+            lx[j] = v.x < lx[j] ? v.x : lx[j];
+            ly[j] = v.y < ly[j] ? v.y : ly[j];
+            lz[j] = v.z < lz[j] ? v.z : lz[j];
+            hx[j] = v.x > hx[j] ? v.x : hx[j];
+            hy[j] = v.y > hy[j] ? v.y : hy[j];
+            hz[j] = v.z > hz[j] ? v.z : hz[j];
+        }
+    }
+    for (; i < n; i++)
+    {
+        zvec3 v = in[i];
+        lx[0] = v.x < lx[0] ? v.x : lx[0];
+        ly[0] = v.y < ly[0] ? v.y : ly[0];
+        lz[0] = v.z < lz[0] ? v.z : lz[0];
+        hx[0] = v.x > hx[0] ? v.x : hx[0];
+        hy[0] = v.y > hy[0] ? v.y : hy[0];
+        hz[0] = v.z > hz[0] ? v.z : hz[0];
+    }
+    for (int j = 1; j < ZMATH__RED_LANES; j++)
+    {
+        lx[0] = lx[j] < lx[0] ? lx[j] : lx[0];
+        ly[0] = ly[j] < ly[0] ? ly[j] : ly[0];
+        lz[0] = lz[j] < lz[0] ? lz[j] : lz[0];
+        hx[0] = hx[j] > hx[0] ? hx[j] : hx[0];
+        hy[0] = hy[j] > hy[0] ? hy[j] : hy[0];
+        hz[0] = hz[j] > hz[0] ? hz[j] : hz[0];
+    }
+    zaabb b = { { lx[0], ly[0], lz[0] }, { hx[0], hy[0], hz[0] } };
+    ZMATH__PROF_END(V3_BOUNDS);
+    return b;
+}
+
+ZMATHDEF zaabb zmath_v3_soa_bounds(zvec3_soa v)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_BOUNDS, v.count);
+    zaabb b = {
+        { zmath__red_min_k(v.x, v.count), zmath__red_min_k(v.y, v.count), zmath__red_min_k(v.z, v.count) },
+        { zmath__red_max_k(v.x, v.count), zmath__red_max_k(v.y, v.count), zmath__red_max_k(v.z, v.count) }
+    };
+    ZMATH__PROF_END(V3_SOA_BOUNDS);
+    return b;
+}
+
+// Interpolation batches.
+
+static inline ZMATH_CONSTEXPR void zmath__lerp_k(const float* a, const float* b, float t, float* out, size_t n)
+{
+    float s = 1.0f - t;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = s * a[i] + t * b[i];
+    }
+}
+
+ZMATHDEF void zmath_lerp_array(const float* a, const float* b, float t, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(LERP_ARRAY, n);
+    zmath__lerp_k(a, b, t, out, n);
+    ZMATH__PROF_END(LERP_ARRAY);
+}
+
+ZMATHDEF void zmath_inv_lerp_array(float a, float b, const float* in, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(INV_LERP_ARRAY, n);
+    float r = 1.0f / (b - a);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = (in[i] - a) * r;
+    }
+    ZMATH__PROF_END(INV_LERP_ARRAY);
+}
+
+// Keeps the scalar lerp form, so iMin and iMax map exactly onto oMin and
+// oMax.
+ZMATHDEF void zmath_remap_array(float iMin, float iMax, float oMin, float oMax, const float* in, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(REMAP_ARRAY, n);
+    float r = 1.0f / (iMax - iMin);
+    for (size_t i = 0; i < n; i++)
+    {
+        float t = (in[i] - iMin) * r;
+        out[i] = (1.0f - t) * oMin + t * oMax;
+    }
+    ZMATH__PROF_END(REMAP_ARRAY);
+}
+
+ZMATHDEF void zmath_clamp_array(float min_val, float max_val, const float* in, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(CLAMP_ARRAY, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        float x = (in[i] < min_val) ? min_val : in[i];
+        out[i] = (x > max_val) ? max_val : x;
+    }
+    ZMATH__PROF_END(CLAMP_ARRAY);
+}
+
+ZMATHDEF void zmath_smoothstep_array(float edge0, float edge1, const float* in, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(SMOOTHSTEP_ARRAY, n);
+    float r = 1.0f / (edge1 - edge0);
+    for (size_t i = 0; i < n; i++)
+    {
+        float t = (in[i] - edge0) * r;
+        t = (t < 0.0f) ? 0.0f : t;
+        t = (t > 1.0f) ? 1.0f : t;
+        out[i] = t * t * (3.0f - 2.0f * t);
+    }
+    ZMATH__PROF_END(SMOOTHSTEP_ARRAY);
+}
+
+ZMATHDEF void zmath_smootherstep_array(float edge0, float edge1, const float* in, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(SMOOTHERSTEP_ARRAY, n);
+    float r = 1.0f / (edge1 - edge0);
+    for (size_t i = 0; i < n; i++)
+    {
+        float t = (in[i] - edge0) * r;
+        t = (t < 0.0f) ? 0.0f : t;
+        t = (t > 1.0f) ? 1.0f : t;
+        out[i] = t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+    ZMATH__PROF_END(SMOOTHERSTEP_ARRAY);
+}
+
+// Vector lerps read each element whole before writing it, so `out` may
+// alias `a` or `b`.
+ZMATHDEF void zmath_v2_lerp_array(const zvec2* a, const zvec2* b, float t, zvec2* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(V2_LERP_ARRAY, n);
+    float s = 1.0f - t;
+    for (size_t i = 0; i < n; i++)
+    {
+        zvec2 p = a[i], q = b[i];
+        zvec2 r = { s * p.x + t * q.x, s * p.y + t * q.y };
+        out[i] = r;
+    }
+    ZMATH__PROF_END(V2_LERP_ARRAY);
+}
+
+ZMATHDEF void zmath_v3_lerp_array(const zvec3* a, const zvec3* b, float t, zvec3* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(V3_LERP_ARRAY, n);
+    float s = 1.0f - t;
+    for (size_t i = 0; i < n; i++)
+    {
+        zvec3 p = a[i], q = b[i];
+        zvec3 r = { s * p.x + t * q.x, s * p.y + t * q.y, s * p.z + t * q.z };
+        out[i] = r;
+    }
+    ZMATH__PROF_END(V3_LERP_ARRAY);
+}
+
+// Vector streams (SoA).
+// add/sub/scale run one pass per component. Each loop touches two or three
+// arrays, so the runtime alias checks stay cheap and the loops vectorize
+// even when `out` aliases an input.
+
+static inline ZMATH_CONSTEXPR void zmath__soa_add(const float* a, const float* b, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = a[i] + b[i];
+    }
+}
+
+static inline ZMATH_CONSTEXPR void zmath__soa_sub(const float* a, const float* b, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = a[i] - b[i];
+    }
+}
+
+static inline ZMATH_CONSTEXPR void zmath__soa_mul(const float* a, const float* b, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = a[i] * b[i];
+    }
+}
+
+static inline ZMATH_CONSTEXPR void zmath__soa_scale(const float* a, float s, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = a[i] * s;
+    }
+}
+
+ZMATHDEF void zmath_v3_soa_add(zvec3_soa a, zvec3_soa b, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_ADD, a.count);
+    zmath__soa_add(a.x, b.x, out.x, a.count);
+    zmath__soa_add(a.y, b.y, out.y, a.count);
+    zmath__soa_add(a.z, b.z, out.z, a.count);
+    ZMATH__PROF_END(V3_SOA_ADD);
+}
+
+ZMATHDEF void zmath_v3_soa_sub(zvec3_soa a, zvec3_soa b, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_SUB, a.count);
+    zmath__soa_sub(a.x, b.x, out.x, a.count);
+    zmath__soa_sub(a.y, b.y, out.y, a.count);
+    zmath__soa_sub(a.z, b.z, out.z, a.count);
+    ZMATH__PROF_END(V3_SOA_SUB);
+}
+
+ZMATHDEF void zmath_v3_soa_scale(zvec3_soa v, float s, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_SCALE, v.count);
+    zmath__soa_scale(v.x, s, out.x, v.count);
+    zmath__soa_scale(v.y, s, out.y, v.count);
+    zmath__soa_scale(v.z, s, out.z, v.count);
+    ZMATH__PROF_END(V3_SOA_SCALE);
+}
+
+ZMATHDEF void zmath_v3_soa_lerp(zvec3_soa a, zvec3_soa b, float t, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_LERP, a.count);
+    zmath__lerp_k(a.x, b.x, t, out.x, a.count);
+    zmath__lerp_k(a.y, b.y, t, out.y, a.count);
+    zmath__lerp_k(a.z, b.z, t, out.z, a.count);
+    ZMATH__PROF_END(V3_SOA_LERP);
+}
+
+ZMATHDEF void zmath_v3_soa_dot(zvec3_soa a, zvec3_soa b, float* out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_DOT, a.count);
+    for (size_t i = 0; i < a.count; i++)
+    {
+        out[i] = a.x[i]*b.x[i] + a.y[i]*b.y[i] + a.z[i]*b.z[i];
+    }
+    ZMATH__PROF_END(V3_SOA_DOT);
+}
+
+// cross and norm stage each block through the stack, so `out` may alias an
+// input and the compute loops still see only read-only input streams.
+#define ZMATH__SOA_BLOCK 64
+
+ZMATHDEF void zmath_v3_soa_cross(zvec3_soa a, zvec3_soa b, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_CROSS, a.count);
+    float tx[ZMATH__SOA_BLOCK], ty[ZMATH__SOA_BLOCK], tz[ZMATH__SOA_BLOCK];
+    for (size_t base = 0; base < a.count; base += ZMATH__SOA_BLOCK)
+    {
+        size_t m = a.count - base;
+        m = (m < ZMATH__SOA_BLOCK) ? m : ZMATH__SOA_BLOCK;
+        const float* ax = a.x + base;
+        const float* ay = a.y + base;
+        const float* az = a.z + base;
+        const float* bx = b.x + base;
+        const float* by = b.y + base;
+        const float* bz = b.z + base;
+        for (size_t i = 0; i < m; i++)
+        {
+            tx[i] = ay[i]*bz[i] - az[i]*by[i];
+            ty[i] = az[i]*bx[i] - ax[i]*bz[i];
+            tz[i] = ax[i]*by[i] - ay[i]*bx[i];
+        }
+        memcpy(out.x + base, tx, m * sizeof(float));
+        memcpy(out.y + base, ty, m * sizeof(float));
+        memcpy(out.z + base, tz, m * sizeof(float));
+    }
+    ZMATH__PROF_END(V3_SOA_CROSS);
+}
+
+ZMATHDEF void zmath_v3_soa_len(zvec3_soa v, float* out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_LEN, v.count);
+    for (size_t i = 0; i < v.count; i++)
+    {
+        out[i] = zmath__sqrt_k(v.x[i]*v.x[i] + v.y[i]*v.y[i] + v.z[i]*v.z[i]);
+    }
+    ZMATH__PROF_END(V3_SOA_LEN);
+}
+
+ZMATHDEF void zmath_v3_soa_norm(zvec3_soa v, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_NORM, v.count);
+    float inv[ZMATH__SOA_BLOCK];
+    for (size_t base = 0; base < v.count; base += ZMATH__SOA_BLOCK)
+    {
+        size_t m = v.count - base;
+        m = (m < ZMATH__SOA_BLOCK) ? m : ZMATH__SOA_BLOCK;
+        const float* x = v.x + base;
+        const float* y = v.y + base;
+        const float* z = v.z + base;
+        for (size_t i = 0; i < m; i++)
+        {
+            // Same rule as zmath_v3_norm: near-zero vectors pass through.
+            float d = x[i]*x[i] + y[i]*y[i] + z[i]*z[i];
+            inv[i] = zmath__select_k(d > ZMATH_EPSILON * ZMATH_EPSILON, zmath__rsqrt_norm_k(d), 1.0f);
+        }
+        zmath__soa_mul(x, inv, out.x + base, m);
+        zmath__soa_mul(y, inv, out.y + base, m);
+        zmath__soa_mul(z, inv, out.z + base, m);
+    }
+    ZMATH__PROF_END(V3_SOA_NORM);
+}
+
+// The transposes never alias (AoS vs SoA storage), so the helpers take
+// restrict pointers. With ZMATH_SIMD they move four vectors per step with
+// 3x4 shuffles (vld3/vst3 on NEON).
+static inline ZMATH_CONSTEXPR void zmath__aos_to_soa(const zvec3* ZMATH_RESTRICT in, float* ZMATH_RESTRICT x,
+                                     float* ZMATH_RESTRICT y, float* ZMATH_RESTRICT z, size_t n)
+{
+    size_t i = 0;
+#ifdef ZMATH_SIMD
+    for (; ZMATH__RUNTIME && i + 4 <= n; i += 4)
+    {
+        zvec4f vx, vy, vz;
+        zmath__v4f_load3(&in[i].x, &vx, &vy, &vz);
+        zmath_v4f_store(x + i, vx);
+        zmath_v4f_store(y + i, vy);
+        zmath_v4f_store(z + i, vz);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        x[i] = in[i].x;
+        y[i] = in[i].y;
+        z[i] = in[i].z;
+    }
+}
+
+static inline ZMATH_CONSTEXPR void zmath__soa_to_aos(const float* ZMATH_RESTRICT x, const float* ZMATH_RESTRICT y,
+                                     const float* ZMATH_RESTRICT z, zvec3* ZMATH_RESTRICT out, size_t n)
+{
+    size_t i = 0;
+#ifdef ZMATH_SIMD
+    for (; ZMATH__RUNTIME && i + 4 <= n; i += 4)
+    {
+        zmath__v4f_store3(&out[i].x, zmath_v4f_load(x + i), zmath_v4f_load(y + i), zmath_v4f_load(z + i));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out[i].x = x[i];
+        out[i].y = y[i];
+        out[i].z = z[i];
+    }
+}
+
+ZMATHDEF void zmath_v3_aos_to_soa(const zvec3* in, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(V3_AOS_TO_SOA, out.count);
+    zmath__aos_to_soa(in, out.x, out.y, out.z, out.count);
+    ZMATH__PROF_END(V3_AOS_TO_SOA);
+}
+
+ZMATHDEF void zmath_v3_soa_to_aos(zvec3_soa in, zvec3* out)
+{
+    ZMATH__PROF_BEGIN(V3_SOA_TO_AOS, in.count);
+    zmath__soa_to_aos(in.x, in.y, in.z, out, in.count);
+    ZMATH__PROF_END(V3_SOA_TO_AOS);
+}
+
+// Matrices.
+
+ZMATHDEF zmat3 zmath_m3_identity(void)
+{
+    zmat3 r = {{ 1.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f,  0.0f, 0.0f, 1.0f }};
+    return r;
+}
+
+ZMATHDEF zmat3 zmath_m3_mul(zmat3 a, zmat3 b)
+{
+    zmat3 r;
+    for (int c = 0; c < 3; c++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            r.m[c*3 + i] = a.m[i]*b.m[c*3] + a.m[3 + i]*b.m[c*3 + 1] + a.m[6 + i]*b.m[c*3 + 2];
+        }
+    }
+    return r;
+}
+
+ZMATHDEF zmat3 zmath_m3_transpose(zmat3 m)
+{
+    zmat3 r;
+    for (int c = 0; c < 3; c++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            r.m[c*3 + i] = m.m[i*3 + c];
+        }
+    }
+    return r;
+}
+
+// Rows of the inverse of a matrix with columns (a, b, c) are the cross
+// products b x c, c x a and a x b over det = a . (b x c).
+static inline ZMATH_CONSTEXPR void zmath__m3_inverse_cols(zvec3 a, zvec3 b, zvec3 c, zvec3* r0, zvec3* r1, zvec3* r2)
+{
+    zvec3 bc = zmath_v3_cross(b, c);
+    float det = zmath_v3_dot(a, bc);
+    float inv_det = zmath__select_k(det != 0.0f, 1.0f / det, 0.0f);
+    *r0 = zmath_v3_scale(bc, inv_det);
+    *r1 = zmath_v3_scale(zmath_v3_cross(c, a), inv_det);
+    *r2 = zmath_v3_scale(zmath_v3_cross(a, b), inv_det);
+}
+
+ZMATHDEF zmat3 zmath_m3_inverse(zmat3 m)
+{
+    zvec3 a = { m.m[0], m.m[1], m.m[2] };
+    zvec3 b = { m.m[3], m.m[4], m.m[5] };
+    zvec3 c = { m.m[6], m.m[7], m.m[8] };
+    zvec3 r0, r1, r2;
+    zmath__m3_inverse_cols(a, b, c, &r0, &r1, &r2);
+    zmat3 r = {{ r0.x, r1.x, r2.x,  r0.y, r1.y, r2.y,  r0.z, r1.z, r2.z }};
+    return r;
+}
+
+ZMATHDEF zvec3 zmath_m3_mul_v3(zmat3 m, zvec3 v)
+{
+    zvec3 r = { m.m[0]*v.x + m.m[3]*v.y + m.m[6]*v.z,
+                m.m[1]*v.x + m.m[4]*v.y + m.m[7]*v.z,
+                m.m[2]*v.x + m.m[5]*v.y + m.m[8]*v.z };
+    return r;
+}
+
+ZMATHDEF zmat3 zmath_m3_from_m4(zmat4 m)
+{
+    zmat3 r = {{ m.m[0], m.m[1], m.m[2],  m.m[4], m.m[5], m.m[6],  m.m[8], m.m[9], m.m[10] }};
+    return r;
+}
+
+ZMATHDEF zmat4 zmath_m4_identity(void)
+{
+    zmat4 r = {{ 1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,
+                 0.0f, 0.0f, 1.0f, 0.0f,  0.0f, 0.0f, 0.0f, 1.0f }};
+    return r;
+}
+
+ZMATHDEF zmat4 zmath_m4_translation(zvec3 t)
+{
+    zmat4 r = zmath_m4_identity();
+    r.m[12] = t.x;
+    r.m[13] = t.y;
+    r.m[14] = t.z;
+    return r;
+}
+
+ZMATHDEF zmat4 zmath_m4_scaling(zvec3 s)
+{
+    zmat4 r = zmath_m4_identity();
+    r.m[0] = s.x;
+    r.m[5] = s.y;
+    r.m[10] = s.z;
+    return r;
+}
+
+// Column c of a * b is a's columns weighted by column c of b. The lane path
+// keeps the scalar summation order, so both agree bit for bit unless the
+// backend fuses the multiply-adds.
+ZMATHDEF zmat4 zmath_m4_mul(zmat4 a, zmat4 b)
+{
+    zmat4 r;
+#ifdef ZMATH_SIMD
+    if (ZMATH__RUNTIME)
+    {
+        zvec4f a0 = zmath_v4f_load(a.m);
+        zvec4f a1 = zmath_v4f_load(a.m + 4);
+        zvec4f a2 = zmath_v4f_load(a.m + 8);
+        zvec4f a3 = zmath_v4f_load(a.m + 12);
+        for (int c = 0; c < 4; c++)
+        {
+            const float* bc = b.m + c*4;
+            zvec4f v = zmath_v4f_mul(a0, zmath_v4f_set1(bc[0]));
+            v = zmath_v4f_madd(a1, zmath_v4f_set1(bc[1]), v);
+            v = zmath_v4f_madd(a2, zmath_v4f_set1(bc[2]), v);
+            v = zmath_v4f_madd(a3, zmath_v4f_set1(bc[3]), v);
+            zmath_v4f_store(r.m + c*4, v);
+        }
+        return r;
+    }
+#endif
+    for (int c = 0; c < 4; c++)
+    {
+        const float* bc = b.m + c*4;
+        for (int i = 0; i < 4; i++)
+        {
+            r.m[c*4 + i] = a.m[i]*bc[0] + a.m[4 + i]*bc[1] + a.m[8 + i]*bc[2] + a.m[12 + i]*bc[3];
+        }
+    }
+    return r;
+}
+
+ZMATHDEF zmat4 zmath_m4_transpose(zmat4 m)
+{
+    zmat4 r;
+    for (int c = 0; c < 4; c++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            r.m[c*4 + i] = m.m[i*4 + c];
+        }
+    }
+    return r;
+}
+
+// Laplace expansion over 2x2 minors: s* from the first two columns, c* from
+// the last two. inverse(transpose(m)) = transpose(inverse(m)), so the same
+// index pattern works whichever way the array is read.
+ZMATHDEF zmat4 zmath_m4_inverse(zmat4 m)
+{
+    const float* a = m.m;
+    float s0 = a[0]*a[5] - a[4]*a[1];
+    float s1 = a[0]*a[6] - a[4]*a[2];
+    float s2 = a[0]*a[7] - a[4]*a[3];
+    float s3 = a[1]*a[6] - a[5]*a[2];
+    float s4 = a[1]*a[7] - a[5]*a[3];
+    float s5 = a[2]*a[7] - a[6]*a[3];
+    float c0 = a[8]*a[13] - a[12]*a[9];
+    float c1 = a[8]*a[14] - a[12]*a[10];
+    float c2 = a[8]*a[15] - a[12]*a[11];
+    float c3 = a[9]*a[14] - a[13]*a[10];
+    float c4 = a[9]*a[15] - a[13]*a[11];
+    float c5 = a[10]*a[15] - a[14]*a[11];
+
+    float det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+    float k = zmath__select_k(det != 0.0f, 1.0f / det, 0.0f);
+
+    zmat4 r;
+    r.m[0]  = ( a[5]*c5 - a[6]*c4 + a[7]*c3) * k;
+    r.m[1]  = (-a[1]*c5 + a[2]*c4 - a[3]*c3) * k;
+    r.m[2]  = ( a[13]*s5 - a[14]*s4 + a[15]*s3) * k;
+    r.m[3]  = (-a[9]*s5 + a[10]*s4 - a[11]*s3) * k;
+    r.m[4]  = (-a[4]*c5 + a[6]*c2 - a[7]*c1) * k;
+    r.m[5]  = ( a[0]*c5 - a[2]*c2 + a[3]*c1) * k;
+    r.m[6]  = (-a[12]*s5 + a[14]*s2 - a[15]*s1) * k;
+    r.m[7]  = ( a[8]*s5 - a[10]*s2 + a[11]*s1) * k;
+    r.m[8]  = ( a[4]*c4 - a[5]*c2 + a[7]*c0) * k;
+    r.m[9]  = (-a[0]*c4 + a[1]*c2 - a[3]*c0) * k;
+    r.m[10] = ( a[12]*s4 - a[13]*s2 + a[15]*s0) * k;
+    r.m[11] = (-a[8]*s4 + a[9]*s2 - a[11]*s0) * k;
+    r.m[12] = (-a[4]*c3 + a[5]*c1 - a[6]*c0) * k;
+    r.m[13] = ( a[0]*c3 - a[1]*c1 + a[2]*c0) * k;
+    r.m[14] = (-a[12]*s3 + a[13]*s1 - a[14]*s0) * k;
+    r.m[15] = ( a[8]*s3 - a[9]*s1 + a[10]*s0) * k;
+    return r;
+}
+
+// [L t; 0 1]^-1 = [L^-1  -L^-1 t; 0 1], with L^-1 from three cross products.
+ZMATHDEF zmat4 zmath_m4_inverse_affine(zmat4 m)
+{
+    zvec3 a = { m.m[0], m.m[1], m.m[2] };
+    zvec3 b = { m.m[4], m.m[5], m.m[6] };
+    zvec3 c = { m.m[8], m.m[9], m.m[10] };
+    zvec3 t = { m.m[12], m.m[13], m.m[14] };
+    zvec3 r0, r1, r2;
+    zmath__m3_inverse_cols(a, b, c, &r0, &r1, &r2);
+    zmat4 r = {{ r0.x, r1.x, r2.x, 0.0f,  r0.y, r1.y, r2.y, 0.0f,
+                 r0.z, r1.z, r2.z, 0.0f,
+                 -zmath_v3_dot(r0, t), -zmath_v3_dot(r1, t), -zmath_v3_dot(r2, t), 1.0f }};
+    return r;
+}
+
+static inline ZMATH_CONSTEXPR zvec3 zmath__m4_point_k(const zmat4* m, zvec3 p)
+{
+    const float* a = m->m;
+    zvec3 r = { a[0]*p.x + a[4]*p.y + a[8]*p.z + a[12],
+                a[1]*p.x + a[5]*p.y + a[9]*p.z + a[13],
+                a[2]*p.x + a[6]*p.y + a[10]*p.z + a[14] };
+    return r;
+}
+
+static inline ZMATH_CONSTEXPR zvec3 zmath__m4_dir_k(const zmat4* m, zvec3 v)
+{
+    const float* a = m->m;
+    zvec3 r = { a[0]*v.x + a[4]*v.y + a[8]*v.z,
+                a[1]*v.x + a[5]*v.y + a[9]*v.z,
+                a[2]*v.x + a[6]*v.y + a[10]*v.z };
+    return r;
+}
+
+ZMATHDEF zvec3 zmath_m4_transform_point(zmat4 m, zvec3 p)
+{
+    return zmath__m4_point_k(&m, p);
+}
+
+ZMATHDEF zvec3 zmath_m4_transform_dir(zmat4 m, zvec3 v)
+{
+    return zmath__m4_dir_k(&m, v);
+}
+
+// With ZMATH_SIMD, blocks of four AoS vectors are transposed into x/y/z
+// lanes (the same 3x4 shuffles as zmath_v3_aos_to_soa), transformed against
+// broadcast matrix entries in the scalar summation order, and transposed
+// back. Directions skip the translation add rather than adding 0 * t, so
+// -0 and a non-finite translation come out as in the scalar kernels.
+#ifdef ZMATH_SIMD
+static inline void zmath__m4_transform_v4f(const zmat4* m, const zvec3* in, zvec3* out, bool point)
+{
+    const float* a = m->m;
+    zvec4f x, y, z;
+    zmath__v4f_load3(&in->x, &x, &y, &z);
+    zvec4f o[3];
+    for (int i = 0; i < 3; i++)
+    {
+        zvec4f v = zmath_v4f_mul(zmath_v4f_set1(a[i]), x);
+        v = zmath_v4f_madd(zmath_v4f_set1(a[4 + i]), y, v);
+        v = zmath_v4f_madd(zmath_v4f_set1(a[8 + i]), z, v);
+        o[i] = point ? zmath_v4f_add(v, zmath_v4f_set1(a[12 + i])) : v;
+    }
+    zmath__v4f_store3(&out->x, o[0], o[1], o[2]);
+}
+#endif
+
+ZMATHDEF void zmath_m4_transform_points(const zmat4* m, const zvec3* in, zvec3* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(M4_TRANSFORM_POINTS, n);
+    size_t i = 0;
+#ifdef ZMATH_SIMD
+    for (; ZMATH__RUNTIME && i + 4 <= n; i += 4)
+    {
+        zmath__m4_transform_v4f(m, in + i, out + i, true);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out[i] = zmath__m4_point_k(m, in[i]);
+    }
+    ZMATH__PROF_END(M4_TRANSFORM_POINTS);
+}
+
+ZMATHDEF void zmath_m4_transform_dirs(const zmat4* m, const zvec3* in, zvec3* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(M4_TRANSFORM_DIRS, n);
+    size_t i = 0;
+#ifdef ZMATH_SIMD
+    for (; ZMATH__RUNTIME && i + 4 <= n; i += 4)
+    {
+        zmath__m4_transform_v4f(m, in + i, out + i, false);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out[i] = zmath__m4_dir_k(m, in[i]);
+    }
+    ZMATH__PROF_END(M4_TRANSFORM_DIRS);
+}
+
+// Streams need no transpose: the loop is three broadcast dot products per
+// element and vectorizes as it stands.
+ZMATHDEF void zmath_m4_transform_points_soa(const zmat4* m, zvec3_soa in, zvec3_soa out)
+{
+    ZMATH__PROF_BEGIN(M4_TRANSFORM_POINTS_SOA, in.count);
+    const float* a = m->m;
+    for (size_t i = 0; i < in.count; i++)
+    {
+        float x = in.x[i];
+        float y = in.y[i];
+        float z = in.z[i];
+        out.x[i] = a[0]*x + a[4]*y + a[8]*z + a[12];
+        out.y[i] = a[1]*x + a[5]*y + a[9]*z + a[13];
+        out.z[i] = a[2]*x + a[6]*y + a[10]*z + a[14];
+    }
+    ZMATH__PROF_END(M4_TRANSFORM_POINTS_SOA);
+}
+
+// Quaternions.
+
+static inline ZMATH_CONSTEXPR float zmath__q_dot_k(zquat a, zquat b)
+{
+    return a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w;
+}
+
+// One refined invsqrt multiply, like the vector norms: |q| ends within 5e-6
+// of 1. A zero quaternion stays zero.
+static inline ZMATH_CONSTEXPR zquat zmath__q_norm_k(zquat q)
+{
+    float d = zmath__q_dot_k(q, q);
+    float k = zmath__rsqrt_norm_k(d);
+    zquat r = { q.x * k, q.y * k, q.z * k, q.w * k };
+    return r;
+}
+
+// b is negated when it lies on the far hemisphere, then the blend is
+// renormalized. `d` is dot(a, b), which the caller has already computed.
+static inline ZMATH_CONSTEXPR zquat zmath__q_blend_k(zquat a, zquat b, float d, float t)
+{
+    float s = zmath__select_k(d < 0.0f, -t, t);
+    float u = 1.0f - t;
+    zquat r = { u*a.x + s*b.x, u*a.y + s*b.y, u*a.z + s*b.z, u*a.w + s*b.w };
+    return zmath__q_norm_k(r);
+}
+
+static inline ZMATH_CONSTEXPR zquat zmath__q_nlerp_k(zquat a, zquat b, float t)
+{
+    return zmath__q_blend_k(a, b, zmath__q_dot_k(a, b), t);
+}
+
+// nlerp sweeps the arc with a speed that bulges in the middle. Remapping t
+// by t + t(t - 1/2)(t - 1)k, with k a polynomial in |dot(a, b)| fitted to
+// slerp, cancels most of it (Kapoulkine, "Approximating slerp", 2015).
+static inline ZMATH_CONSTEXPR zquat zmath__q_slerp_k(zquat a, zquat b, float t)
+{
+    float d = zmath__q_dot_k(a, b);
+    float ad = zmath__abs_k(d);
+    float ka = 1.0904f + ad * (-3.2452f + ad * (3.55645f - ad * 1.43519f));
+    float kb = 0.848013f + ad * (-1.06021f + ad * 0.215638f);
+    float c = t - 0.5f;
+    float k = ka * c * c + kb;
+    float ot = t + t * c * (t - 1.0f) * k;
+    return zmath__q_blend_k(a, b, d, ot);
+}
+
+ZMATHDEF zquat zmath_q_identity(void)
+{
+    zquat r = { 0.0f, 0.0f, 0.0f, 1.0f };
+    return r;
+}
+
+// `axis` must be unit length.
+ZMATHDEF zquat zmath_q_from_axis_angle(zvec3 axis, float angle)
+{
+    float s, c;
+    ZMATH__SINCOS_K(0.5f * angle, &s, &c);
+    zquat r = { axis.x * s, axis.y * s, axis.z * s, c };
+    return r;
+}
+
+ZMATHDEF zquat zmath_q_mul(zquat a, zquat b)
+{
+    zquat r = { a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y,
+                a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x,
+                a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w,
+                a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z };
+    return r;
+}
+
+ZMATHDEF zquat zmath_q_conj(zquat q)
+{
+    zquat r = { -q.x, -q.y, -q.z, q.w };
+    return r;
+}
+
+ZMATHDEF float zmath_q_dot(zquat a, zquat b)
+{
+    return zmath__q_dot_k(a, b);
+}
+
+ZMATHDEF zquat zmath_q_norm(zquat q)
+{
+    return zmath__q_norm_k(q);
+}
+
+// v' = v + w t + u x t with t = 2 (u x v): two cross products and no
+// quaternion products, instead of expanding q * v * conj(q).
+ZMATHDEF zvec3 zmath_q_rotate(zquat q, zvec3 v)
+{
+    zvec3 u = { q.x, q.y, q.z };
+    zvec3 t = zmath_v3_cross(u, v);
+    t = zmath_v3_add(t, t);
+    zvec3 r = zmath_v3_add(v, zmath_v3_add(zmath_v3_scale(t, q.w), zmath_v3_cross(u, t)));
+    return r;
+}
+
+ZMATHDEF zquat zmath_q_nlerp(zquat a, zquat b, float t)
+{
+    return zmath__q_nlerp_k(a, b, t);
+}
+
+ZMATHDEF zquat zmath_q_slerp(zquat a, zquat b, float t)
+{
+    return zmath__q_slerp_k(a, b, t);
+}
+
+ZMATHDEF zmat4 zmath_q_to_m4(zquat q)
+{
+    float x2 = q.x + q.x, y2 = q.y + q.y, z2 = q.z + q.z;
+    float xx = q.x * x2, yy = q.y * y2, zz = q.z * z2;
+    float xy = q.x * y2, xz = q.x * z2, yz = q.y * z2;
+    float wx = q.w * x2, wy = q.w * y2, wz = q.w * z2;
+    zmat4 r = {{ 1.0f - (yy + zz), xy + wz, xz - wy, 0.0f,
+                 xy - wz, 1.0f - (xx + zz), yz + wx, 0.0f,
+                 xz + wy, yz - wx, 1.0f - (xx + yy), 0.0f,
+                 0.0f, 0.0f, 0.0f, 1.0f }};
+    return r;
+}
+
+// Pose blending. Every kernel above is branch-free, so these loops
+// vectorize across joints.
+
+ZMATHDEF void zmath_q_nlerp_array(const zquat* a, const zquat* b, float t, zquat* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(Q_NLERP_ARRAY, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = zmath__q_nlerp_k(a[i], b[i], t);
+    }
+    ZMATH__PROF_END(Q_NLERP_ARRAY);
+}
+
+ZMATHDEF void zmath_q_slerp_array(const zquat* a, const zquat* b, float t, zquat* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(Q_SLERP_ARRAY, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = zmath__q_slerp_k(a[i], b[i], t);
+    }
+    ZMATH__PROF_END(Q_SLERP_ARRAY);
+}
+
+// One streaming pass per pose accumulates into `out`, then a last pass
+// normalizes.
+ZMATHDEF void zmath_q_blend_poses(const zquat* const* poses, const float* weights, size_t count,
+                                  zquat* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(Q_BLEND_POSES, n);
+    if (count == 0)
+    {
+        ZMATH__PROF_END(Q_BLEND_POSES);
+        return;
+    }
+    float w0 = weights[0];
+    for (size_t i = 0; i < n; i++)
+    {
+        zquat p = poses[0][i];
+        zquat r = { p.x * w0, p.y * w0, p.z * w0, p.w * w0 };
+        out[i] = r;
+    }
+    for (size_t k = 1; k < count; k++)
+    {
+        const zquat* pose = poses[k];
+        float w = weights[k];
+        for (size_t i = 0; i < n; i++)
+        {
+            zquat acc = out[i];
+            zquat p = pose[i];
+            float s = zmath__select_k(zmath__q_dot_k(acc, p) < 0.0f, -w, w);
+            zquat r = { acc.x + s*p.x, acc.y + s*p.y, acc.z + s*p.z, acc.w + s*p.w };
+            out[i] = r;
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = zmath__q_norm_k(out[i]);
+    }
+    ZMATH__PROF_END(Q_BLEND_POSES);
+}
+
+// Geometry.
+// The tests combine their conditions with & instead of && and pick with
+// selects, so the batch loops carry no branches and vectorize.
+
+static inline ZMATH_CONSTEXPR float zmath__min_k(float a, float b)
+{
+    return zmath__select_k(a < b, a, b);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__max_k(float a, float b)
+{
+    return zmath__select_k(a > b, a, b);
+}
+
+// The most negative plane distance over the frustum, for a box given as
+// centre and half extent (the extent projects onto |n|).
+static inline ZMATH_CONSTEXPR float zmath__frustum_dist_k(const zplane* p, float x, float y, float z,
+                                                        float ex, float ey, float ez)
+{
+    float d = p[0].n.x * x + p[0].n.y * y + p[0].n.z * z + p[0].d
+            + zmath__abs_k(p[0].n.x) * ex + zmath__abs_k(p[0].n.y) * ey + zmath__abs_k(p[0].n.z) * ez;
+    for (int i = 1; i < 6; i++)
+    {
+        float di = p[i].n.x * x + p[i].n.y * y + p[i].n.z * z + p[i].d
+                 + zmath__abs_k(p[i].n.x) * ex + zmath__abs_k(p[i].n.y) * ey + zmath__abs_k(p[i].n.z) * ez;
+        d = zmath__min_k(d, di);
+    }
+    return d;
+}
+
+static inline ZMATH_CONSTEXPR bool zmath__frustum_sphere_k(const zplane* p, float x, float y, float z, float r)
+{
+    return zmath__frustum_dist_k(p, x, y, z, 0.0f, 0.0f, 0.0f) >= -r;
+}
+
+// Slab test against 1 / dir. Where a direction component is 0, that slab
+// gives -Inf..Inf inside it and an empty interval outside; a ray lying
+// exactly in a slab's face plane can go either way.
+static inline ZMATH_CONSTEXPR bool zmath__ray_aabb_k(zvec3 o, zvec3 inv, float t_max,
+                                                   float x0, float y0, float z0, float x1, float y1, float z1,
+                                                   float* t)
+{
+    float ax = (x0 - o.x) * inv.x, bx = (x1 - o.x) * inv.x;
+    float ay = (y0 - o.y) * inv.y, by = (y1 - o.y) * inv.y;
+    float az = (z0 - o.z) * inv.z, bz = (z1 - o.z) * inv.z;
+    float enter = zmath__max_k(zmath__max_k(zmath__min_k(ax, bx), zmath__min_k(ay, by)),
+                              zmath__max_k(zmath__min_k(az, bz), 0.0f));
+    float leave = zmath__min_k(zmath__min_k(zmath__max_k(ax, bx), zmath__max_k(ay, by)),
+                             zmath__min_k(zmath__max_k(az, bz), t_max));
+    *t = enter;
+    return enter <= leave;
+}
+
+static inline ZMATH_CONSTEXPR zvec3 zmath__ray_inv_k(zvec3 d)
+{
+    zvec3 inv = { 1.0f / d.x, 1.0f / d.y, 1.0f / d.z };
+    return inv;
+}
+
+// Packs 0/1 flags, one per object, into a mask word.
+static inline ZMATH_CONSTEXPR uint32_t zmath__mask_pack_k(const uint32_t* hit, size_t m)
+{
+    uint32_t bits = 0;
+    for (size_t k = 0; k < m; k++)
+    {
+        bits |= hit[k] << k;
+    }
+    return bits;
+}
+
+ZMATHDEF zplane zmath_plane_from_point_normal(zvec3 p, zvec3 n)
+{
+    zvec3 u = zmath_v3_norm(n);
+    zplane pl = { u, -zmath_v3_dot(u, p) };
+    return pl;
+}
+
+ZMATHDEF float zmath_plane_dist(zplane pl, zvec3 p)
+{
+    return zmath_v3_dot(pl.n, p) + pl.d;
+}
+
+ZMATHDEF bool zmath_aabb_contains(zaabb b, zvec3 p)
+{
+    return (p.x >= b.lo.x) & (p.x <= b.hi.x) & (p.y >= b.lo.y) & (p.y <= b.hi.y)
+         & (p.z >= b.lo.z) & (p.z <= b.hi.z);
+}
+
+ZMATHDEF bool zmath_aabb_overlap(zaabb a, zaabb b)
+{
+    return (a.lo.x <= b.hi.x) & (a.hi.x >= b.lo.x) & (a.lo.y <= b.hi.y) & (a.hi.y >= b.lo.y)
+         & (a.lo.z <= b.hi.z) & (a.hi.z >= b.lo.z);
+}
+
+// Squared distance from the centre to its clamp into the box.
+ZMATHDEF bool zmath_sphere_aabb_overlap(zsphere s, zaabb b)
+{
+    float dx = s.center.x - zmath__max_k(b.lo.x, zmath__min_k(s.center.x, b.hi.x));
+    float dy = s.center.y - zmath__max_k(b.lo.y, zmath__min_k(s.center.y, b.hi.y));
+    float dz = s.center.z - zmath__max_k(b.lo.z, zmath__min_k(s.center.z, b.hi.z));
+    return dx * dx + dy * dy + dz * dz <= s.radius * s.radius;
+}
+
+ZMATHDEF bool zmath_ray_aabb(zray r, zaabb b, float* t)
+{
+    float tt = 0.0f;
+    bool hit = zmath__ray_aabb_k(r.origin, zmath__ray_inv_k(r.dir), ZMATH_INFINITY,
+                                 b.lo.x, b.lo.y, b.lo.z, b.hi.x, b.hi.y, b.hi.z, &tt);
+    if (hit && t)
+    {
+        *t = tt;
+    }
+    return hit;
+}
+
+// Nearest root of |o + t d - c|^2 = r^2, clamped to 0 when o is inside.
+ZMATHDEF bool zmath_ray_sphere(zray r, zsphere s, float* t)
+{
+    zvec3 m = zmath_v3_sub(r.origin, s.center);
+    float a = zmath_v3_dot(r.dir, r.dir);
+    float b = zmath_v3_dot(m, r.dir);
+    float c = zmath_v3_dot(m, m) - s.radius * s.radius;
+    float disc = b * b - a * c;
+    bool hit = (disc >= 0.0f) & ((c <= 0.0f) | (b <= 0.0f)) & (a > 0.0f);
+    if (hit && t)
+    {
+        // Same rsqrt as the normalizes, so t does not depend on the tier.
+        float root = (-b - zmath__select_k(disc > 0.0f, disc * zmath__rsqrt_norm_k(disc), 0.0f)) / a;
+        *t = zmath__max_k(root, 0.0f);
+    }
+    return hit;
+}
+
+// Gribb-Hartmann: each plane is the last clip row plus or minus another.
+ZMATHDEF void zmath_frustum_from_m4(zmat4 m, bool zero_to_one, zplane out[6])
+{
+    float row[4][4];
+    for (int r = 0; r < 4; r++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            row[r][c] = m.m[c * 4 + r];
+        }
+    }
+    for (int i = 0; i < 6; i++)
+    {
+        const float* w = row[3];
+        const float* a = row[i / 2];
+        float s = (i & 1) ? -1.0f : 1.0f;
+        if (i == 4 && zero_to_one)
+        {
+            s = 0.0f;
+            w = row[2];
+        }
+        zvec3 n = { w[0] + s * a[0], w[1] + s * a[1], w[2] + s * a[2] };
+        float d = w[3] + s * a[3];
+        float len2 = zmath_v3_dot(n, n);
+        float inv = (len2 > 0.0f) ? zmath__rsqrt_norm_k(len2) : 0.0f;
+        out[i].n = zmath_v3_scale(n, inv);
+        out[i].d = d * inv;
+    }
+}
+
+ZMATHDEF bool zmath_frustum_sphere(const zplane planes[6], zsphere s)
+{
+    return zmath__frustum_sphere_k(planes, s.center.x, s.center.y, s.center.z, s.radius);
+}
+
+ZMATHDEF bool zmath_frustum_aabb(const zplane planes[6], zaabb b)
+{
+    return zmath__frustum_dist_k(planes, 0.5f * (b.lo.x + b.hi.x), 0.5f * (b.lo.y + b.hi.y),
+                                 0.5f * (b.lo.z + b.hi.z), 0.5f * (b.hi.x - b.lo.x),
+                                 0.5f * (b.hi.y - b.lo.y), 0.5f * (b.hi.z - b.lo.z)) >= 0.0f;
+}
+
+// 32 objects per mask word: the flags loop vectorizes, then one pack.
+ZMATHDEF void zmath_frustum_cull_spheres(const zplane planes[6], zvec3_soa centers, const float* radii,
+                                         uint32_t* mask)
+{
+    ZMATH__PROF_BEGIN(FRUSTUM_CULL_SPHERES, centers.count);
+    zplane p[6];
+    for (int i = 0; i < 6; i++)
+    {
+        p[i] = planes[i];
+    }
+    uint32_t hit[32];
+    for (size_t base = 0; base < centers.count; base += 32)
+    {
+        size_t m = centers.count - base;
+        m = (m < 32) ? m : 32;
+        const float* x = centers.x + base;
+        const float* y = centers.y + base;
+        const float* z = centers.z + base;
+        const float* r = radii + base;
+        for (size_t k = 0; k < m; k++)
+        {
+            hit[k] = (uint32_t)zmath__frustum_sphere_k(p, x[k], y[k], z[k], r[k]);
+        }
+        mask[base / 32] = zmath__mask_pack_k(hit, m);
+    }
+    ZMATH__PROF_END(FRUSTUM_CULL_SPHERES);
+}
+
+ZMATHDEF void zmath_frustum_cull_aabbs(const zplane planes[6], zvec3_soa mins, zvec3_soa maxs, uint32_t* mask)
+{
+    ZMATH__PROF_BEGIN(FRUSTUM_CULL_AABBS, mins.count);
+    zplane p[6];
+    for (int i = 0; i < 6; i++)
+    {
+        p[i] = planes[i];
+    }
+    uint32_t hit[32];
+    for (size_t base = 0; base < mins.count; base += 32)
+    {
+        size_t m = mins.count - base;
+        m = (m < 32) ? m : 32;
+        for (size_t k = 0; k < m; k++)
+        {
+            size_t i = base + k;
+            float cx = 0.5f * (mins.x[i] + maxs.x[i]), ex = 0.5f * (maxs.x[i] - mins.x[i]);
+            float cy = 0.5f * (mins.y[i] + maxs.y[i]), ey = 0.5f * (maxs.y[i] - mins.y[i]);
+            float cz = 0.5f * (mins.z[i] + maxs.z[i]), ez = 0.5f * (maxs.z[i] - mins.z[i]);
+            hit[k] = (uint32_t)(zmath__frustum_dist_k(p, cx, cy, cz, ex, ey, ez) >= 0.0f);
+        }
+        mask[base / 32] = zmath__mask_pack_k(hit, m);
+    }
+    ZMATH__PROF_END(FRUSTUM_CULL_AABBS);
+}
+
+ZMATHDEF void zmath_ray_aabb_soa(zray r, float t_max, zvec3_soa mins, zvec3_soa maxs, uint32_t* mask)
+{
+    ZMATH__PROF_BEGIN(RAY_AABB_SOA, mins.count);
+    zvec3 inv = zmath__ray_inv_k(r.dir);
+    uint32_t hit[32];
+    for (size_t base = 0; base < mins.count; base += 32)
+    {
+        size_t m = mins.count - base;
+        m = (m < 32) ? m : 32;
+        for (size_t k = 0; k < m; k++)
+        {
+            size_t i = base + k;
+            float t = 0.0f;
+            hit[k] = (uint32_t)zmath__ray_aabb_k(r.origin, inv, t_max, mins.x[i], mins.y[i], mins.z[i],
+                                                 maxs.x[i], maxs.y[i], maxs.z[i], &t);
+        }
+        mask[base / 32] = zmath__mask_pack_k(hit, m);
+    }
+    ZMATH__PROF_END(RAY_AABB_SOA);
+}
+
+// Every index is written and the cursor only advances past set bits.
+ZMATHDEF size_t zmath_mask_compact(const uint32_t* mask, size_t n, uint32_t* out)
+{
+    ZMATH__PROF_BEGIN(MASK_COMPACT, n);
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[count] = (uint32_t)i;
+        count += (mask[i / 32] >> (i % 32)) & 1u;
+    }
+    ZMATH__PROF_END(MASK_COMPACT);
+    return count;
+}
+
+// Random numbers.
+
+static inline ZMATH_CONSTEXPR uint32_t zmath__rotl_k(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline ZMATH_CONSTEXPR uint32_t zmath__rng_next_k(zrng* r)
+{
+    uint32_t* s = r->s;
+    uint32_t result = zmath__rotl_k(s[0] + s[3], 7) + s[0];
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = zmath__rotl_k(s[3], 11);
+    return result;
+}
+
+// Top 24 bits as a float in [0, 1).
+static inline ZMATH_CONSTEXPR float zmath__rng_unit_k(uint32_t x)
+{
+    return (float)(x >> 8) * 5.9604644775390625e-8f;
+}
+
+static inline ZMATH_CONSTEXPR uint64_t zmath__splitmix64_k(uint64_t* x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Adds the polynomial `poly` (a power of the transition matrix) to the state.
+static inline ZMATH_CONSTEXPR void zmath__rng_jump_k(zrng* r, const uint32_t* poly)
+{
+    uint32_t acc[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 32; b++)
+        {
+            uint32_t mask = 0u - ((poly[i] >> b) & 1u);
+            for (int k = 0; k < 4; k++)
+            {
+                acc[k] ^= r->s[k] & mask;
+            }
+            zmath__rng_next_k(r);
+        }
+    }
+    for (int k = 0; k < 4; k++)
+    {
+        r->s[k] = acc[k];
+    }
+}
+
+ZMATHDEF zrng zmath_rng_seed(uint64_t seed)
+{
+    // splitmix64 is a bijection on its counter, so the state is never zero.
+    zrng r = { { 0, 0, 0, 0 } };
+    uint64_t a = zmath__splitmix64_k(&seed);
+    uint64_t b = zmath__splitmix64_k(&seed);
+    r.s[0] = (uint32_t)a;
+    r.s[1] = (uint32_t)(a >> 32);
+    r.s[2] = (uint32_t)b;
+    r.s[3] = (uint32_t)(b >> 32);
+    return r;
+}
+
+ZMATHDEF void zmath_rng_jump(zrng* r)
+{
+    const uint32_t poly[4] = { 0x8764000Bu, 0xF542D2D3u, 0x6FA035C3u, 0x77F2DB5Bu };
+    zmath__rng_jump_k(r, poly);
+}
+
+ZMATHDEF void zmath_rng_long_jump(zrng* r)
+{
+    const uint32_t poly[4] = { 0xB523952Eu, 0x0B6F099Fu, 0xCCF5A0EFu, 0x1C580662u };
+    zmath__rng_jump_k(r, poly);
+}
+
+ZMATHDEF zrng zmath_rng_split(zrng* r)
+{
+    zrng child = *r;
+    zmath_rng_jump(r);
+    return child;
+}
+
+ZMATHDEF uint32_t zmath_rng_u32(zrng* r)
+{
+    return zmath__rng_next_k(r);
+}
+
+ZMATHDEF float zmath_rng_float(zrng* r)
+{
+    return zmath__rng_unit_k(zmath__rng_next_k(r));
+}
+
+ZMATHDEF float zmath_rng_range(zrng* r, float lo, float hi)
+{
+    return lo + (hi - lo) * zmath__rng_unit_k(zmath__rng_next_k(r));
+}
+
+ZMATHDEF void zmath_rng_fill_uniform(zrng* r, float lo, float hi, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(RNG_FILL_UNIFORM, n);
+    float span = hi - lo;
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = lo + span * zmath__rng_unit_k(zmath__rng_next_k(r));
+    }
+    ZMATH__PROF_END(RNG_FILL_UNIFORM);
+}
+
+// u1 in (0, 1], u2 in [0, 1) -> two independent standard normals.
+static inline ZMATH_CONSTEXPR void zmath__box_muller_k(float u1, float u2, float* a, float* b)
+{
+    float rad = zmath__sqrt_k(-2.0f * ZMATH__LOG_K(u1));
+    float s = 0.0f, c = 0.0f;
+    ZMATH__SINCOS_K(ZMATH_TAU * u2, &s, &c);
+    *a = rad * c;
+    *b = rad * s;
+}
+
+// The generator is serial, so the uniforms go into `out` first and the
+// branch-free transform then runs over them in place, where it vectorizes.
+ZMATHDEF void zmath_rng_fill_normal(zrng* r, float mean, float stddev, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(RNG_FILL_NORMAL, n);
+    size_t pairs = n & ~(size_t)1;
+    for (size_t i = 0; i < pairs; i++)
+    {
+        out[i] = zmath__rng_unit_k(zmath__rng_next_k(r));
+    }
+    for (size_t i = 0; i < pairs; i += 2)
+    {
+        float a = 0.0f, b = 0.0f;
+        zmath__box_muller_k(1.0f - out[i], out[i + 1], &a, &b);
+        out[i] = mean + stddev * a;
+        out[i + 1] = mean + stddev * b;
+    }
+    if (pairs < n)
+    {
+        float u1 = 1.0f - zmath__rng_unit_k(zmath__rng_next_k(r));
+        float u2 = zmath__rng_unit_k(zmath__rng_next_k(r));
+        float a = 0.0f, b = 0.0f;
+        zmath__box_muller_k(u1, u2, &a, &b);
+        out[pairs] = mean + stddev * a;
+    }
+    ZMATH__PROF_END(RNG_FILL_NORMAL);
+}
+
+// Uniform on the sphere: z uniform in (-1, 1], longitude uniform.
+ZMATHDEF void zmath_rng_fill_unit_vec3(zrng* r, zvec3* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(RNG_FILL_UNIT_VEC3, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        float z = 1.0f - 2.0f * zmath__rng_unit_k(zmath__rng_next_k(r));
+        float u = zmath__rng_unit_k(zmath__rng_next_k(r));
+        float rxy = zmath__sqrt_k(1.0f - z * z);
+        float s = 0.0f, c = 0.0f;
+        ZMATH__SINCOS_K(ZMATH_TAU * u, &s, &c);
+        zvec3 v = { rxy * c, rxy * s, z };
+        out[i] = v;
+    }
+    ZMATH__PROF_END(RNG_FILL_UNIT_VEC3);
+}
+
+// Noise.
+// Every kernel is straight-line code: floor_k for the cells, integer hashing
+// for the corners, and selects for the gradients and simplex corners, so the
+// batch loops below vectorize.
+
+// Simplex sums peak near 1/70 (2D) and 1/76 (3D) with these gradients.
+#define ZMATH__NOISE_SIMPLEX2_SCALE 70.0f
+#define ZMATH__NOISE_SIMPLEX3_SCALE 76.0f
+
+// lowbias32 avalanche over the corner coordinates, each spread by an odd
+// constant first so neighbouring cells differ in many bits.
+static inline ZMATH_CONSTEXPR uint32_t zmath__noise_hash_k(uint32_t seed, int32_t ix, int32_t iy, int32_t iz)
+{
+    uint32_t h = seed ^ ((uint32_t)ix * 0x9E3779B1u) ^ ((uint32_t)iy * 0x85EBCA77u) ^ ((uint32_t)iz * 0xC2B2AE3Du);
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+// Hash as a float in [-1, 1).
+static inline ZMATH_CONSTEXPR float zmath__noise_unit_k(uint32_t h)
+{
+    return (float)(int32_t)h * 4.656612873077392578125e-10f;
+}
+
+// Quintic fade, 6t^5 - 15t^4 + 10t^3: zero first and second derivatives at
+// the cell edges.
+static inline ZMATH_CONSTEXPR float zmath__noise_fade_k(float t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+// Flips the sign of x when bit 0 of `bit` is set.
+static inline ZMATH_CONSTEXPR float zmath__noise_flip_k(float x, uint32_t bit)
+{
+    return zmath__uint_as_float(zmath__float_as_uint(x) ^ (bit << 31));
+}
+
+// Eight 2D gradients: the diagonals (h & 4) and the axes.
+static inline ZMATH_CONSTEXPR float zmath__noise_grad2_k(uint32_t h, float x, float y)
+{
+    float u = zmath__noise_flip_k(x, h & 1);
+    float v = zmath__noise_flip_k(y, (h >> 1) & 1);
+    float axis = zmath__select_k((h & 8) != 0, u, v);
+    return zmath__select_k((h & 4) != 0, u + v, axis);
+}
+
+// Perlin's twelve cube-edge gradients, four of them repeated to fill 16.
+static inline ZMATH_CONSTEXPR float zmath__noise_grad3_k(uint32_t h, float x, float y, float z)
+{
+    uint32_t g = h & 15;
+    float u = zmath__select_k(g < 8, x, y);
+    float w = zmath__select_k((g | 2) == 14, x, z);
+    float v = zmath__select_k(g < 4, y, w);
+    return zmath__noise_flip_k(u, g & 1) + zmath__noise_flip_k(v, (g >> 1) & 1);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__noise_lerp_k(float a, float b, float t)
+{
+    return a + t * (b - a);
+}
+
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_value2_k(float x, float y, uint32_t seed)
+{
+    float cx = zmath__floor_k(x), cy = zmath__floor_k(y);
+    int32_t ix = (int32_t)cx, iy = (int32_t)cy;
+    float u = zmath__noise_fade_k(x - cx), v = zmath__noise_fade_k(y - cy);
+    float a = zmath__noise_lerp_k(zmath__noise_unit_k(zmath__noise_hash_k(seed, ix, iy, 0)),
+                                  zmath__noise_unit_k(zmath__noise_hash_k(seed, ix + 1, iy, 0)), u);
+    float b = zmath__noise_lerp_k(zmath__noise_unit_k(zmath__noise_hash_k(seed, ix, iy + 1, 0)),
+                                  zmath__noise_unit_k(zmath__noise_hash_k(seed, ix + 1, iy + 1, 0)), u);
+    return zmath__noise_lerp_k(a, b, v);
+}
+
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_value3_layer_k(uint32_t seed, int32_t ix, int32_t iy, int32_t iz,
+                                                                             float u, float v)
+{
+    float a = zmath__noise_lerp_k(zmath__noise_unit_k(zmath__noise_hash_k(seed, ix, iy, iz)),
+                                  zmath__noise_unit_k(zmath__noise_hash_k(seed, ix + 1, iy, iz)), u);
+    float b = zmath__noise_lerp_k(zmath__noise_unit_k(zmath__noise_hash_k(seed, ix, iy + 1, iz)),
+                                  zmath__noise_unit_k(zmath__noise_hash_k(seed, ix + 1, iy + 1, iz)), u);
+    return zmath__noise_lerp_k(a, b, v);
+}
+
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_value3_k(float x, float y, float z, uint32_t seed)
+{
+    float cx = zmath__floor_k(x), cy = zmath__floor_k(y), cz = zmath__floor_k(z);
+    int32_t ix = (int32_t)cx, iy = (int32_t)cy, iz = (int32_t)cz;
+    float u = zmath__noise_fade_k(x - cx), v = zmath__noise_fade_k(y - cy), w = zmath__noise_fade_k(z - cz);
+    float r0 = zmath__noise_value3_layer_k(seed, ix, iy, iz, u, v);
+    float r1 = zmath__noise_value3_layer_k(seed, ix, iy, iz + 1, u, v);
+    return zmath__noise_lerp_k(r0, r1, w);
+}
+
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_perlin2_k(float x, float y, uint32_t seed)
+{
+    float cx = zmath__floor_k(x), cy = zmath__floor_k(y);
+    int32_t ix = (int32_t)cx, iy = (int32_t)cy;
+    float fx = x - cx, fy = y - cy;
+    float u = zmath__noise_fade_k(fx), v = zmath__noise_fade_k(fy);
+    float a = zmath__noise_lerp_k(zmath__noise_grad2_k(zmath__noise_hash_k(seed, ix, iy, 0), fx, fy),
+                                  zmath__noise_grad2_k(zmath__noise_hash_k(seed, ix + 1, iy, 0), fx - 1.0f, fy), u);
+    float b = zmath__noise_lerp_k(zmath__noise_grad2_k(zmath__noise_hash_k(seed, ix, iy + 1, 0), fx, fy - 1.0f),
+                                  zmath__noise_grad2_k(zmath__noise_hash_k(seed, ix + 1, iy + 1, 0), fx - 1.0f, fy - 1.0f), u);
+    return zmath__noise_lerp_k(a, b, v);
+}
+
+// One z layer of the trilinear blend: the bilinear mix of a face of the cell.
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_perlin3_layer_k(uint32_t seed, int32_t ix, int32_t iy, int32_t iz,
+                                                                              float fx, float fy, float fz, float u, float v)
+{
+    float a = zmath__noise_lerp_k(zmath__noise_grad3_k(zmath__noise_hash_k(seed, ix, iy, iz), fx, fy, fz),
+                                  zmath__noise_grad3_k(zmath__noise_hash_k(seed, ix + 1, iy, iz), fx - 1.0f, fy, fz), u);
+    float b = zmath__noise_lerp_k(zmath__noise_grad3_k(zmath__noise_hash_k(seed, ix, iy + 1, iz), fx, fy - 1.0f, fz),
+                                  zmath__noise_grad3_k(zmath__noise_hash_k(seed, ix + 1, iy + 1, iz), fx - 1.0f, fy - 1.0f, fz), u);
+    return zmath__noise_lerp_k(a, b, v);
+}
+
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_perlin3_k(float x, float y, float z, uint32_t seed)
+{
+    float cx = zmath__floor_k(x), cy = zmath__floor_k(y), cz = zmath__floor_k(z);
+    int32_t ix = (int32_t)cx, iy = (int32_t)cy, iz = (int32_t)cz;
+    float fx = x - cx, fy = y - cy, fz = z - cz;
+    float u = zmath__noise_fade_k(fx), v = zmath__noise_fade_k(fy), w = zmath__noise_fade_k(fz);
+    float r0 = zmath__noise_perlin3_layer_k(seed, ix, iy, iz, fx, fy, fz, u, v);
+    float r1 = zmath__noise_perlin3_layer_k(seed, ix, iy, iz + 1, fx, fy, fz - 1.0f, u, v);
+    return zmath__noise_lerp_k(r0, r1, w);
+}
+
+// (0.5 - r^2)^4 falloff, which reaches zero before the next corner.
+static inline ZMATH_CONSTEXPR float zmath__noise_falloff_k(float r2)
+{
+    float t = 0.5f - r2;
+    t = zmath__select_k(t > 0.0f, t, 0.0f);
+    t *= t;
+    return t * t;
+}
+
+// Skews the plane so simplices become half cells, picks the second corner
+// from which half x lies in, and sums the three corner contributions.
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_simplex2_k(float x, float y, uint32_t seed)
+{
+    const float F2 = 0.36602540378443865f;
+    const float G2 = 0.21132486540518712f;
+    float s = (x + y) * F2;
+    float ci = zmath__floor_k(x + s), cj = zmath__floor_k(y + s);
+    int32_t i = (int32_t)ci, j = (int32_t)cj;
+    float t = (ci + cj) * G2;
+    float x0 = x - (ci - t), y0 = y - (cj - t);
+
+    int32_t i1 = (int32_t)(x0 > y0);
+    int32_t j1 = 1 - i1;
+    float x1 = x0 - (float)i1 + G2, y1 = y0 - (float)j1 + G2;
+    float x2 = x0 - 1.0f + 2.0f * G2, y2 = y0 - 1.0f + 2.0f * G2;
+
+    float n0 = zmath__noise_falloff_k(x0 * x0 + y0 * y0) * zmath__noise_grad2_k(zmath__noise_hash_k(seed, i, j, 0), x0, y0);
+    float n1 = zmath__noise_falloff_k(x1 * x1 + y1 * y1) * zmath__noise_grad2_k(zmath__noise_hash_k(seed, i + i1, j + j1, 0), x1, y1);
+    float n2 = zmath__noise_falloff_k(x2 * x2 + y2 * y2) * zmath__noise_grad2_k(zmath__noise_hash_k(seed, i + 1, j + 1, 0), x2, y2);
+    return ZMATH__NOISE_SIMPLEX2_SCALE * (n0 + n1 + n2);
+}
+
+// The 3D simplex is picked by ranking the offsets; ties go to x, then y.
+static ZMATH__FORCE_INLINE ZMATH_CONSTEXPR float zmath__noise_simplex3_k(float x, float y, float z, uint32_t seed)
+{
+    const float F3 = 1.0f / 3.0f;
+    const float G3 = 1.0f / 6.0f;
+    float s = (x + y + z) * F3;
+    float ci = zmath__floor_k(x + s), cj = zmath__floor_k(y + s), ck = zmath__floor_k(z + s);
+    int32_t i = (int32_t)ci, j = (int32_t)cj, k = (int32_t)ck;
+    float t = (ci + cj + ck) * G3;
+    float x0 = x - (ci - t), y0 = y - (cj - t), z0 = z - (ck - t);
+
+    int32_t xy = (int32_t)(x0 >= y0), xz = (int32_t)(x0 >= z0), yz = (int32_t)(y0 >= z0);
+    int32_t i1 = xy & xz, j1 = (1 - xy) & yz, k1 = (1 - xz) & (1 - yz);
+    int32_t i2 = xy | xz, j2 = (1 - xy) | yz, k2 = (1 - xz) | (1 - yz);
+
+    float x1 = x0 - (float)i1 + G3, y1 = y0 - (float)j1 + G3, z1 = z0 - (float)k1 + G3;
+    float x2 = x0 - (float)i2 + 2.0f * G3, y2 = y0 - (float)j2 + 2.0f * G3, z2 = z0 - (float)k2 + 2.0f * G3;
+    float x3 = x0 - 1.0f + 3.0f * G3, y3 = y0 - 1.0f + 3.0f * G3, z3 = z0 - 1.0f + 3.0f * G3;
+
+    float n0 = zmath__noise_falloff_k(x0 * x0 + y0 * y0 + z0 * z0) * zmath__noise_grad3_k(zmath__noise_hash_k(seed, i, j, k), x0, y0, z0);
+    float n1 = zmath__noise_falloff_k(x1 * x1 + y1 * y1 + z1 * z1) * zmath__noise_grad3_k(zmath__noise_hash_k(seed, i + i1, j + j1, k + k1), x1, y1, z1);
+    float n2 = zmath__noise_falloff_k(x2 * x2 + y2 * y2 + z2 * z2) * zmath__noise_grad3_k(zmath__noise_hash_k(seed, i + i2, j + j2, k + k2), x2, y2, z2);
+    float n3 = zmath__noise_falloff_k(x3 * x3 + y3 * y3 + z3 * z3) * zmath__noise_grad3_k(zmath__noise_hash_k(seed, i + 1, j + 1, k + 1), x3, y3, z3);
+    return ZMATH__NOISE_SIMPLEX3_SCALE * (n0 + n1 + n2 + n3);
+}
+
+ZMATHDEF float zmath_noise_value2(float x, float y, uint32_t seed)
+{
+    return zmath__noise_value2_k(x, y, seed);
+}
+
+ZMATHDEF float zmath_noise_value3(float x, float y, float z, uint32_t seed)
+{
+    return zmath__noise_value3_k(x, y, z, seed);
+}
+
+ZMATHDEF float zmath_noise_perlin2(float x, float y, uint32_t seed)
+{
+    return zmath__noise_perlin2_k(x, y, seed);
+}
+
+ZMATHDEF float zmath_noise_perlin3(float x, float y, float z, uint32_t seed)
+{
+    return zmath__noise_perlin3_k(x, y, z, seed);
+}
+
+ZMATHDEF float zmath_noise_simplex2(float x, float y, uint32_t seed)
+{
+    return zmath__noise_simplex2_k(x, y, seed);
+}
+
+ZMATHDEF float zmath_noise_simplex3(float x, float y, float z, uint32_t seed)
+{
+    return zmath__noise_simplex3_k(x, y, z, seed);
+}
+
+// The kind is dispatched once per call, so each loop inlines one kernel.
+ZMATHDEF void zmath_noise2_array(int kind, uint32_t seed, const float* x, const float* y, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(NOISE2_ARRAY, n);
+    if (kind == ZMATH_NOISE_SIMPLEX)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = zmath__noise_simplex2_k(x[i], y[i], seed);
+        }
+    }
+    else if (kind == ZMATH_NOISE_PERLIN)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = zmath__noise_perlin2_k(x[i], y[i], seed);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = zmath__noise_value2_k(x[i], y[i], seed);
+        }
+    }
+    ZMATH__PROF_END(NOISE2_ARRAY);
+}
+
+ZMATHDEF void zmath_noise3_array(int kind, uint32_t seed, zvec3_soa p, float* out)
+{
+    ZMATH__PROF_BEGIN(NOISE3_ARRAY, p.count);
+    const float* x = p.x;
+    const float* y = p.y;
+    const float* z = p.z;
+    size_t n = p.count;
+    if (kind == ZMATH_NOISE_SIMPLEX)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = zmath__noise_simplex3_k(x[i], y[i], z[i], seed);
+        }
+    }
+    else if (kind == ZMATH_NOISE_PERLIN)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = zmath__noise_perlin3_k(x[i], y[i], z[i], seed);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = zmath__noise_value3_k(x[i], y[i], z[i], seed);
+        }
+    }
+    ZMATH__PROF_END(NOISE3_ARRAY);
+}
+
+// Columns go in blocks whose x coordinates are built once and reused by
+// every row; within a row y is loop-invariant, so its cell and fade are
+// hoisted out of the inner loop.
+ZMATHDEF void zmath_noise2_grid(int kind, uint32_t seed, float x0, float y0, float step,
+                                float* out, size_t w, size_t h)
+{
+    ZMATH__PROF_BEGIN(NOISE2_GRID, w * h);
+    float xs[ZMATH__SOA_BLOCK];
+    for (size_t base = 0; base < w; base += ZMATH__SOA_BLOCK)
+    {
+        size_t m = w - base;
+        m = (m < ZMATH__SOA_BLOCK) ? m : ZMATH__SOA_BLOCK;
+        for (size_t i = 0; i < m; i++)
+        {
+            xs[i] = x0 + (float)(base + i) * step;
+        }
+        for (size_t j = 0; j < h; j++)
+        {
+            float y = y0 + (float)j * step;
+            float* row = out + j * w + base;
+            if (kind == ZMATH_NOISE_SIMPLEX)
+            {
+                for (size_t i = 0; i < m; i++)
+                {
+                    row[i] = zmath__noise_simplex2_k(xs[i], y, seed);
+                }
+            }
+            else if (kind == ZMATH_NOISE_PERLIN)
+            {
+                for (size_t i = 0; i < m; i++)
+                {
+                    row[i] = zmath__noise_perlin2_k(xs[i], y, seed);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < m; i++)
+                {
+                    row[i] = zmath__noise_value2_k(xs[i], y, seed);
+                }
+            }
+        }
+    }
+    ZMATH__PROF_END(NOISE2_GRID);
+}
+
+// Packing.
+// Masked selects only, so the element loops vectorize where no conversion
+// instruction is available.
+
+static inline ZMATH_CONSTEXPR uint32_t zmath__select_u_k(bool c, uint32_t a, uint32_t b)
+{
+    uint32_t m = (uint32_t)0 - (uint32_t)c;
+    return (a & m) | (b & ~m);
+}
+
+// Normal results rebias the exponent and round the 13 dropped bits to
+// nearest even (0xFFF plus the kept lsb). Below 2^-14, adding 0.5 lines the
+// f16 subnormal lsb (2^-24) up with the float lsb, and the FPU rounds.
+static inline ZMATH_CONSTEXPR uint16_t zmath__f32_to_f16_k(float x)
+{
+    uint32_t u = zmath__float_as_uint(x);
+    uint32_t sign = (u >> 16) & 0x8000u;
+    uint32_t a = u & 0x7FFFFFFFu;
+    uint32_t normal = (a + 0xC8000FFFu + ((a >> 13) & 1u)) >> 13;
+    uint32_t sub = zmath__float_as_uint(zmath__uint_as_float(a) + 0.5f) - 0x3F000000u;
+    uint32_t special = zmath__select_u_k(a > 0x7F800000u, 0x7E00u | ((a >> 13) & 0x3FFu), 0x7C00u);
+    uint32_t r = zmath__select_u_k(a < 0x38800000u, sub, zmath__select_u_k(a < 0x47800000u, normal, special));
+    return (uint16_t)(sign | r);
+}
+
+// Subnormals are read as 2^-14 * (1 + m) with the implicit 2^-14 then
+// subtracted, which is exact.
+static inline ZMATH_CONSTEXPR float zmath__f16_to_f32_k(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    uint32_t a = (uint32_t)(h & 0x7FFFu) << 13;
+    uint32_t exponent = a & 0x0F800000u;
+    uint32_t normal = a + 0x38000000u;
+    uint32_t special = (a + 0x70000000u) | ((uint32_t)(a > 0x0F800000u) << 22);
+    uint32_t sub = zmath__float_as_uint(zmath__uint_as_float(a + 0x38800000u) - 6.103515625e-05f);
+    uint32_t r = zmath__select_u_k(exponent == 0u, sub, zmath__select_u_k(exponent == 0x0F800000u, special, normal));
+    return zmath__uint_as_float(sign | r);
+}
+
+// Clamp to [lo, 1] and scale; NaN fails both tests and lands on 0.
+static inline ZMATH_CONSTEXPR int32_t zmath__pack_norm_k(float x, float lo, float scale)
+{
+    float c = zmath__select_k(x < 1.0f, zmath__select_k(x > lo, x, lo), 1.0f);
+    return zmath__rint_int_k(zmath__select_k(x == x, c, 0.0f) * scale);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__unpack_snorm_k(int32_t v, float scale)
+{
+    float f = (float)v / scale;
+    return zmath__select_k(f < -1.0f, -1.0f, f);
+}
+
+static inline ZMATH_CONSTEXPR int16_t zmath__f32_to_snorm16_k(float x)
+{
+    return (int16_t)zmath__pack_norm_k(x, -1.0f, 32767.0f);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__snorm16_to_f32_k(int16_t v)
+{
+    return zmath__unpack_snorm_k(v, 32767.0f);
+}
+
+static inline ZMATH_CONSTEXPR uint16_t zmath__f32_to_unorm16_k(float x)
+{
+    return (uint16_t)zmath__pack_norm_k(x, 0.0f, 65535.0f);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__unorm16_to_f32_k(uint16_t v)
+{
+    return (float)v / 65535.0f;
+}
+
+static inline ZMATH_CONSTEXPR int8_t zmath__f32_to_snorm8_k(float x)
+{
+    return (int8_t)zmath__pack_norm_k(x, -1.0f, 127.0f);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__snorm8_to_f32_k(int8_t v)
+{
+    return zmath__unpack_snorm_k(v, 127.0f);
+}
+
+static inline ZMATH_CONSTEXPR uint8_t zmath__f32_to_unorm8_k(float x)
+{
+    return (uint8_t)zmath__pack_norm_k(x, 0.0f, 255.0f);
+}
+
+static inline ZMATH_CONSTEXPR float zmath__unorm8_to_f32_k(uint8_t v)
+{
+    return (float)v / 255.0f;
+}
+
+ZMATHDEF uint16_t zmath_f32_to_f16(float x)
+{
+    return zmath__f32_to_f16_k(x);
+}
+
+ZMATHDEF float zmath_f16_to_f32(uint16_t h)
+{
+    return zmath__f16_to_f32_k(h);
+}
+
+ZMATHDEF int16_t zmath_f32_to_snorm16(float x)
+{
+    return zmath__f32_to_snorm16_k(x);
+}
+
+ZMATHDEF float zmath_snorm16_to_f32(int16_t v)
+{
+    return zmath__snorm16_to_f32_k(v);
+}
+
+ZMATHDEF uint16_t zmath_f32_to_unorm16(float x)
+{
+    return zmath__f32_to_unorm16_k(x);
+}
+
+ZMATHDEF float zmath_unorm16_to_f32(uint16_t v)
+{
+    return zmath__unorm16_to_f32_k(v);
+}
+
+ZMATHDEF int8_t zmath_f32_to_snorm8(float x)
+{
+    return zmath__f32_to_snorm8_k(x);
+}
+
+ZMATHDEF float zmath_snorm8_to_f32(int8_t v)
+{
+    return zmath__snorm8_to_f32_k(v);
+}
+
+ZMATHDEF uint8_t zmath_f32_to_unorm8(float x)
+{
+    return zmath__f32_to_unorm8_k(x);
+}
+
+ZMATHDEF float zmath_unorm8_to_f32(uint8_t v)
+{
+    return zmath__unorm8_to_f32_k(v);
+}
+
+// The hardware paths take whole vectors and leave the tail to the kernel.
+ZMATHDEF void zmath_f32_to_f16_array(const float* in, uint16_t* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(F32_TO_F16_ARRAY, n);
+    size_t i = 0;
+#if defined(ZMATH__F16C)
+    for (; ZMATH__RUNTIME && i + 8 <= n; i += 8)
+    {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(out + i), h);
+    }
+#elif defined(ZMATH__F16_NEON)
+    for (; ZMATH__RUNTIME && i + 4 <= n; i += 4)
+    {
+        vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out[i] = zmath__f32_to_f16_k(in[i]);
+    }
+    ZMATH__PROF_END(F32_TO_F16_ARRAY);
+}
+
+ZMATHDEF void zmath_f16_to_f32_array(const uint16_t* in, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(F16_TO_F32_ARRAY, n);
+    size_t i = 0;
+#if defined(ZMATH__F16C)
+    for (; ZMATH__RUNTIME && i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + i))));
+    }
+#elif defined(ZMATH__F16_NEON)
+    for (; ZMATH__RUNTIME && i + 4 <= n; i += 4)
+    {
+        vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        out[i] = zmath__f16_to_f32_k(in[i]);
+    }
+    ZMATH__PROF_END(F16_TO_F32_ARRAY);
+}
+
+#define ZMATH__CONVERT_ARRAY(name, id, tin, tout, kernel)           \
+    ZMATHDEF void name(const tin* in, tout* out, size_t n)          \
+    {                                                               \
+        ZMATH__PROF_BEGIN(id, n);                                   \
+        for (size_t i = 0; i < n; i++)                              \
+        {                                                           \
+            out[i] = kernel(in[i]);                                 \
+        }                                                           \
+        ZMATH__PROF_END(id);                                        \
+    }
+
+ZMATH__CONVERT_ARRAY(zmath_f32_to_snorm16_array, F32_TO_SNORM16_ARRAY, float, int16_t, zmath__f32_to_snorm16_k)
+ZMATH__CONVERT_ARRAY(zmath_snorm16_to_f32_array, SNORM16_TO_F32_ARRAY, int16_t, float, zmath__snorm16_to_f32_k)
+ZMATH__CONVERT_ARRAY(zmath_f32_to_unorm16_array, F32_TO_UNORM16_ARRAY, float, uint16_t, zmath__f32_to_unorm16_k)
+ZMATH__CONVERT_ARRAY(zmath_unorm16_to_f32_array, UNORM16_TO_F32_ARRAY, uint16_t, float, zmath__unorm16_to_f32_k)
+ZMATH__CONVERT_ARRAY(zmath_f32_to_snorm8_array, F32_TO_SNORM8_ARRAY, float, int8_t, zmath__f32_to_snorm8_k)
+ZMATH__CONVERT_ARRAY(zmath_snorm8_to_f32_array, SNORM8_TO_F32_ARRAY, int8_t, float, zmath__snorm8_to_f32_k)
+ZMATH__CONVERT_ARRAY(zmath_f32_to_unorm8_array, F32_TO_UNORM8_ARRAY, float, uint8_t, zmath__f32_to_unorm8_k)
+ZMATH__CONVERT_ARRAY(zmath_unorm8_to_f32_array, UNORM8_TO_F32_ARRAY, uint8_t, float, zmath__unorm8_to_f32_k)
+
+// Polynomials and curves.
+
+// Up to eight coefficients as an Estrin tree: the pairs c[i] + c[i + 1] x
+// are independent, then pairs of pairs join with x^2 and the halves with
+// x^4. Short blocks stop at the depth they need and read only c[0 .. m-1].
+static inline ZMATH_CONSTEXPR float zmath__estrin_k(const float* c, size_t m, float x, float x2, float x4)
+{
+    float p0 = (m > 1) ? c[0] + c[1] * x : c[0];
+    if (m <= 2)
+    {
+        return p0;
+    }
+    float p1 = (m > 3) ? c[2] + c[3] * x : c[2];
+    float lo = p0 + p1 * x2;
+    if (m <= 4)
+    {
+        return lo;
+    }
+    float p2 = (m > 5) ? c[4] + c[5] * x : c[4];
+    if (m <= 6)
+    {
+        return lo + p2 * x4;
+    }
+    float p3 = (m > 7) ? c[6] + c[7] * x : c[6];
+    return lo + (p2 + p3 * x2) * x4;
+}
+
+ZMATHDEF float zmath_poly(const float* c, size_t terms, float x)
+{
+    if (terms == 0)
+    {
+        return 0.0f;
+    }
+    // The top block holds the 1 to 8 coefficients past the last multiple of 8.
+    size_t base = (terms - 1) & ~(size_t)7;
+    float x2 = x * x;
+    float x4 = x2 * x2;
+    float x8 = x4 * x4;
+    float acc = zmath__estrin_k(c + base, terms - base, x, x2, x4);
+    for (size_t b = base; b > 0; b -= 8)
+    {
+        acc = acc * x8 + zmath__estrin_k(c + b - 8, 8, x, x2, x4);
+    }
+    return acc;
+}
+
+ZMATHDEF float zmath_poly_horner(const float* c, size_t terms, float x)
+{
+    if (terms == 0)
+    {
+        return 0.0f;
+    }
+    float acc = c[terms - 1];
+    for (size_t i = terms - 1; i > 0; i--)
+    {
+        acc = acc * x + c[i - 1];
+    }
+    return acc;
+}
+
+// Blocks of elements take one coefficient block at a time, so each inner
+// loop is straight-line code over the elements. Results are written after
+// the block's last read, so out may alias in.
+ZMATHDEF void zmath_poly_array(const float* c, size_t terms, const float* in, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(POLY_ARRAY, n);
+    if (terms == 0)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = 0.0f;
+        }
+        ZMATH__PROF_END(POLY_ARRAY);
+        return;
+    }
+    size_t base = (terms - 1) & ~(size_t)7;
+    size_t m_top = terms - base;
+    float acc[ZMATH__SOA_BLOCK];
+    for (size_t i0 = 0; i0 < n; i0 += ZMATH__SOA_BLOCK)
+    {
+        size_t m = (n - i0 < ZMATH__SOA_BLOCK) ? n - i0 : ZMATH__SOA_BLOCK;
+        const float* x = in + i0;
+        for (size_t k = 0; k < m; k++)
+        {
+            float x2 = x[k] * x[k];
+            acc[k] = zmath__estrin_k(c + base, m_top, x[k], x2, x2 * x2);
+        }
+        for (size_t b = base; b > 0; b -= 8)
+        {
+            for (size_t k = 0; k < m; k++)
+            {
+                float x2 = x[k] * x[k];
+                float x4 = x2 * x2;
+                acc[k] = acc[k] * (x4 * x4) + zmath__estrin_k(c + b - 8, 8, x[k], x2, x4);
+            }
+        }
+        for (size_t k = 0; k < m; k++)
+        {
+            out[i0 + k] = acc[k];
+        }
+    }
+    ZMATH__PROF_END(POLY_ARRAY);
+}
+
+// Basis weights of the four inputs at t. With s = 1 - t, each weight is a
+// product that vanishes exactly at the ends it should.
+typedef struct { float a, b, c, d; } zmath__curve_w;
+
+static inline ZMATH_CONSTEXPR zmath__curve_w zmath__bezier3_w_k(float t)
+{
+    float s = 1.0f - t;
+    zmath__curve_w w = { s * s * s, 3.0f * s * s * t, 3.0f * s * t * t, t * t * t };
+    return w;
+}
+
+static inline ZMATH_CONSTEXPR zmath__curve_w zmath__hermite_w_k(float t)
+{
+    float s = 1.0f - t;
+    float t2 = t * t;
+    float h01 = t2 * (3.0f - 2.0f * t);
+    zmath__curve_w w = { 1.0f - h01, t * s * s, h01, -t2 * s };
+    return w;
+}
+
+static inline ZMATH_CONSTEXPR zmath__curve_w zmath__catmull_rom_w_k(float t)
+{
+    float s = 1.0f - t;
+    float t2 = t * t;
+    zmath__curve_w w = { -0.5f * t * s * s, 1.0f + t2 * (1.5f * t - 2.5f),
+                t * (0.5f + t * (2.0f - 1.5f * t)), -0.5f * t2 * s };
+    return w;
+}
+
+static inline ZMATH_CONSTEXPR float zmath__curve_k(zmath__curve_w w, float p0, float p1, float p2, float p3)
+{
+    return w.a * p0 + w.b * p1 + w.c * p2 + w.d * p3;
+}
+
+static inline ZMATH_CONSTEXPR zvec2 zmath__v2_curve_k(zmath__curve_w w, zvec2 p0, zvec2 p1, zvec2 p2, zvec2 p3)
+{
+    zvec2 r = { zmath__curve_k(w, p0.x, p1.x, p2.x, p3.x), zmath__curve_k(w, p0.y, p1.y, p2.y, p3.y) };
+    return r;
+}
+
+static inline ZMATH_CONSTEXPR zvec3 zmath__v3_curve_k(zmath__curve_w w, zvec3 p0, zvec3 p1, zvec3 p2, zvec3 p3)
+{
+    zvec3 r = { zmath__curve_k(w, p0.x, p1.x, p2.x, p3.x), zmath__curve_k(w, p0.y, p1.y, p2.y, p3.y),
+                zmath__curve_k(w, p0.z, p1.z, p2.z, p3.z) };
+    return r;
+}
+
+ZMATHDEF float zmath_bezier3(float p0, float p1, float p2, float p3, float t)
+{
+    return zmath__curve_k(zmath__bezier3_w_k(t), p0, p1, p2, p3);
+}
+
+ZMATHDEF float zmath_hermite(float p0, float m0, float p1, float m1, float t)
+{
+    return zmath__curve_k(zmath__hermite_w_k(t), p0, m0, p1, m1);
+}
+
+ZMATHDEF float zmath_catmull_rom(float p0, float p1, float p2, float p3, float t)
+{
+    return zmath__curve_k(zmath__catmull_rom_w_k(t), p0, p1, p2, p3);
+}
+
+ZMATHDEF zvec2 zmath_v2_bezier3(zvec2 p0, zvec2 p1, zvec2 p2, zvec2 p3, float t)
+{
+    return zmath__v2_curve_k(zmath__bezier3_w_k(t), p0, p1, p2, p3);
+}
+
+ZMATHDEF zvec2 zmath_v2_hermite(zvec2 p0, zvec2 m0, zvec2 p1, zvec2 m1, float t)
+{
+    return zmath__v2_curve_k(zmath__hermite_w_k(t), p0, m0, p1, m1);
+}
+
+ZMATHDEF zvec2 zmath_v2_catmull_rom(zvec2 p0, zvec2 p1, zvec2 p2, zvec2 p3, float t)
+{
+    return zmath__v2_curve_k(zmath__catmull_rom_w_k(t), p0, p1, p2, p3);
+}
+
+ZMATHDEF zvec3 zmath_v3_bezier3(zvec3 p0, zvec3 p1, zvec3 p2, zvec3 p3, float t)
+{
+    return zmath__v3_curve_k(zmath__bezier3_w_k(t), p0, p1, p2, p3);
+}
+
+ZMATHDEF zvec3 zmath_v3_hermite(zvec3 p0, zvec3 m0, zvec3 p1, zvec3 m1, float t)
+{
+    return zmath__v3_curve_k(zmath__hermite_w_k(t), p0, m0, p1, m1);
+}
+
+ZMATHDEF zvec3 zmath_v3_catmull_rom(zvec3 p0, zvec3 p1, zvec3 p2, zvec3 p3, float t)
+{
+    return zmath__v3_curve_k(zmath__catmull_rom_w_k(t), p0, p1, p2, p3);
+}
+
+// The kind is tested once per call, so each loop inlines one basis.
+#define ZMATH__CURVE_LOOPS(body)                                    \
+    if (kind == ZMATH_CURVE_BEZIER)                                 \
+    {                                                               \
+        for (size_t i = 0; i < n; i++)                              \
+        {                                                           \
+            zmath__curve_w w = zmath__bezier3_w_k(t[i]);                     \
+            body;                                                   \
+        }                                                           \
+    }                                                               \
+    else if (kind == ZMATH_CURVE_HERMITE)                           \
+    {                                                               \
+        for (size_t i = 0; i < n; i++)                              \
+        {                                                           \
+            zmath__curve_w w = zmath__hermite_w_k(t[i]);                     \
+            body;                                                   \
+        }                                                           \
+    }                                                               \
+    else                                                            \
+    {                                                               \
+        for (size_t i = 0; i < n; i++)                              \
+        {                                                           \
+            zmath__curve_w w = zmath__catmull_rom_w_k(t[i]);                 \
+            body;                                                   \
+        }                                                           \
+    }
+
+ZMATHDEF void zmath_curve_array(int kind, const float p[4], const float* t, float* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(CURVE_ARRAY, n);
+    float p0 = p[0], p1 = p[1], p2 = p[2], p3 = p[3];
+    ZMATH__CURVE_LOOPS(out[i] = zmath__curve_k(w, p0, p1, p2, p3))
+    ZMATH__PROF_END(CURVE_ARRAY);
+}
+
+ZMATHDEF void zmath_v2_curve_array(int kind, const zvec2 p[4], const float* t, zvec2* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(V2_CURVE_ARRAY, n);
+    zvec2 p0 = p[0], p1 = p[1], p2 = p[2], p3 = p[3];
+    ZMATH__CURVE_LOOPS(out[i] = zmath__v2_curve_k(w, p0, p1, p2, p3))
+    ZMATH__PROF_END(V2_CURVE_ARRAY);
+}
+
+ZMATHDEF void zmath_v3_curve_array(int kind, const zvec3 p[4], const float* t, zvec3* out, size_t n)
+{
+    ZMATH__PROF_BEGIN(V3_CURVE_ARRAY, n);
+    zvec3 p0 = p[0], p1 = p[1], p2 = p[2], p3 = p[3];
+    ZMATH__CURVE_LOOPS(out[i] = zmath__v3_curve_k(w, p0, p1, p2, p3))
+    ZMATH__PROF_END(V3_CURVE_ARRAY);
+}
+
+// FFT.
+// Iterative radix-2 decimation in time: a bit-reversal permutation, the
+// first two stages as one radix-4 pass without multiplies, then one pass
+// per stage. Stage `len` (8 .. n) keeps its len / 2 twiddles contiguous at
+// tw + len - 8, cosines then negated sines, so the butterfly loop streams
+// through them and vectorizes.
+
+// cos and sin of 2 pi j / len for j <= len / 2, from an angle of at most
+// pi / 4 with quarter- and eighth-turn symmetry.
+static inline ZMATH_CONSTEXPR void zmath__fft_root(size_t j, size_t len, float* c, float* s)
+{
+    size_t quarter = len >> 2, eighth = len >> 3;
+    bool upper = j > quarter;
+    size_t k = upper ? j - quarter : j;
+    bool mirror = k > eighth;
+    size_t r = mirror ? quarter - k : k;
+    float sa, ca;
+    zmath_sincos_precise((float)r * (ZMATH_TAU / (float)len), &sa, &ca);
+    float ck = mirror ? sa : ca;
+    float sk = mirror ? ca : sa;
+    *c = upper ? -sk : ck;
+    *s = upper ? ck : sk;
+}
+
+// Fills the stage tables for a complex transform of n points: 2n - 8
+// floats for n >= 8, none below. Returns the floats used.
+static inline ZMATH_CONSTEXPR size_t zmath__fft_twiddles(float* tw, size_t n)
+{
+    for (size_t len = 8; len <= n; len <<= 1)
+    {
+        size_t half = len >> 1;
+        float* wr = tw + (len - 8);
+        for (size_t j = 0; j < half; j++)
+        {
+            float c, sn;
+            zmath__fft_root(j, len, &c, &sn);
+            wr[j] = c;
+            wr[half + j] = -sn;
+        }
+    }
+    return (n >= 8) ? 2 * n - 8 : 0;
+}
+
+// One group of butterflies: the halves never overlap each other or the
+// table, which the restrict qualifiers tell the vectorizer.
+static inline ZMATH_CONSTEXPR void zmath__fft_span_k(float* ZMATH_RESTRICT ar, float* ZMATH_RESTRICT ai,
+                                                   float* ZMATH_RESTRICT br, float* ZMATH_RESTRICT bi,
+                                                   const float* ZMATH_RESTRICT wr, const float* ZMATH_RESTRICT wi,
+                                                   float sign, size_t half)
+{
+    for (size_t j = 0; j < half; j++)
+    {
+        float c = wr[j], sn = sign * wi[j];
+        float tr = br[j] * c - bi[j] * sn;
+        float ti = br[j] * sn + bi[j] * c;
+        br[j] = ar[j] - tr;
+        bi[j] = ai[j] - ti;
+        ar[j] += tr;
+        ai[j] += ti;
+    }
+}
+
+// sign is 1 for the forward transform and -1 for the inverse (conjugated
+// twiddles). No scaling.
+static inline ZMATH_CONSTEXPR void zmath__fft_core(const float* tw, size_t n, float* re, float* im, float sign)
+{
+    for (size_t i = 0, j = 0; i < n; i++)
+    {
+        if (i < j)
+        {
+            float t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j |= bit;
+    }
+    if (n == 2)
+    {
+        float r = re[1], m = im[1];
+        re[1] = re[0] - r;
+        im[1] = im[0] - m;
+        re[0] += r;
+        im[0] += m;
+        return;
+    }
+    // Stage 4's odd twiddle is -i forward and i inverse.
+    for (size_t b = 0; n >= 4 && b < n; b += 4)
+    {
+        float ar = re[b] + re[b + 1], ai = im[b] + im[b + 1];
+        float br = re[b] - re[b + 1], bi = im[b] - im[b + 1];
+        float cr = re[b + 2] + re[b + 3], ci = im[b + 2] + im[b + 3];
+        float dr = sign * (im[b + 2] - im[b + 3]), di = sign * (re[b + 3] - re[b + 2]);
+        re[b] = ar + cr;
+        im[b] = ai + ci;
+        re[b + 2] = ar - cr;
+        im[b + 2] = ai - ci;
+        re[b + 1] = br + dr;
+        im[b + 1] = bi + di;
+        re[b + 3] = br - dr;
+        im[b + 3] = bi - di;
+    }
+    for (size_t len = 8; len <= n; len <<= 1)
+    {
+        size_t half = len >> 1;
+        const float* wr = tw + (len - 8);
+        const float* wi = wr + half;
+        for (size_t b = 0; b < n; b += len)
+        {
+            zmath__fft_span_k(re + b, im + b, re + b + half, im + b + half, wr, wi, sign, half);
+        }
+    }
+}
+
+ZMATHDEF bool zmath_fft_init(zfft_plan* plan, size_t n, float* table)
+{
+    if (n == 0 || (n & (n - 1)) != 0)
+    {
+        return false;
+    }
+    zmath__fft_twiddles(table, n);
+    plan->n = n;
+    plan->tw = table;
+    return true;
+}
+
+// The real plan holds the stage tables of n / 2 points, then e^(-2 pi i k / n)
+// for k <= n / 4 (cosines, then negated sines) for the split of the result.
+ZMATHDEF bool zmath_fft_real_init(zfft_plan* plan, size_t n, float* table)
+{
+    if (n < 2 || (n & (n - 1)) != 0)
+    {
+        return false;
+    }
+    size_t m = n / 2, count = m / 2 + 1;
+    float* post = table + zmath__fft_twiddles(table, m);
+    for (size_t k = 0; k < count; k++)
+    {
+        float c, sn;
+        zmath__fft_root(k, n, &c, &sn);
+        post[k] = c;
+        post[count + k] = -sn;
+    }
+    plan->n = n;
+    plan->tw = table;
+    return true;
+}
+
+ZMATHDEF void zmath_fft(const zfft_plan* plan, float* re, float* im)
+{
+    ZMATH__PROF_BEGIN(FFT, plan->n);
+    zmath__fft_core(plan->tw, plan->n, re, im, 1.0f);
+    ZMATH__PROF_END(FFT);
+}
+
+ZMATHDEF void zmath_ifft(const zfft_plan* plan, float* re, float* im)
+{
+    ZMATH__PROF_BEGIN(IFFT, plan->n);
+    size_t n = plan->n;
+    zmath__fft_core(plan->tw, n, re, im, -1.0f);
+    float scale = 1.0f / (float)n;
+    for (size_t i = 0; i < n; i++)
+    {
+        re[i] *= scale;
+        im[i] *= scale;
+    }
+    ZMATH__PROF_END(IFFT);
+}
+
+// Packs even samples as the real parts and odd ones as the imaginary parts
+// of n / 2 points. With Z their transform, the even and odd spectra are
+// E = (Z[k] + conj Z[m - k]) / 2 and O = (Z[k] - conj Z[m - k]) / 2i, and
+// X[k] = E + w^k O, X[m - k] = conj(E - w^k O). Each pair is read and
+// written in place.
+ZMATHDEF void zmath_fft_real(const zfft_plan* plan, const float* in, float* re, float* im)
+{
+    ZMATH__PROF_BEGIN(FFT_REAL, plan->n);
+    size_t m = plan->n / 2, count = m / 2 + 1;
+    const float* wr = plan->tw + ((m >= 8) ? 2 * m - 8 : 0);
+    const float* wi = wr + count;
+    for (size_t k = 0; k < m; k++)
+    {
+        re[k] = in[2 * k];
+        im[k] = in[2 * k + 1];
+    }
+    zmath__fft_core(plan->tw, m, re, im, 1.0f);
+    float r0 = re[0], i0 = im[0];
+    re[0] = r0 + i0;
+    im[0] = 0.0f;
+    re[m] = r0 - i0;
+    im[m] = 0.0f;
+    for (size_t k = 1; k < count; k++)
+    {
+        size_t j = m - k;
+        float er = 0.5f * (re[k] + re[j]), ei = 0.5f * (im[k] - im[j]);
+        float orr = 0.5f * (im[k] + im[j]), oi = 0.5f * (re[j] - re[k]);
+        float tr = orr * wr[k] - oi * wi[k];
+        float ti = orr * wi[k] + oi * wr[k];
+        re[k] = er + tr;
+        im[k] = ei + ti;
+        re[j] = er - tr;
+        im[j] = ti - ei;
+    }
+    ZMATH__PROF_END(FFT_REAL);
+}
+
+// The split run backwards, Z[k] = E + i O with O = (X[k] - conj X[m - k])
+// conj(w^k) / 2, then an inverse transform of n / 2 points. The 1 / (n / 2)
+// scale is folded into the halving.
+ZMATHDEF void zmath_ifft_real(const zfft_plan* plan, float* re, float* im, float* out)
+{
+    ZMATH__PROF_BEGIN(IFFT_REAL, plan->n);
+    size_t m = plan->n / 2, count = m / 2 + 1;
+    const float* wr = plan->tw + ((m >= 8) ? 2 * m - 8 : 0);
+    const float* wi = wr + count;
+    float h = 0.5f / (float)m;
+    float x0 = re[0], xm = re[m];
+    re[0] = h * (x0 + xm);
+    im[0] = h * (x0 - xm);
+    for (size_t k = 1; k < count; k++)
+    {
+        size_t j = m - k;
+        float er = h * (re[k] + re[j]), ei = h * (im[k] - im[j]);
+        float dr = h * (re[k] - re[j]), di = h * (im[k] + im[j]);
+        float orr = dr * wr[k] + di * wi[k];
+        float oi = di * wr[k] - dr * wi[k];
+        re[k] = er - oi;
+        im[k] = ei + orr;
+        re[j] = er + oi;
+        im[j] = orr - ei;
+    }
+    zmath__fft_core(plan->tw, m, re, im, -1.0f);
+    for (size_t k = 0; k < m; k++)
+    {
+        out[2 * k] = re[k];
+        out[2 * k + 1] = im[k];
+    }
+    ZMATH__PROF_END(IFFT_REAL);
+}
+
+// Angle tables.
+
+// Seeds and steps come from zmath_sincos_d. Rows of ZMATH__SOA_BLOCK lanes
+// advance by one rotation each, so the row loop is a plain vector loop with
+// no dependency between lanes.
+ZMATHDEF void zmath_sincos_table(float start, float step, float* s, float* c, size_t n)
+{
+    ZMATH__PROF_BEGIN(SINCOS_TABLE, n);
+    double ls[ZMATH__SOA_BLOCK] = {0}, lc[ZMATH__SOA_BLOCK] = {0};
+    double s1 = 0.0, c1 = 0.0, sr = 0.0, cr = 0.0;
+    zmath_sincos_d((double)start, &ls[0], &lc[0]);
+    zmath_sincos_d((double)step, &s1, &c1);
+    zmath_sincos_d((double)ZMATH__SOA_BLOCK * (double)step, &sr, &cr);
+    for (int j = 1; j < ZMATH__SOA_BLOCK; j++)
+    {
+        ls[j] = ls[j - 1] * c1 + lc[j - 1] * s1;
+        lc[j] = lc[j - 1] * c1 - ls[j - 1] * s1;
+    }
+    size_t i = 0;
+    for (size_t row = 1; i + ZMATH__SOA_BLOCK <= n; i += ZMATH__SOA_BLOCK, row++)
+    {
+        for (int j = 0; j < ZMATH__SOA_BLOCK; j++)
+        {
+            s[i + j] = (float)ls[j];
+            c[i + j] = (float)lc[j];
+            double t = ls[j] * cr + lc[j] * sr;
+            lc[j] = lc[j] * cr - ls[j] * sr;
+            ls[j] = t;
+        }
+        // One Newton step toward unit length every 8 rows. The drift it
+        // removes stays far below a float ulp, but would grow without bound.
+        if ((row & 7) == 0)
+        {
+            for (int j = 0; j < ZMATH__SOA_BLOCK; j++)
+            {
+                double f = 1.5 - 0.5 * (ls[j] * ls[j] + lc[j] * lc[j]);
+                ls[j] *= f;
+                lc[j] *= f;
+            }
+        }
+    }
+    for (int j = 0; i < n; i++, j++)
+    {
+        s[i] = (float)ls[j];
+        c[i] = (float)lc[j];
+    }
+    ZMATH__PROF_END(SINCOS_TABLE);
+}
+
+ZMATHDEF zvec2 zmath_v2_rotate_sc(zvec2 v, float s, float c)
+{
+    zvec2 r = { v.x * c - v.y * s, v.x * s + v.y * c };
+    return r;
+}
+
+// Denormal control.
+// MXCSR bit 15 is FTZ and bit 6 DAZ. On AArch64, FPCR.FZ (bit 24) flushes
+// subnormal inputs and results alike.
+ZMATHDEF zfp_state zmath_ftz_begin(void)
+{
+    zfp_state saved = { 0 };
+#if defined(ZMATH__FTZ_SSE)
+    if (ZMATH__RUNTIME)
+    {
+        unsigned int csr = _mm_getcsr();
+        saved.reg = csr;
+        _mm_setcsr(csr | 0x8040u);
+    }
+#elif defined(ZMATH__FTZ_ARM64)
+    if (ZMATH__RUNTIME)
+    {
+        uint64_t fpcr = 0;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+        saved.reg = fpcr;
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | ((uint64_t)1 << 24)));
+    }
+#endif
+    return saved;
+}
+
+ZMATHDEF void zmath_ftz_end(zfp_state saved)
+{
+#if defined(ZMATH__FTZ_SSE)
+    if (ZMATH__RUNTIME)
+    {
+        _mm_setcsr((unsigned int)saved.reg);
+    }
+#elif defined(ZMATH__FTZ_ARM64)
+    if (ZMATH__RUNTIME)
+    {
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(saved.reg));
+    }
+#else
+    (void)saved;
+#endif
+}
+
+// Double precision.
+// The kernels follow fdlibm: Cody-Waite reduction against split constants,
+// then its minimax polynomials. Rounding and exponent extraction go through
+// the 1.5 * 2^52 magic add and bit operations on the 64-bit pattern, so no
+// kernel converts between integers and doubles and every one vectorizes.
+// Where ZMATH__RINT_CAST is set the magic add is not rounded to double, and
+// rounding goes through int64 as in zmath__rint_k.
+
+static inline ZMATH_CONSTEXPR double zmath__select_d_k(bool c, double a, double b)
+{
+    uint64_t m = (uint64_t)0 - (uint64_t)c;
+    return zmath__u64_as_double((zmath__double_as_u64(a) & m) | (zmath__double_as_u64(b) & ~m));
+}
+
+// Nearest integer of x (ties to even), as a double and as the two's
+// complement bits in *k, for |x| < 2^51. Larger x give unspecified results.
+static inline ZMATH_CONSTEXPR double zmath__rint_d_k(double x, uint64_t* k)
+{
+#ifdef ZMATH__RINT_CAST
+    double h = zmath__select_d_k(x > -2251799813685248.0 && x < 2251799813685248.0, x, 0.0);
+    int64_t i = (int64_t)h;
+    double f = h - (double)i;
+    f = zmath__select_d_k(f < 0.0, -f, f);
+    i += (f > 0.5 || (f == 0.5 && (i & 1))) ? ((h < 0.0) ? -1 : 1) : 0;
+    *k = (uint64_t)i;
+    return (double)i;
+#else
+    double t = x + 6755399441055744.0;
+    *k = zmath__double_as_u64(t) - zmath__double_as_u64(6755399441055744.0);
+    return t - 6755399441055744.0;
+#endif
+}
+
+// Magic seed and four Newton steps; the seed error of 3.4e-2 squares each
+// step.
+static inline ZMATH_CONSTEXPR double zmath__invsqrt_d_k(double x)
+{
+    double xhalf = 0.5 * x;
+    double y = zmath__u64_as_double(0x5FE6EB50C7B537A9ull - (zmath__double_as_u64(x) >> 1));
+    y = y * (1.5 - xhalf * y * y);
+    y = y * (1.5 - xhalf * y * y);
+    y = y * (1.5 - xhalf * y * y);
+    return y + y * (0.5 - xhalf * y * y);
+}
+
+// x * invsqrt(x), then one correction against the residual.
+static inline ZMATH_CONSTEXPR double zmath__sqrt_d_k(double x)
+{
+    double y = zmath__invsqrt_d_k(x);
+    double g = x * y;
+    g = g + 0.5 * y * (x - g * g);
+    return zmath__select_d_k(x <= 0.0, 0.0, g);
+}
+
+// Reduces x to r in [-pi/4, pi/4] and the quadrant q. pi/2 is split in
+// three 33-bit parts, so q * part is exact while q < 2^20, plus a tail
+// that keeps r accurate near the multiples of pi/2.
+static inline ZMATH_CONSTEXPR double zmath__reduce_pio2_d_k(double x, uint64_t* q)
+{
+    double k = zmath__rint_d_k(x * 6.36619772367581382433e-01, q);
+    double r = x - k * 1.57079632673412561417e+00;
+    ZMATH__PIN_K(r);
+    r = r - k * 6.07710050630396597660e-11;
+    ZMATH__PIN_K(r);
+    r = r - k * 2.02226624871116645580e-21;
+    ZMATH__PIN_K(r);
+    return r - k * 8.47842766036889956997e-32;
+}
+
+static inline ZMATH_CONSTEXPR double zmath__sin_poly_d_k(double r)
+{
+    double z = r * r;
+    double p = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 +
+               z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 +
+               z * 1.58969099521155010221e-10)));
+    return r + z * r * (-1.66666666666666324348e-01 + z * p);
+}
+
+// 1 - z/2 is split so its rounding error is added back.
+static inline ZMATH_CONSTEXPR double zmath__cos_poly_d_k(double r)
+{
+    double z = r * r;
+    double p = z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+               z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+               z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+    double hz = 0.5 * z;
+    double w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + z * p);
+}
+
+// Quadrant q picks the polynomial with bit 0 and the sign with bit 1.
+static inline ZMATH_CONSTEXPR double zmath__quadrant_d_k(uint64_t q, double sp, double cp)
+{
+    double v = zmath__select_d_k((q & 1) != 0, cp, sp);
+    return zmath__u64_as_double(zmath__double_as_u64(v) ^ ((q & 2) << 62));
+}
+
+static inline ZMATH_CONSTEXPR double zmath__sin_d_k(double x)
+{
+    uint64_t q = 0;
+    double r = zmath__reduce_pio2_d_k(x, &q);
+    return zmath__quadrant_d_k(q, zmath__sin_poly_d_k(r), zmath__cos_poly_d_k(r));
+}
+
+static inline ZMATH_CONSTEXPR double zmath__cos_d_k(double x)
+{
+    uint64_t q = 0;
+    double r = zmath__reduce_pio2_d_k(x, &q);
+    return zmath__quadrant_d_k(q + 1, zmath__sin_poly_d_k(r), zmath__cos_poly_d_k(r));
+}
+
+// exp(x) = 2^k * exp(r) with r = x - k * ln2 in [-ln2/2, ln2/2]; exp(r)
+// comes from fdlibm's rational form and 2^k is added to the exponent bits.
+static inline ZMATH_CONSTEXPR double zmath__exp_d_k(double x)
+{
+    uint64_t ki = 0;
+    double k = zmath__rint_d_k(x * 1.44269504088896338700e+00, &ki);
+    double hi = x - k * 6.93147180369123816490e-01;
+    double lo = k * 1.90821492927058770002e-10;
+    double r = hi - lo;
+    double z = r * r;
+    double c = r - z * (1.66666666666666019037e-01 + z * (-2.77777777770155933842e-03 +
+               z * (6.61375632143793436117e-05 + z * (-1.65339022054652515390e-06 +
+               z * 4.13813679705723846039e-08))));
+    double y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+    double res = zmath__u64_as_double(zmath__double_as_u64(y) + (ki << 52));
+#ifndef ZMATH_FAST_MATH
+    res = zmath__select_d_k(x < -708.3964185322641, 0.0, res);
+    res = zmath__select_d_k(!(x <= 709.782712893384), x * (double)ZMATH_INFINITY, res);
+#endif
+    return res;
+}
+
+// Mantissa centred on [sqrt(1/2), sqrt(2)); log(1 + f) = f - f^2/2 + s *
+// (f^2/2 + R(s^2)) with s = f / (2 + f), and k * ln2 split in two. The
+// exponent becomes a double by OR-ing it under 2^52.
+static inline ZMATH_CONSTEXPR double zmath__log_d_k(double x)
+{
+    double v = x;
+    double bias = 0.0;
+#ifndef ZMATH_FAST_MATH
+    bool sub = x < 2.2250738585072014e-308;
+    v = zmath__select_d_k(sub, x * 4503599627370496.0, x);
+    bias = zmath__select_d_k(sub, -52.0, 0.0);
+#endif
+    uint64_t ix = zmath__double_as_u64(v) + (0x3FF0000000000000ull - 0x3FE6A09E667F3BCDull);
+    double e = zmath__u64_as_double(0x4330000000000000ull | (ix >> 52)) - 4503599627370496.0;
+    double k = e - 1023.0 + bias;
+    double f = zmath__u64_as_double((ix & 0x000FFFFFFFFFFFFFull) + 0x3FE6A09E667F3BCDull) - 1.0;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double t1 = w * (3.999999999940941908e-01 + w * (2.222219843214978396e-01 +
+                w * 1.531383769920937332e-01));
+    double t2 = z * (6.666666666666735130e-01 + w * (2.857142874366239149e-01 +
+                w * (1.818357216161805012e-01 + w * 1.479819860511658591e-01)));
+    double hfsq = 0.5 * f * f;
+    double r = k * 6.93147180369123816490e-01 -
+               ((hfsq - (s * (hfsq + t1 + t2) + k * 1.90821492927058770002e-10)) - f);
+#ifndef ZMATH_FAST_MATH
+    r = zmath__select_d_k(!(x < (double)ZMATH_INFINITY), x, r);
+#endif
+    return zmath__select_d_k(x <= 0.0, -(double)ZMATH_INFINITY, r);
+}
+
+ZMATHDEF double zmath_sqrt_d(double x)
+{
+    return zmath__sqrt_d_k(x);
+}
+
+ZMATHDEF double zmath_invsqrt_d(double x)
+{
+    return zmath__invsqrt_d_k(x);
+}
+
+ZMATHDEF double zmath_sin_d(double x)
+{
+    return zmath__sin_d_k(x);
+}
+
+ZMATHDEF double zmath_cos_d(double x)
+{
+    return zmath__cos_d_k(x);
+}
+
+ZMATHDEF void zmath_sincos_d(double x, double* s, double* c)
+{
+    uint64_t q = 0;
+    double r = zmath__reduce_pio2_d_k(x, &q);
+    double sp = zmath__sin_poly_d_k(r);
+    double cp = zmath__cos_poly_d_k(r);
+    *s = zmath__quadrant_d_k(q, sp, cp);
+    *c = zmath__quadrant_d_k(q + 1, sp, cp);
+}
+
+ZMATHDEF double zmath_exp_d(double x)
+{
+    return zmath__exp_d_k(x);
+}
+
+ZMATHDEF double zmath_log_d(double x)
+{
+    return zmath__log_d_k(x);
+}
+
+ZMATHDEF zvec3d zmath_v3d_add(zvec3d a, zvec3d b)
+{
+    zvec3d r = { a.x + b.x, a.y + b.y, a.z + b.z };
+    return r;
+}
+
+ZMATHDEF zvec3d zmath_v3d_sub(zvec3d a, zvec3d b)
+{
+    zvec3d r = { a.x - b.x, a.y - b.y, a.z - b.z };
+    return r;
+}
+
+ZMATHDEF zvec3d zmath_v3d_scale(zvec3d v, double s)
+{
+    zvec3d r = { v.x * s, v.y * s, v.z * s };
+    return r;
+}
+
+ZMATHDEF double zmath_v3d_dot(zvec3d a, zvec3d b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+ZMATHDEF zvec3d zmath_v3d_cross(zvec3d a, zvec3d b)
+{
+    zvec3d r = { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x };
+    return r;
+}
+
+ZMATHDEF double zmath_v3d_len(zvec3d v)
+{
+    return zmath__sqrt_d_k(zmath_v3d_dot(v, v));
+}
+
+// Same rule as zmath_v3_norm at double epsilon: near-zero vectors pass
+// through.
+ZMATHDEF zvec3d zmath_v3d_norm(zvec3d v)
+{
+    double d = zmath_v3d_dot(v, v);
+    return (d > 4.930380657631324e-32) ? zmath_v3d_scale(v, zmath__invsqrt_d_k(d)) : v;
+}
+
+ZMATHDEF double zmath_v3d_dist(zvec3d a, zvec3d b)
+{
+    return zmath_v3d_len(zmath_v3d_sub(a, b));
+}
+
+ZMATHDEF zvec3d zmath_v3d_lerp(zvec3d a, zvec3d b, double t)
+{
+    zvec3d r = { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t };
+    return r;
+}
+
+ZMATHDEF zvec3d zmath_v3d_from_v3(zvec3 v)
+{
+    zvec3d r = { v.x, v.y, v.z };
+    return r;
+}
+
+ZMATHDEF zvec3 zmath_v3d_to_v3(zvec3d v)
+{
+    zvec3 r = { (float)v.x, (float)v.y, (float)v.z };
+    return r;
+}
+
+// The subtraction happens in double, so only the offset is rounded.
+ZMATHDEF zvec3 zmath_v3d_to_v3_rel(zvec3d v, zvec3d origin)
+{
+    zvec3 r = { (float)(v.x - origin.x), (float)(v.y - origin.y), (float)(v.z - origin.z) };
+    return r;
+}
+
+#define ZMATH__UNARY_ARRAY_D(name, id, kernel)                      \
+    ZMATHDEF void name(const double* in, double* out, size_t n)     \
+    {                                                               \
+        ZMATH__PROF_BEGIN(id, n);                                   \
+        for (size_t i = 0; i < n; i++)                              \
+        {                                                           \
+            out[i] = kernel(in[i]);                                 \
+        }                                                           \
+        ZMATH__PROF_END(id);                                        \
+    }
+
+ZMATH__UNARY_ARRAY_D(zmath_sqrt_d_array, SQRT_D_ARRAY, zmath__sqrt_d_k)
+ZMATH__UNARY_ARRAY_D(zmath_invsqrt_d_array, INVSQRT_D_ARRAY, zmath__invsqrt_d_k)
+ZMATH__UNARY_ARRAY_D(zmath_sin_d_array, SIN_D_ARRAY, zmath__sin_d_k)
+ZMATH__UNARY_ARRAY_D(zmath_cos_d_array, COS_D_ARRAY, zmath__cos_d_k)
+ZMATH__UNARY_ARRAY_D(zmath_exp_d_array, EXP_D_ARRAY, zmath__exp_d_k)
+ZMATH__UNARY_ARRAY_D(zmath_log_d_array, LOG_D_ARRAY, zmath__log_d_k)
+
+ZMATHDEF void zmath_sincos_d_array(const double* in, double* s, double* c, size_t n)
+{
+    ZMATH__PROF_BEGIN(SINCOS_D_ARRAY, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t q = 0;
+        double r = zmath__reduce_pio2_d_k(in[i], &q);
+        double sp = zmath__sin_poly_d_k(r);
+        double cp = zmath__cos_poly_d_k(r);
+        s[i] = zmath__quadrant_d_k(q, sp, cp);
+        c[i] = zmath__quadrant_d_k(q + 1, sp, cp);
+    }
+    ZMATH__PROF_END(SINCOS_D_ARRAY);
+}
+
+// Fixed point.
+// Products go through int64 and signed values wrap through uint32, so no
+// step has undefined behaviour. Right shifts of negative values are
+// arithmetic on every supported compiler.
+
+// atan(2^-i) in Q2.30, for the CORDIC in fix_atan2.
+static ZMATH_CONSTEXPR const int32_t zmath__cordic_atan[24] =
+{
+    843314857, 497837829, 263043837, 133525159, 67021687, 33543516,
+    16775851, 8388437, 4194283, 2097149, 1048576, 524288,
+    262144, 131072, 65536, 32768, 16384, 8192,
+    4096, 2048, 1024, 512, 256, 128,
+};
+
+static inline ZMATH_CONSTEXPR zfix zmath__fix_wrap_k(int64_t v)
+{
+    return (zfix)(uint32_t)(uint64_t)v;
+}
+
+static inline ZMATH_CONSTEXPR zfix zmath__fix_sat_k(int64_t v)
+{
+    return (zfix)(v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : v));
+}
+
+// Rounded integer square root of a 64-bit value, one result bit per step.
+static inline ZMATH_CONSTEXPR uint64_t zmath__isqrt64_k(uint64_t n)
+{
+    uint64_t r = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > n)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (n >= r + bit)
+        {
+            n -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+        {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return r + (n > r ? 1u : 0u);
 }
 
-// Interpolation.
-
-ZMATHDEF float zmath_step(float edge, float x) 
+// Sum of Q32.32 products, rounded back to Q16.16.
+static inline ZMATH_CONSTEXPR zfix zmath__fix_sum_k(uint64_t s)
 {
-    return (x < edge) ? 0.0f : 1.0f;
+    return zmath__fix_wrap_k(((int64_t)s + 0x8000) >> 16);
 }
 
-ZMATHDEF float zmath_smoothstep(float edge0, float edge1, float x) 
+static inline ZMATH_CONSTEXPR uint64_t zmath__fix_sq_k(zfix a)
 {
-    float t = zmath_clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f); 
-    return t * t * (3.0f - 2.0f * t);
+    return (uint64_t)((int64_t)a * a);
 }
 
-ZMATHDEF float zmath_smootherstep(float edge0, float edge1, float x) 
+// sin of a uint32 phase (2^32 per turn). The quarter-wave argument is
+// x in Q2.30 and sin(pi/2 * x) an odd degree-7 fit, within 6.6e-7.
+static inline ZMATH_CONSTEXPR zfix zmath__fix_sin_phase_k(uint32_t phase)
 {
-    float t = zmath_clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
-    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    uint32_t q = phase >> 30;
+    int64_t x = (int64_t)(phase & 0x3FFFFFFFu);
+    if (q & 1u)
+    {
+        x = ((int64_t)1 << 30) - x;
+    }
+    int64_t x2 = (x * x) >> 30;
+    int64_t p = -4658781;
+    p = 85303417 + ((p * x2) >> 30);
+    p = -693528462 + ((p * x2) >> 30);
+    p = 1686624950 + ((p * x2) >> 30);
+    zfix s = (zfix)((((p * x) >> 30) + 0x2000) >> 14);
+    return (q & 2u) ? -s : s;
 }
 
-ZMATHDEF float zmath_lerp(float a, float b, float t) 
+// Q16.16 radians to a phase: a * 2^32 / (2pi * 2^16), the constant scaled
+// by 2^18.
+static inline ZMATH_CONSTEXPR uint32_t zmath__fix_phase_k(zfix a)
 {
-    return (1.0f - t) * a + t * b;
+    return (uint32_t)(uint64_t)(((int64_t)a * 2734261102LL + 0x20000) >> 18);
 }
 
-ZMATHDEF float zmath_inv_lerp(float a, float b, float v) 
+ZMATHDEF zfix zmath_fix_from_int(int32_t i)
 {
-    return (v - a) / (b - a);
+    return (zfix)((uint32_t)i << 16);
 }
 
-ZMATHDEF float zmath_remap(float iMin, float iMax, float oMin, float oMax, float v) 
+ZMATHDEF int32_t zmath_fix_to_int(zfix a)
 {
-    float t = zmath_inv_lerp(iMin, iMax, v);
-    return zmath_lerp(oMin, oMax, t);
+    return a >> 16;
 }
 
-// Basic arithmetic.
+// Rounds half away from zero and saturates; NaN gives 0.
+ZMATHDEF zfix zmath_fix_from_float(float x)
+{
+    float v = x * 65536.0f;
+    if (!(v > -2147483648.0f))
+    {
+        return (v == v) ? INT32_MIN : 0;
+    }
+    if (v >= 2147483648.0f)
+    {
+        return INT32_MAX;
+    }
+    // Truncate, then step by the fraction: v + 0.5f itself rounds, and
+    // would carry 0.49999997f up to 1.
+    zfix i = (zfix)v;
+    float f = v - (float)i;
+    i += (f >= 0.5f) ? 1 : ((f <= -0.5f) ? -1 : 0);
+    return i;
+}
 
-ZMATHDEF float zmath_abs(float x) 
+ZMATHDEF float zmath_fix_to_float(zfix a)
 {
+    return (float)a * (1.0f / 65536.0f);
+}
 
-    uint32_t u = zmath__float_as_uint(x);
-    u &= 0x7FFFFFFF;
-    return zmath__uint_as_float(u);
+ZMATHDEF zfix zmath_fix_add(zfix a, zfix b)
+{
+    return (zfix)((uint32_t)a + (uint32_t)b);
 }
 
-ZMATHDEF float zmath_min(float a, float b) 
+ZMATHDEF zfix zmath_fix_sub(zfix a, zfix b)
 {
-    return (a < b) ? a : b;
+    return (zfix)((uint32_t)a - (uint32_t)b);
 }
 
-ZMATHDEF float zmath_max(float a, float b) 
+ZMATHDEF zfix zmath_fix_mul(zfix a, zfix b)
 {
-    return (a > b) ? a : b;
+    return zmath__fix_wrap_k(((int64_t)a * b + 0x8000) >> 16);
 }
 
-ZMATHDEF float zmath_clamp(float x, float min_val, float max_val) 
+ZMATHDEF zfix zmath_fix_div(zfix a, zfix b)
 {
-    if (x < min_val) 
-    {
-        return min_val;
-    }
-    if (x > max_val) 
+    if (b == 0)
     {
-        return max_val;
+        return a >= 0 ? INT32_MAX : INT32_MIN;
     }
-    return x;
+    int64_t n = (int64_t)a * 65536;
+    int64_t h = (b < 0 ? -(int64_t)b : (int64_t)b) / 2;
+    n += (n < 0) ? -h : h;
+    return zmath__fix_sat_k(n / b);
 }
 
-ZMATHDEF float zmath_sign(float x) 
+ZMATHDEF zfix zmath_fix_lerp(zfix a, zfix b, zfix t)
 {
-    if (x > 0.0f) 
-    {
-        return 1.0f;
-    }
-    if (x < 0.0f) 
+    return zmath_fix_add(a, zmath_fix_mul(zmath_fix_sub(b, a), t));
+}
+
+ZMATHDEF zfix zmath_fix_sqrt(zfix a)
+{
+    if (a <= 0)
     {
-        return -1.0f;
+        return 0;
     }
-    return 0.0f;
+    return (zfix)zmath__isqrt64_k((uint64_t)a << 16);
 }
 
-ZMATHDEF float zmath_copysign(float x, float y) 
+ZMATHDEF zfix zmath_fix_sin(zfix a)
 {
-    uint32_t ix = zmath__float_as_uint(x);
-    uint32_t iy = zmath__float_as_uint(y);
-    ix = (ix & 0x7FFFFFFF) | (iy & 0x80000000);
-    return zmath__uint_as_float(ix);
+    return zmath__fix_sin_phase_k(zmath__fix_phase_k(a));
 }
 
-// Rounding.
-
-#define ZMATH_NO_FRACT_LIMIT 8388608.0f
+ZMATHDEF zfix zmath_fix_cos(zfix a)
+{
+    return zmath__fix_sin_phase_k(zmath__fix_phase_k(a) + 0x40000000u);
+}
 
-ZMATHDEF float zmath_floor(float x) 
+// Vectoring CORDIC: rotates (x, y) onto the positive x axis, summing the
+// rotation angles in Q2.30. The left half-plane is first turned by pi, and
+// the inputs are scaled up to about 2^40 so the shifts keep every bit.
+ZMATHDEF zfix zmath_fix_atan2(zfix y, zfix x)
 {
-    if (zmath_abs(x) >= ZMATH_NO_FRACT_LIMIT) 
+    if (x == 0 && y == 0)
     {
-        return x;
+        return 0;
     }
-    int i = (int)x;
-    if (x < 0.0f && x != (float)i) 
+    int64_t vx = x, vy = y, z = 0;
+    if (vx < 0)
     {
-        return (float)(i - 1);
+        z = (vy >= 0) ? 3373259426LL : -3373259426LL;
+        vx = -vx;
+        vy = -vy;
     }
-    return (float)i;
-}
-
-ZMATHDEF float zmath_ceil(float x) 
-{
-    if (zmath_abs(x) >= ZMATH_NO_FRACT_LIMIT) 
+    while ((vx < 0 ? -vx : vx) < ((int64_t)1 << 39) && (vy < 0 ? -vy : vy) < ((int64_t)1 << 39))
     {
-        return x;
+        vx *= 2;
+        vy *= 2;
     }
-    int i = (int)x;
-    if (x > 0.0f && x != (float)i) 
+    for (int i = 0; i < 24; i++)
     {
-        return (float)(i + 1);
+        int64_t sx = vx >> i, sy = vy >> i;
+        if (vy > 0)
+        {
+            vx += sy;
+            vy -= sx;
+            z += zmath__cordic_atan[i];
+        }
+        else
+        {
+            vx -= sy;
+            vy += sx;
+            z -= zmath__cordic_atan[i];
+        }
     }
-    return (float)i;
+    return (zfix)((z + 0x2000) >> 14);
 }
 
-ZMATHDEF float zmath_round(float x) 
+ZMATHDEF zvec2fx zmath_v2fx_add(zvec2fx a, zvec2fx b)
 {
-    return (x >= 0.0f) ? zmath_floor(x + 0.5f) : zmath_ceil(x - 0.5f);
+    zvec2fx r = { zmath_fix_add(a.x, b.x), zmath_fix_add(a.y, b.y) };
+    return r;
 }
 
-ZMATHDEF float zmath_fract(float x) 
+ZMATHDEF zvec2fx zmath_v2fx_sub(zvec2fx a, zvec2fx b)
 {
+    zvec2fx r = { zmath_fix_sub(a.x, b.x), zmath_fix_sub(a.y, b.y) };
+    return r;
+}
 
-    return x - zmath_floor(x); 
+ZMATHDEF zvec2fx zmath_v2fx_scale(zvec2fx v, zfix s)
+{
+    zvec2fx r = { zmath_fix_mul(v.x, s), zmath_fix_mul(v.y, s) };
+    return r;
 }
 
-ZMATHDEF float zmath_fmod(float x, float y) 
-{ 
-    if (zmath_abs(y) < ZMATH_EPSILON) 
-    {
-        return 0.0f;
-    }
-    return x - y * (float)((int)(x / y)); 
+ZMATHDEF zfix zmath_v2fx_dot(zvec2fx a, zvec2fx b)
+{
+    return zmath__fix_sum_k((uint64_t)((int64_t)a.x * b.x) + (uint64_t)((int64_t)a.y * b.y));
 }
 
-ZMATHDEF float zmath_mod(float x, float y) 
-{ 
-    if (zmath_abs(y) < ZMATH_EPSILON)
+ZMATHDEF zfix zmath_v2fx_len(zvec2fx v)
+{
+    uint64_t r = zmath__isqrt64_k(zmath__fix_sq_k(v.x) + zmath__fix_sq_k(v.y));
+    return (zfix)(r > INT32_MAX ? INT32_MAX : r);
+}
+
+// Zero vectors pass through.
+ZMATHDEF zvec2fx zmath_v2fx_norm(zvec2fx v)
+{
+    zfix len = zmath_v2fx_len(v);
+    if (len == 0)
     {
-        return 0.0f;
+        return v;
     }
-    return x - y * zmath_floor(x / y); 
+    zvec2fx r = { zmath_fix_div(v.x, len), zmath_fix_div(v.y, len) };
+    return r;
 }
 
-// Power and roots.
-
-ZMATHDEF float zmath_invsqrt(float x) 
+ZMATHDEF zvec3fx zmath_v3fx_add(zvec3fx a, zvec3fx b)
 {
-    float xhalf = 0.5f * x;
-    uint32_t i = zmath__float_as_uint(x);
-    i = 0x5f3759df - (i >> 1);
-    x = zmath__uint_as_float(i);
-    x = x * (1.5f - xhalf * x * x);
-    return x;
+    zvec3fx r = { zmath_fix_add(a.x, b.x), zmath_fix_add(a.y, b.y), zmath_fix_add(a.z, b.z) };
+    return r;
 }
 
-ZMATHDEF float zmath_sqrt(float x) 
+ZMATHDEF zvec3fx zmath_v3fx_sub(zvec3fx a, zvec3fx b)
 {
-    if (x <= 0.0f) 
-    {
-        return 0.0f;
-    }
-    float guess = x * zmath_invsqrt(x); 
-    return 0.5f * (guess + x / guess);
+    zvec3fx r = { zmath_fix_sub(a.x, b.x), zmath_fix_sub(a.y, b.y), zmath_fix_sub(a.z, b.z) };
+    return r;
 }
 
-ZMATHDEF float zmath_hypot(float x, float y) 
+ZMATHDEF zvec3fx zmath_v3fx_scale(zvec3fx v, zfix s)
 {
-    x = zmath_abs(x);
-    y = zmath_abs(y);
-    float min_val = zmath_min(x, y);
-    float max_val = zmath_max(x, y);
-    if (max_val == 0.0f) 
-    {
-        return 0.0f;
-    }
-    float r = min_val / max_val;
-    return max_val * zmath_sqrt(1.0f + r * r);
+    zvec3fx r = { zmath_fix_mul(v.x, s), zmath_fix_mul(v.y, s), zmath_fix_mul(v.z, s) };
+    return r;
 }
 
-ZMATHDEF float zmath_log(float x) 
+ZMATHDEF zfix zmath_v3fx_dot(zvec3fx a, zvec3fx b)
 {
-    if (x <= 0.0f) 
-    {
-        return -ZMATH_INFINITY;
-    }
-    uint32_t ix = zmath__float_as_uint(x);
-    int exponent = ((int)((ix >> 23) & 0xFF)) - 127;
-    ix = (ix & 0x007FFFFF) | 0x3F800000;
-    float m = zmath__uint_as_float(ix);
-    float z = (m - 1.0f) / (m + 1.0f);
-    float z2 = z * z;
-    float y = z * (2.0f + z2 * (0.66666666f + z2 * (0.4f + z2 * 0.28571428f)));
-    return (float)exponent * ZMATH_LN2 + y;
+    return zmath__fix_sum_k((uint64_t)((int64_t)a.x * b.x) + (uint64_t)((int64_t)a.y * b.y) +
+                            (uint64_t)((int64_t)a.z * b.z));
 }
 
-ZMATHDEF float zmath_log2(float x) 
-{ 
-    return zmath_log(x) * 1.44269504088f; 
+ZMATHDEF zvec3fx zmath_v3fx_cross(zvec3fx a, zvec3fx b)
+{
+    zvec3fx r = {
+        zmath__fix_sum_k((uint64_t)((int64_t)a.y * b.z) - (uint64_t)((int64_t)a.z * b.y)),
+        zmath__fix_sum_k((uint64_t)((int64_t)a.z * b.x) - (uint64_t)((int64_t)a.x * b.z)),
+        zmath__fix_sum_k((uint64_t)((int64_t)a.x * b.y) - (uint64_t)((int64_t)a.y * b.x))
+    };
+    return r;
 }
 
-ZMATHDEF float zmath_exp(float x) 
+ZMATHDEF zfix zmath_v3fx_len(zvec3fx v)
 {
-    float px = x * 1.44269504088f; 
-    float n = zmath_round(px);
-    float r = (px - n) * 0.69314718056f; 
-    float r2 = r * r;
-    float f = 1.0f + r + (r2 * 0.5f) + (r * r2 * 0.16666666f);
-    int int_part = (int)n;
-    uint32_t bits = zmath__float_as_uint(f);
-    bits += (int_part << 23);
-    return zmath__uint_as_float(bits);
+    uint64_t r = zmath__isqrt64_k(zmath__fix_sq_k(v.x) + zmath__fix_sq_k(v.y) + zmath__fix_sq_k(v.z));
+    return (zfix)(r > INT32_MAX ? INT32_MAX : r);
 }
 
-ZMATHDEF float zmath_pow(float x, float y) 
+ZMATHDEF zvec3fx zmath_v3fx_norm(zvec3fx v)
 {
-    if (x <= 0.0f) 
-    {
-        return 0.0f;
-    }
-    if (y == 0.0f) 
+    zfix len = zmath_v3fx_len(v);
+    if (len == 0)
     {
-        return 1.0f;
+        return v;
     }
-    return zmath_exp(y * zmath_log(x));
+    zvec3fx r = { zmath_fix_div(v.x, len), zmath_fix_div(v.y, len), zmath_fix_div(v.z, len) };
+    return r;
 }
 
-// Trigonometry.
-
-#define ZMATH_SIN_C0 -0.1666666664f
-#define ZMATH_SIN_C1  0.0083333315f
-#define ZMATH_SIN_C2 -0.0001984090f
-#define ZMATH_SIN_C3  0.0000027526f
+// Arena.
 
-ZMATHDEF float zmath_sin(float x) 
+ZMATHDEF zarena zmath_arena_init(void* block, size_t size)
 {
-    float q = x * (1.0f / ZMATH_TAU);
-    q = zmath_round(q);
-    x -= q * ZMATH_TAU;
+    zarena a = { (unsigned char*)block, block ? size : 0, 0 };
+    return a;
+}
 
-    if (x > ZMATH_HALF_PI) 
-    {
-        x = ZMATH_PI - x;
-    }
-    else if (x < -ZMATH_HALF_PI) 
+// Aligns the address rather than the offset, so the block itself needs no
+// particular alignment. Sizes are checked against what is left, so a huge
+// request cannot wrap around.
+ZMATHDEF void* zmath_arena_alloc(zarena* a, size_t size, size_t align)
+{
+    uintptr_t at = (uintptr_t)(a->base + a->used);
+    size_t pad = (size_t)((align - (at & (align - 1))) & (align - 1));
+    size_t left = a->size - a->used;
+    if (pad > left || size > left - pad)
     {
-        x = -ZMATH_PI - x;
+        return NULL;
     }
+    void* p = a->base + a->used + pad;
+    a->used += pad + size;
+    return p;
+}
 
-    float x2 = x * x;
-    return x * (1.0f + x2 * (ZMATH_SIN_C0 + x2 * (ZMATH_SIN_C1 + 
-               x2 * (ZMATH_SIN_C2 + x2 * ZMATH_SIN_C3))));
+ZMATHDEF size_t zmath_arena_mark(const zarena* a)
+{
+    return a->used;
 }
 
-ZMATHDEF float zmath_cos(float x)
-{ 
-    return zmath_sin(x + ZMATH_HALF_PI); 
+ZMATHDEF void zmath_arena_reset(zarena* a, size_t mark)
+{
+    a->used = (mark < a->used) ? mark : a->used;
 }
 
-ZMATHDEF float zmath_tan(float x) 
+// n floats rounded up to whole ZMATH_ARENA_ALIGN blocks, or 0 on overflow.
+static inline ZMATH_CONSTEXPR size_t zmath__arena_stream_bytes(size_t n)
 {
-    float c = zmath_cos(x);
-    if (zmath_abs(c) < 1e-5f) 
+    const size_t per = ZMATH_ARENA_ALIGN / sizeof(float);
+    if (n > ((size_t)-1 - per) / sizeof(float))
     {
-        return 0.0f;
+        return 0;
     }
-    return zmath_sin(x) / c;
+    return (n + per - 1) / per * ZMATH_ARENA_ALIGN;
 }
 
-ZMATHDEF float zmath_atan(float x) 
+ZMATHDEF float* zmath_arena_floats(zarena* a, size_t n)
 {
-    float sign = 1.0f;
-    if (x < 0.0f) 
-    { 
-        x = -x; 
-        sign = -1.0f; 
-    }
-    bool complement = (x > 1.0f);
-    if (complement) 
+    size_t bytes = zmath__arena_stream_bytes(n);
+    if (bytes == 0 && n != 0)
     {
-        x = 1.0f / x;
+        return NULL;
     }
-    float x2 = x * x;
-    float y = x * (0.99997726f + x2 * (-0.33262347f + x2 * (0.19354346f + 
-              x2 * (-0.11643287f + x2 * (0.05265332f - x2 * 0.01172120f)))));
-    if (complement) 
+    return (float*)zmath_arena_alloc(a, bytes, ZMATH_ARENA_ALIGN);
+}
+
+ZMATHDEF bool zmath_arena_v3_soa(zarena* a, size_t n, zvec3_soa* out)
+{
+    size_t mark = a->used;
+    float* x = zmath_arena_floats(a, n);
+    float* y = zmath_arena_floats(a, n);
+    float* z = zmath_arena_floats(a, n);
+    if (!x || !y || !z)
     {
-        y = ZMATH_HALF_PI - y;
+        a->used = mark;
+        return false;
     }
-    return sign * y;
+    zvec3_soa v = { x, y, z, n };
+    *out = v;
+    return true;
 }
 
-ZMATHDEF float zmath_atan2(float y, float x) 
+ZMATHDEF zmat3* zmath_arena_m3(zarena* a, size_t n)
 {
-    if (x == 0.0f) 
+    if (n > (size_t)-1 / sizeof(zmat3))
     {
-        return (y > 0.0f) ? ZMATH_HALF_PI : ((y < 0.0f) ? -ZMATH_HALF_PI : 0.0f);
+        return NULL;
     }
-    float res = zmath_atan(y / x);
-    if (x < 0.0f) 
+    return (zmat3*)zmath_arena_alloc(a, n * sizeof(zmat3), ZMATH_ARENA_ALIGN);
+}
+
+ZMATHDEF zmat4* zmath_arena_m4(zarena* a, size_t n)
+{
+    if (n > (size_t)-1 / sizeof(zmat4))
     {
-        res += (y >= 0.0f) ? ZMATH_PI : -ZMATH_PI;
+        return NULL;
     }
-    return res;
+    return (zmat4*)zmath_arena_alloc(a, n * sizeof(zmat4), ZMATH_ARENA_ALIGN);
 }
 
-ZMATHDEF float zmath_asin(float x) 
+ZMATHDEF bool zmath_arena_fft_plan(zarena* a, zfft_plan* plan, size_t n)
 {
-    x = zmath_clamp(x, -1.0f, 1.0f);
-    return zmath_atan(x / zmath_sqrt(1.0f - x * x));
+    size_t mark = a->used;
+    float* table = (n <= (size_t)-1 / 2) ? zmath_arena_floats(a, 2 * n) : NULL;
+    if (!table || !zmath_fft_init(plan, n, table))
+    {
+        a->used = mark;
+        return false;
+    }
+    return true;
 }
 
-ZMATHDEF float zmath_acos(float x) 
-{ 
-    return ZMATH_HALF_PI - zmath_asin(x); 
+ZMATHDEF bool zmath_arena_fft_real_plan(zarena* a, zfft_plan* plan, size_t n)
+{
+    size_t mark = a->used;
+    float* table = (n <= (size_t)-1 / 2) ? zmath_arena_floats(a, 2 * n) : NULL;
+    if (!table || !zmath_fft_real_init(plan, n, table))
+    {
+        a->used = mark;
+        return false;
+    }
+    return true;
 }
 
-ZMATHDEF float zmath_deg2rad(float deg) 
-{ 
-    return deg * (ZMATH_PI / 180.0f); 
-}
+// Parallel dispatch.
+#ifdef ZMATH_PARALLEL
 
-ZMATHDEF float zmath_rad2deg(float rad) 
-{ 
-    return rad * (180.0f / ZMATH_PI); 
-}
+typedef struct
+{
+    zmath_range_fn body;
+    void* ctx;
+    size_t n;
+    size_t chunk;
+} zmath__parallel_job;
 
-// Vector math.
+typedef struct
+{
+    zmath_unary_array_fn unary;
+    zmath_binary_array_fn binary;
+    const float* a;
+    const float* b;
+    float* out;
+    const zmat4* m;
+    const zvec3* points;
+    zvec3* out_points;
+} zmath__parallel_args;
 
-ZMATHDEF zvec2 zmath_v2_add(zvec2 a, zvec2 b) 
-{ 
-    zvec2 r = {a.x+b.x, a.y+b.y}; 
-    return r; 
+static void zmath__parallel_run(void* ctx, size_t job)
+{
+    zmath__parallel_job* j = (zmath__parallel_job*)ctx;
+    size_t begin = job * j->chunk;
+    size_t end = (j->n - begin < j->chunk) ? j->n : begin + j->chunk;
+    j->body(j->ctx, begin, end);
 }
 
-ZMATHDEF zvec2 zmath_v2_sub(zvec2 a, zvec2 b) 
+static void zmath__parallel_unary_range(void* ctx, size_t begin, size_t end)
 {
-    zvec2 r = {a.x-b.x, a.y-b.y}; 
-    return r; 
+    zmath__parallel_args* a = (zmath__parallel_args*)ctx;
+    a->unary(a->a + begin, a->out + begin, end - begin);
 }
 
-ZMATHDEF zvec2 zmath_v2_scale(zvec2 v, float s) 
-{ 
-    zvec2 r = {v.x*s, v.y*s}; 
-    return r; 
+static void zmath__parallel_binary_range(void* ctx, size_t begin, size_t end)
+{
+    zmath__parallel_args* a = (zmath__parallel_args*)ctx;
+    a->binary(a->a + begin, a->b + begin, a->out + begin, end - begin);
 }
 
-ZMATHDEF float zmath_v2_dot(zvec2 a, zvec2 b) 
-{ 
-    return a.x*b.x + a.y*b.y; 
+static void zmath__parallel_points_range(void* ctx, size_t begin, size_t end)
+{
+    zmath__parallel_args* a = (zmath__parallel_args*)ctx;
+    zmath_m4_transform_points(a->m, a->points + begin, a->out_points + begin, end - begin);
 }
 
-ZMATHDEF float zmath_v2_len(zvec2 v) 
-{ 
-    return zmath_sqrt(zmath_v2_dot(v, v)); 
+ZMATHDEF void zmath_parallel_for(const zmath_parallel* p, size_t n, zmath_range_fn body, void* ctx)
+{
+    if (n == 0)
+    {
+        return;
+    }
+    // A multiple of 8 keeps every SIMD tail in the last chunk, as in one call.
+    // Clamping to n first keeps the round-up from wrapping to 0; a chunk of n
+    // is a single job whether rounded or not.
+    size_t chunk = (p->chunk != 0) ? p->chunk : (size_t)ZMATH_PARALLEL_CHUNK;
+    chunk = (chunk < n) ? chunk : n;
+    chunk = (chunk <= SIZE_MAX - 7) ? (chunk + 7) & ~(size_t)7 : chunk;
+    zmath__parallel_job j = { body, ctx, n, chunk };
+    size_t count = n / chunk + (n % chunk != 0);
+    if (p->dispatch == NULL || count == 1)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            zmath__parallel_run(&j, i);
+        }
+        return;
+    }
+    p->dispatch(p->user, zmath__parallel_run, &j, count);
 }
 
-ZMATHDEF zvec2 zmath_v2_norm(zvec2 v) 
-{ 
-    float len = zmath_v2_len(v);
-    return (len > ZMATH_EPSILON) ? zmath_v2_scale(v, 1.0f/len) : v;
+ZMATHDEF void zmath_parallel_unary(const zmath_parallel* p, zmath_unary_array_fn kernel,
+                                   const float* in, float* out, size_t n)
+{
+    zmath__parallel_args a = { kernel, NULL, in, NULL, out, NULL, NULL, NULL };
+    zmath_parallel_for(p, n, zmath__parallel_unary_range, &a);
 }
 
-ZMATHDEF zvec3 zmath_v3_add(zvec3 a, zvec3 b) 
-{ 
-    zvec3 r = {a.x+b.x, a.y+b.y, a.z+b.z}; 
-    return r; 
+ZMATHDEF void zmath_parallel_binary(const zmath_parallel* p, zmath_binary_array_fn kernel,
+                                    const float* a, const float* b, float* out, size_t n)
+{
+    zmath__parallel_args args = { NULL, kernel, a, b, out, NULL, NULL, NULL };
+    zmath_parallel_for(p, n, zmath__parallel_binary_range, &args);
 }
 
-ZMATHDEF zvec3 zmath_v3_sub(zvec3 a, zvec3 b) 
-{ 
-    zvec3 r = {a.x-b.x, a.y-b.y, a.z-b.z}; 
-    return r; 
+ZMATHDEF void zmath_parallel_transform_points(const zmath_parallel* p, const zmat4* m,
+                                              const zvec3* in, zvec3* out, size_t n)
+{
+    zmath__parallel_args a = { NULL, NULL, NULL, NULL, NULL, m, in, out };
+    zmath_parallel_for(p, n, zmath__parallel_points_range, &a);
 }
 
-ZMATHDEF zvec3 zmath_v3_scale(zvec3 v, float s) 
-{ 
-    zvec3 r = {v.x*s, v.y*s, v.z*s}; 
-    return r; 
+#ifndef ZMATH_PARALLEL_NO_POOL
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Workers sleep on `wake` until `generation` moves, then claim job indices under
+// the lock until none are left. The dispatching thread claims jobs as well,
+// then sleeps on `done` until every claimed job has been counted.
+struct zmath_pool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    pthread_t* threads;
+    int workers;
+    int quit;
+    unsigned generation;
+    zmath_job_fn job;
+    void* ctx;
+    size_t count;
+    size_t next;
+    size_t finished;
+};
+
+// Runs jobs until none are left. Called and returns with the lock held.
+static void zmath__pool_drain(zmath_pool* pool)
+{
+    while (pool->next < pool->count)
+    {
+        size_t index = pool->next++;
+        zmath_job_fn job = pool->job;
+        void* ctx = pool->ctx;
+        pthread_mutex_unlock(&pool->lock);
+        job(ctx, index);
+        pthread_mutex_lock(&pool->lock);
+        if (++pool->finished == pool->count)
+        {
+            pthread_cond_signal(&pool->done);
+        }
+    }
 }
 
-ZMATHDEF float zmath_v3_dot(zvec3 a, zvec3 b) 
-{ 
-    return a.x*b.x + a.y*b.y + a.z*b.z; 
+static void* zmath__pool_worker(void* arg)
+{
+    zmath_pool* pool = (zmath_pool*)arg;
+    pthread_mutex_lock(&pool->lock);
+    unsigned seen = pool->generation;
+    for (;;)
+    {
+        while (!pool->quit && pool->generation == seen)
+        {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->quit)
+        {
+            break;
+        }
+        seen = pool->generation;
+        zmath__pool_drain(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
 }
 
-ZMATHDEF zvec3 zmath_v3_cross(zvec3 a, zvec3 b) 
+static void zmath__pool_dispatch(void* user, zmath_job_fn job, void* ctx, size_t count)
 {
-    zvec3 r = { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x };
-    return r;
+    zmath_pool* pool = (zmath_pool*)user;
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->ctx = ctx;
+    pool->count = count;
+    pool->next = 0;
+    pool->finished = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    zmath__pool_drain(pool);
+    while (pool->finished < pool->count)
+    {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
 }
 
-ZMATHDEF float zmath_v3_len(zvec3 v) 
-{ 
-    return zmath_sqrt(zmath_v3_dot(v, v)); 
+ZMATHDEF zmath_pool* zmath_pool_create(int threads)
+{
+    if (threads <= 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (int)cpus : 1;
+    }
+    zmath_pool* pool = (zmath_pool*)calloc(1, sizeof(zmath_pool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    if (threads > 1)
+    {
+        pool->threads = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)(threads - 1));
+    }
+    if (pool->threads != NULL)
+    {
+        for (int i = 0; i < threads - 1; i++)
+        {
+            if (pthread_create(&pool->threads[pool->workers], NULL, zmath__pool_worker, pool) == 0)
+            {
+                pool->workers++;
+            }
+        }
+    }
+    return pool;
 }
 
-ZMATHDEF zvec3 zmath_v3_norm(zvec3 v) 
+ZMATHDEF void zmath_pool_destroy(zmath_pool* pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->workers; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
+
+ZMATHDEF zmath_parallel zmath_pool_parallel(zmath_pool* pool)
 {
-    float len = zmath_v3_len(v);
-    return (len > ZMATH_EPSILON) ? zmath_v3_scale(v, 1.0f/len) : v;
+    zmath_parallel p = { zmath__pool_dispatch, pool, 0 };
+    return p;
 }
 
+#endif // ZMATH_PARALLEL_NO_POOL
+
+#endif // ZMATH_PARALLEL
+
 #endif // ZMATH_IMPLEMENTATION